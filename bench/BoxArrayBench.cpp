@@ -0,0 +1,238 @@
+//
+// A frame's worth of box geometry, from the per-field arrays the renderer keeps
+// now and from the object graph it walked before: one heap object per box whose
+// virtual draw works out its screen position through calculatedXPos/YPos. Both
+// sides emit the same quads into a vertex array; submitting them to the device
+// is left out, so this is the part that runs headless. What the arrays save on
+// the device side, one draw call per run of boxes instead of one or more per
+// box, isn't in these numbers.
+//
+#include <Game/Rendering/BoxColumns.h>
+
+#include <boost/chrono.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	typedef boost::chrono::steady_clock Clock;
+
+	const float g_fBaseWidth = 800.0f, g_fBaseHeight = 600.0f;
+	const int g_iScreenWidth = 1920, g_iScreenHeight = 1080;
+
+	struct Vertex
+	{
+		float x, y, z, rhw;
+		uint32_t color;
+	};
+
+	// What Drawing::QuadBatch does with a box, without the device
+	class Quads
+	{
+	public:
+		void clear()
+		{
+			_vertices.clear();
+		}
+
+		size_t size() const
+		{
+			return _vertices.size() / 4;
+		}
+
+		void addBox(float x, float y, float w, float h, uint32_t color)
+		{
+			Vertex q[4] = {
+				{ x, y, 0, 0, color },
+				{ x + w, y, 0, 0, color },
+				{ x, y + h, 0, 0, color },
+				{ x + w, y + h, 0, 0, color }
+			};
+
+			_vertices.insert(_vertices.end(), q, q + 4);
+		}
+
+		void addRectangular(float x, float y, float w, float h, float thickness, uint32_t color)
+		{
+			addBox(x, y + h - thickness, w, thickness, color);
+			addBox(x, y, thickness, h, color);
+			addBox(x, y, w, thickness, color);
+			addBox(x + w - thickness, y, thickness, h, color);
+		}
+
+	private:
+		std::vector<Vertex> _vertices;
+	};
+
+	// BoxArray with its draw loop going to Quads
+	class HeadlessBoxes : public BoxColumns
+	{
+	public:
+		void draw(size_t first, size_t last, Quads& quads)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				if (!(_flags[i] & Shown))
+					continue;
+
+				quads.addBox(_screenX[i], _screenY[i], _screenWidth[i], _screenHeight[i], _color[i]);
+
+				if (_flags[i] & BorderShown)
+					quads.addRectangular(_screenX[i], _screenY[i], _screenWidth[i], _screenHeight[i], _borderWidth[i], _borderColor[i]);
+			}
+		}
+	};
+
+	// RenderBase and Box as they were drawn one by one
+	class GraphObject
+	{
+	public:
+		virtual ~GraphObject() {}
+		virtual void draw(Quads& quads) = 0;
+
+		static int xCalculator, yCalculator;
+		static int screenWidth, screenHeight;
+
+	protected:
+		int calculatedXPos(int x)
+		{
+			return (int)(((float)x / (float)xCalculator) * (float)screenWidth);
+		}
+
+		int calculatedYPos(int y)
+		{
+			return (int)(((float)y / (float)yCalculator) * (float)screenHeight);
+		}
+	};
+
+	int GraphObject::xCalculator, GraphObject::yCalculator;
+	int GraphObject::screenWidth, GraphObject::screenHeight;
+
+	class GraphBox : public GraphObject
+	{
+	public:
+		GraphBox(int x, int y, uint32_t width, uint32_t height, uint32_t color, uint32_t borderColor, uint32_t borderWidth, bool shown, bool borderShown) :
+			m_iX(x), m_iY(y), m_dwBoxWidth(width), m_dwBoxHeight(height), m_dwBoxColor(color), m_dwBorderColor(borderColor),
+			m_dwBorderWidth(borderWidth), m_bShown(shown), m_bBorderShown(borderShown)
+		{
+		}
+
+		virtual void draw(Quads& quads) override
+		{
+			if (!m_bShown)
+				return;
+
+			float x = (float)calculatedXPos(m_iX);
+			float y = (float)calculatedYPos(m_iY);
+			float w = (float)calculatedXPos(m_dwBoxWidth);
+			float h = (float)calculatedYPos(m_dwBoxHeight);
+
+			quads.addBox(x, y, w, h, m_dwBoxColor);
+
+			if (m_bBorderShown)
+				quads.addRectangular(x, y, w, h, (float)m_dwBorderWidth, m_dwBorderColor);
+		}
+
+	private:
+		int m_iX, m_iY;
+		uint32_t m_dwBoxWidth, m_dwBoxHeight;
+		uint32_t m_dwBoxColor, m_dwBorderColor, m_dwBorderWidth;
+		bool m_bShown, m_bBorderShown;
+	};
+
+	struct Result
+	{
+		double usPerFrame;
+		size_t quads;
+	};
+
+	template<class F>
+	Result measure(int frames, Quads& quads, F frame)
+	{
+		auto start = Clock::now();
+		for (int i = 0; i < frames; i++)
+		{
+			quads.clear();
+			frame();
+		}
+
+		auto elapsed = boost::chrono::duration_cast<boost::chrono::nanoseconds>(Clock::now() - start);
+
+		Result result = { elapsed.count() / 1000.0 / frames, quads.size() };
+		return result;
+	}
+
+	void run(int boxes, int frames)
+	{
+		HeadlessBoxes columns;
+		std::vector<std::unique_ptr<GraphObject>> graph;
+
+		// Same boxes on both sides: most shown, some with a border
+		std::mt19937 rng(1);
+		for (int i = 0; i < boxes; i++)
+		{
+			int x = rng() % 800, y = rng() % 600;
+			uint32_t width = 10 + rng() % 200, height = 10 + rng() % 100, color = rng(), borderColor = rng();
+			bool shown = rng() % 10 < 8, borderShown = rng() % 10 < 3;
+
+			uint8_t flags = (shown ? BoxColumns::Shown : 0) | (borderShown ? BoxColumns::BorderShown : 0);
+			columns.set(columns.append(), x, y, width, height, color, borderColor, 2, flags);
+
+			graph.push_back(std::unique_ptr<GraphObject>(new GraphBox(x, y, width, height, color, borderColor, 2, shown, borderShown)));
+		}
+
+		GraphObject::xCalculator = (int)g_fBaseWidth;
+		GraphObject::yCalculator = (int)g_fBaseHeight;
+		GraphObject::screenWidth = g_iScreenWidth;
+		GraphObject::screenHeight = g_iScreenHeight;
+
+		Quads quads;
+
+		auto resultColumns = measure(frames, quads, [&]()
+		{
+			columns.transform(g_fBaseWidth, g_fBaseHeight, (float)g_iScreenWidth, (float)g_iScreenHeight);
+			columns.draw(0, columns.size(), quads);
+		});
+
+		auto resultTransform = measure(frames, quads, [&]()
+		{
+			columns.transform(g_fBaseWidth, g_fBaseHeight, (float)g_iScreenWidth, (float)g_iScreenHeight);
+		});
+
+		auto resultGraph = measure(frames, quads, [&]()
+		{
+			for (auto& object : graph)
+				object->draw(quads);
+		});
+
+		printf("%7d boxes  columns %9.1f us/frame %5.1f ns/box (transform %5.1f)   objects %9.1f us/frame %5.1f ns/box   %4.1fx  (%zu quads)\n", boxes,
+			resultColumns.usPerFrame, resultColumns.usPerFrame * 1000.0 / boxes, resultTransform.usPerFrame * 1000.0 / boxes,
+			resultGraph.usPerFrame, resultGraph.usPerFrame * 1000.0 / boxes, resultGraph.usPerFrame / resultColumns.usPerFrame, resultColumns.quads);
+
+		if (resultColumns.quads != resultGraph.quads)
+			printf("quad counts differ: %zu / %zu\n", resultColumns.quads, resultGraph.quads);
+	}
+}
+
+// Usage: boxarray-bench [frames]
+int main(int argc, char *argv[])
+{
+	int frames = argc > 1 ? atoi(argv[1]) : 200;
+	if (frames <= 0)
+	{
+		fprintf(stderr, "usage: %s [frames]\n", argv[0]);
+		return 1;
+	}
+
+	printf("transform and emit geometry for every box, %d frames each\n", frames);
+
+	const int counts[] = { 1000, 10000, 100000 };
+	for (auto count : counts)
+		run(count, frames);
+
+	return 0;
+}
@@ -0,0 +1,457 @@
+//
+// Serves the overlay messages from a Dispatcher over the local transport, with
+// a null renderer behind the handlers, and drives it from concurrent clients.
+// Every request waits for its reply, so the latencies are the ones a client of
+// the exports sees: encoding, the socket round trip, dispatch and the handler.
+// With -c it instead opens bursts of short-lived connections that are all open
+// at once, the load of many scripts starting together, and counts the clients
+// that couldn't connect or weren't answered. With -s it drives a server that is
+// already running instead, such as headless-server with the game's full chain.
+//
+#include <Utils/Dispatcher.h>
+#include <Utils/MessageCodec.h>
+#include <Utils/Serializer.h>
+#include <Utils/SlotMap.h>
+#include <Utils/Transport.h>
+
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+	typedef boost::chrono::steady_clock Clock;
+
+	// Stands in for the renderer: the handlers take one lock and touch a table, but nothing is drawn
+	struct NullText
+	{
+		std::string font;
+		std::string text;
+		int x, y;
+		unsigned int color;
+	};
+
+	std::mutex g_renderMutex;
+	SlotMap<NullText> g_texts;
+
+	int TextCreate(std::string font, int, bool, bool, int x, int y, unsigned int color, std::string text, bool, bool)
+	{
+		NullText value = { font, text, x, y, color };
+
+		std::lock_guard<std::mutex> l(g_renderMutex);
+		return g_texts.insert(value);
+	}
+
+	int TextDestroy(int id)
+	{
+		std::lock_guard<std::mutex> l(g_renderMutex);
+		return g_texts.erase(id) ? 1 : 0;
+	}
+
+	int TextSetPos(int id, int x, int y)
+	{
+		std::lock_guard<std::mutex> l(g_renderMutex);
+
+		auto text = g_texts.find(id);
+		if (text == nullptr)
+			return 0;
+
+		text->x = x;
+		text->y = y;
+		return 1;
+	}
+
+	int TextSetColor(int id, unsigned int color)
+	{
+		std::lock_guard<std::mutex> l(g_renderMutex);
+
+		auto text = g_texts.find(id);
+		if (text == nullptr)
+			return 0;
+
+		text->color = color;
+		return 1;
+	}
+
+	int GetFrameRate()
+	{
+		return 60;
+	}
+
+	enum Operation
+	{
+		Create,
+		Setter,
+		Poll,
+		OperationCount
+	};
+
+	const char *g_szOperations[OperationCount] = { "creates", "setters", "polls" };
+
+	struct Options
+	{
+		unsigned int threads;
+		double seconds;
+		unsigned int mix[OperationCount];
+		unsigned int texts;		// live texts per client, a create beyond that destroys the oldest first
+		unsigned int connections;	// per burst, 0 runs the request mix instead
+		const char *szServer;		// running server to drive, null serves the null renderer here
+	};
+
+	struct ClientResult
+	{
+		std::vector<uint32_t> latencies[OperationCount];	// nanoseconds
+		unsigned int failures;
+	};
+
+	template<PipeMessages eMessage, class... Args>
+	bool call(ITransport& transport, typename MessageSchema<eMessage>::Reply& reply, uint32_t& latency, const Args&... args)
+	{
+		auto start = Clock::now();
+
+		Serializer serializerIn;
+		writeRequest<eMessage>(serializerIn, args...);
+
+		Serializer serializerOut;
+		bool bSuccess = transport.transact(serializerIn, serializerOut) && readReply<eMessage>(serializerOut, reply);
+
+		latency = static_cast<uint32_t>(boost::chrono::duration_cast<boost::chrono::nanoseconds>(Clock::now() - start).count());
+		return bSuccess;
+	}
+
+	void client(const std::string& name, const Options& options, unsigned int index, Clock::time_point end, ClientResult& result)
+	{
+		result.failures = 0;
+
+		auto transport = createTransport(name);
+		if (!transport->connect())
+		{
+			result.failures++;
+			return;
+		}
+
+		std::mt19937 rng(index + 1);
+		std::uniform_int_distribution<unsigned int> pick(0, options.mix[Create] + options.mix[Setter] + options.mix[Poll] - 1);
+
+		std::deque<int> texts;
+		uint32_t latency;
+		int reply;
+
+		for (unsigned int i = 0; Clock::now() < end; i++)
+		{
+			auto roll = pick(rng);
+			auto eOperation = roll < options.mix[Create] ? Create : roll < options.mix[Create] + options.mix[Setter] ? Setter : Poll;
+
+			// Setters need something to set
+			if (eOperation == Setter && texts.empty())
+				eOperation = Create;
+
+			bool bSuccess = true;
+			switch (eOperation)
+			{
+			case Create:
+				if (texts.size() >= options.texts)
+				{
+					bSuccess = call<PipeMessages::TextDestroy>(*transport, reply, latency, texts.front()) && reply == 1;
+					result.latencies[Create].push_back(latency);
+					texts.pop_front();
+				}
+
+				if (call<PipeMessages::TextCreate>(*transport, reply, latency, std::string("Arial"), 12, true, false,
+					static_cast<int>(i % 800), static_cast<int>(i % 600), 0xFFFFFFFFu, std::string("Health: 100"), true, true) && reply >= 0)
+				{
+					texts.push_back(reply);
+				}
+				else
+				{
+					bSuccess = false;
+				}
+				break;
+
+			case Setter:
+				if (i & 1)
+					bSuccess = call<PipeMessages::TextSetPos>(*transport, reply, latency, texts[i % texts.size()], static_cast<int>(i % 800), static_cast<int>(i % 600)) && reply == 1;
+				else
+					bSuccess = call<PipeMessages::TextSetColor>(*transport, reply, latency, texts[i % texts.size()], i) && reply == 1;
+				break;
+
+			default:
+				bSuccess = call<PipeMessages::GetFrameRate>(*transport, reply, latency) && reply > 0;
+				break;
+			}
+
+			result.latencies[eOperation].push_back(latency);
+			if (!bSuccess)
+				result.failures++;
+		}
+
+		for (auto id : texts)
+			call<PipeMessages::TextDestroy>(*transport, reply, latency, id);
+
+		transport->disconnect();
+	}
+
+	// Lets a burst's clients go only once all of them are connected
+	class Barrier
+	{
+	public:
+		explicit Barrier(unsigned int count) : m_uiWaiting(count)
+		{
+		}
+
+		void arrive()
+		{
+			std::unique_lock<std::mutex> l(m_mutex);
+
+			if (--m_uiWaiting == 0)
+				m_cv.notify_all();
+			else
+				m_cv.wait(l, [this]() { return m_uiWaiting == 0; });
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		unsigned int m_uiWaiting;
+	};
+
+	// Connects and polls once, latency covers both; stays connected until the whole burst is
+	void shortLived(const std::string& name, Barrier& barrier, uint32_t& latency, bool& bSuccess)
+	{
+		auto start = Clock::now();
+
+		auto transport = createTransport(name);
+		int reply;
+		bSuccess = transport->connect() && call<PipeMessages::GetFrameRate>(*transport, reply, latency) && reply > 0;
+
+		latency = static_cast<uint32_t>(boost::chrono::duration_cast<boost::chrono::nanoseconds>(Clock::now() - start).count());
+
+		barrier.arrive();
+		transport->disconnect();
+	}
+
+	unsigned int burst(const std::string& name, unsigned int connections, std::vector<uint32_t>& latencies)
+	{
+		Barrier barrier(connections);
+
+		std::vector<uint32_t> burstLatencies(connections);
+		std::unique_ptr<bool[]> succeeded(new bool[connections]);
+		std::vector<std::thread> clients;
+
+		for (unsigned int i = 0; i < connections; i++)
+			clients.push_back(std::thread(&shortLived, name, std::ref(barrier), std::ref(burstLatencies[i]), std::ref(succeeded[i])));
+
+		for (auto& thread : clients)
+			thread.join();
+
+		unsigned int failures = 0;
+		for (unsigned int i = 0; i < connections; i++)
+		{
+			if (succeeded[i])
+				latencies.push_back(burstLatencies[i]);
+			else
+				failures++;
+		}
+
+		return failures;
+	}
+
+	// A running server is asked over the transport, like a client of GetServerStats would
+	bool takeServerStats(const std::string& name, const Dispatcher& dispatcher, bool bRemote, LatencyStats::Snapshot& stats)
+	{
+		if (!bRemote)
+		{
+			stats = dispatcher.takeStats();
+			return true;
+		}
+
+		auto transport = createTransport(name);
+		if (!transport->connect())
+			return false;
+
+		std::tuple<int, int, int, int> reply;
+		uint32_t latency;
+		if (!call<PipeMessages::GetServerStats>(*transport, reply, latency))
+			return false;
+
+		stats.p50 = std::get<1>(reply);
+		stats.p99 = std::get<2>(reply);
+		stats.p999 = std::get<3>(reply);
+
+		transport->disconnect();
+		return true;
+	}
+
+	double percentile(const std::vector<uint32_t>& sorted, double fraction)
+	{
+		if (sorted.empty())
+			return 0.0;
+
+		auto index = (std::min)(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+		return sorted[index] / 1000.0;
+	}
+
+	void report(const char *szName, std::vector<uint32_t>& latencies, double seconds)
+	{
+		std::sort(latencies.begin(), latencies.end());
+
+		printf("%-8s %10zu ops %11.0f ops/s   p50 %8.1f us   p99 %8.1f us   p999 %8.1f us\n", szName, latencies.size(),
+			latencies.size() / seconds, percentile(latencies, 0.5), percentile(latencies, 0.99), percentile(latencies, 0.999));
+	}
+
+	bool parseMix(const char *szMix, unsigned int mix[OperationCount])
+	{
+		char *end;
+		for (int i = 0; i < OperationCount; i++)
+		{
+			mix[i] = strtoul(szMix, &end, 10);
+			if (end == szMix || *end != (i + 1 < OperationCount ? ':' : '\0'))
+				return false;
+
+			szMix = end + 1;
+		}
+
+		return mix[Create] + mix[Setter] + mix[Poll] != 0;
+	}
+
+	void usage(const char *szProgram)
+	{
+		fprintf(stderr,
+			"usage: %s [-t threads] [-d seconds] [-m creates:setters:polls] [-n texts] [-c connections] [-s name]\n"
+			"  -t  concurrent clients, one connection each (4)\n"
+			"  -d  run time (5)\n"
+			"  -m  relative weights of the request kinds (1:8:1)\n"
+			"  -n  live texts per client, a create beyond that destroys the oldest first (64)\n"
+			"  -c  open bursts of this many connections at once instead, each polls once and\n"
+			"      stays until all are connected (off)\n"
+			"  -s  drive the server listening under name instead of serving a null renderer here\n", szProgram);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Options options = { 4, 5.0, { 1, 8, 1 }, 64, 0, nullptr };
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool bValid = i + 1 < argc;
+		if (bValid && strcmp(argv[i], "-t") == 0)
+			bValid = (options.threads = atoi(argv[++i])) > 0;
+		else if (bValid && strcmp(argv[i], "-d") == 0)
+			bValid = (options.seconds = atof(argv[++i])) > 0;
+		else if (bValid && strcmp(argv[i], "-m") == 0)
+			bValid = parseMix(argv[++i], options.mix);
+		else if (bValid && strcmp(argv[i], "-n") == 0)
+			bValid = (options.texts = atoi(argv[++i])) > 0;
+		else if (bValid && strcmp(argv[i], "-c") == 0)
+			bValid = (options.connections = atoi(argv[++i])) > 0;
+		else if (bValid && strcmp(argv[i], "-s") == 0)
+			options.szServer = argv[++i];
+		else
+			bValid = false;
+
+		if (!bValid)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	Dispatcher dispatcher;
+	dispatcher.bind<PipeMessages::TextCreate, TextCreate>();
+	dispatcher.bind<PipeMessages::TextDestroy, TextDestroy>();
+	dispatcher.bind<PipeMessages::TextSetPos, TextSetPos>();
+	dispatcher.bind<PipeMessages::TextSetColor, TextSetColor>();
+	dispatcher.bind<PipeMessages::GetFrameRate, GetFrameRate>();
+
+	// Own socket per run, so it can't meet a real overlay or another bench
+	std::string name = options.szServer ? options.szServer : "IndiciumBench-" + std::to_string(getpid());
+
+	std::unique_ptr<IListener> listener;
+	if (!options.szServer)
+		listener = createListener(name, boost::bind(&Dispatcher::dispatch, &dispatcher, _1, _2));
+
+	if (options.connections > 0)
+	{
+		printf("bursts of %u connections, %.1f s\n", options.connections, options.seconds);
+
+		std::vector<uint32_t> latencies;
+		unsigned int bursts = 0, failures = 0;
+
+		auto start = Clock::now();
+		auto end = start + boost::chrono::duration_cast<Clock::duration>(boost::chrono::duration<double>(options.seconds));
+
+		while (Clock::now() < end)
+		{
+			failures += burst(name, options.connections, latencies);
+			bursts++;
+		}
+
+		report("connects", latencies, boost::chrono::duration<double>(Clock::now() - start).count());
+		if (!latencies.empty())
+			printf("slowest  %.1f us\n", latencies.back() / 1000.0);
+		printf("bursts   %u\n", bursts);
+		printf("failures %u\n", failures);
+
+		return failures == 0 ? 0 : 1;
+	}
+
+	printf("%u clients, %.1f s, mix %u:%u:%u (creates:setters:polls), %u texts per client\n", options.threads, options.seconds,
+		options.mix[Create], options.mix[Setter], options.mix[Poll], options.texts);
+
+	std::vector<ClientResult> results(options.threads);
+	std::vector<std::thread> clients;
+
+	LatencyStats::Snapshot server;
+	takeServerStats(name, dispatcher, options.szServer != nullptr, server);
+
+	auto start = Clock::now();
+	auto end = start + boost::chrono::duration_cast<Clock::duration>(boost::chrono::duration<double>(options.seconds));
+
+	for (unsigned int i = 0; i < options.threads; i++)
+		clients.push_back(std::thread(&client, name, std::cref(options), i, end, std::ref(results[i])));
+
+	for (auto& thread : clients)
+		thread.join();
+
+	auto seconds = boost::chrono::duration<double>(Clock::now() - start).count();
+	bool bServerStats = takeServerStats(name, dispatcher, options.szServer != nullptr, server);
+
+	std::vector<uint32_t> all;
+	unsigned int failures = 0;
+
+	for (int i = 0; i < OperationCount; i++)
+	{
+		std::vector<uint32_t> latencies;
+		for (auto& result : results)
+			latencies.insert(latencies.end(), result.latencies[i].begin(), result.latencies[i].end());
+
+		all.insert(all.end(), latencies.begin(), latencies.end());
+		report(g_szOperations[i], latencies, seconds);
+	}
+
+	for (auto& result : results)
+		failures += result.failures;
+
+	report("total", all, seconds);
+	if (bServerStats)
+		printf("server   p50 %u us   p99 %u us   p999 %u us (dispatch only)\n", server.p50, server.p99, server.p999);
+	printf("failures %u\n", failures);
+
+	return failures == 0 ? 0 : 1;
+}
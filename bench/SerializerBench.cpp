@@ -0,0 +1,163 @@
+//
+// Encodes and decodes TextSetPos and TextCreate requests with the binary wire
+// format and with the boost text archives it replaced, the way client and
+// server did before: a fresh archive over a stringstream per message.
+//
+#include <Utils/MessageCodec.h>
+#include <Utils/Serializer.h>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/chrono.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	typedef boost::chrono::steady_clock Clock;
+
+	// Keeps the decoded values alive so the loops aren't optimized away
+	volatile int g_iSink = 0;
+
+	const std::string g_strFont = "Arial";
+	const std::string g_strText = "Health: 100 / Armor: 50";
+
+	struct Result
+	{
+		double nsPerMessage;
+		size_t bytes;
+	};
+
+	template<class F>
+	Result measure(int iterations, F body)
+	{
+		size_t bytes = 0;
+
+		auto start = Clock::now();
+		for (int i = 0; i < iterations; i++)
+			bytes = body(i);
+
+		auto elapsed = boost::chrono::duration_cast<boost::chrono::nanoseconds>(Clock::now() - start);
+
+		Result result = { static_cast<double>(elapsed.count()) / iterations, bytes };
+		return result;
+	}
+
+	size_t binarySetPos(int i)
+	{
+		char buffer[64];
+
+		Serializer serializerOut;
+		serializerOut.setOutputBuffer(buffer, sizeof(buffer));
+		writeRequest<PipeMessages::TextSetPos>(serializerOut, i, i + 1, i + 2);
+
+		Serializer serializerIn(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+		PipeMessages eMessage;
+		int id, x, y;
+		serializerIn >> eMessage >> id >> x >> y;
+		g_iSink += id + x + y;
+
+		return serializerOut.numberOfBytesUsed();
+	}
+
+	size_t textSetPos(int i)
+	{
+		std::stringstream ss;
+		{
+			boost::archive::text_oarchive archive(ss);
+			short eMessage = static_cast<short>(PipeMessages::TextSetPos);
+			int id = i, x = i + 1, y = i + 2;
+			archive << eMessage << id << x << y;
+		}
+
+		std::string str = ss.str();
+		std::stringstream ssIn(str);
+		boost::archive::text_iarchive archive(ssIn);
+
+		short eMessage;
+		int id, x, y;
+		archive >> eMessage >> id >> x >> y;
+		g_iSink += id + x + y;
+
+		return str.size();
+	}
+
+	size_t binaryCreate(int i)
+	{
+		char buffer[256];
+
+		Serializer serializerOut;
+		serializerOut.setOutputBuffer(buffer, sizeof(buffer));
+		writeRequest<PipeMessages::TextCreate>(serializerOut, g_strFont, 12, true, false, i, i, 0xFFFFFFFFu, g_strText, true, true);
+
+		Serializer serializerIn(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+		PipeMessages eMessage;
+		std::string font, text;
+		int fontSize, x, y;
+		bool bold, italic, shadow, show;
+		unsigned int color;
+		serializerIn >> eMessage >> font >> fontSize >> bold >> italic >> x >> y >> color >> text >> shadow >> show;
+		g_iSink += x + static_cast<int>(text.size());
+
+		return serializerOut.numberOfBytesUsed();
+	}
+
+	size_t textCreate(int i)
+	{
+		std::stringstream ss;
+		{
+			boost::archive::text_oarchive archive(ss);
+			short eMessage = static_cast<short>(PipeMessages::TextCreate);
+			int fontSize = 12, x = i, y = i;
+			bool bold = true, italic = false, shadow = true, show = true;
+			unsigned int color = 0xFFFFFFFF;
+			archive << eMessage << g_strFont << fontSize << bold << italic << x << y << color << g_strText << shadow << show;
+		}
+
+		std::string str = ss.str();
+		std::stringstream ssIn(str);
+		boost::archive::text_iarchive archive(ssIn);
+
+		short eMessage;
+		std::string font, text;
+		int fontSize, x, y;
+		bool bold, italic, shadow, show;
+		unsigned int color;
+		archive >> eMessage >> font >> fontSize >> bold >> italic >> x >> y >> color >> text >> shadow >> show;
+		g_iSink += x + static_cast<int>(text.size());
+
+		return str.size();
+	}
+
+	void report(const char *szMessage, int iterations, size_t (*binary)(int), size_t (*text)(int))
+	{
+		auto resultBinary = measure(iterations, binary);
+		auto resultText = measure(iterations, text);
+
+		printf("%-10s  binary %8.1f ns %4zu bytes   text archive %8.1f ns %4zu bytes   %5.1fx\n", szMessage,
+			resultBinary.nsPerMessage, resultBinary.bytes, resultText.nsPerMessage, resultText.bytes,
+			resultText.nsPerMessage / resultBinary.nsPerMessage);
+	}
+}
+
+// Usage: serializer-bench [iterations]
+int main(int argc, char *argv[])
+{
+	int iterations = argc > 1 ? atoi(argv[1]) : 200000;
+	if (iterations <= 0)
+	{
+		fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	printf("encode + decode, %d messages each\n", iterations);
+	report("TextSetPos", iterations, &binarySetPos, &textSetPos);
+	report("TextCreate", iterations, &binaryCreate, &textCreate);
+	return 0;
+}
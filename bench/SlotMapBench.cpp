@@ -0,0 +1,217 @@
+//
+// The renderer's object table under a frame's worth of client traffic, as the
+// SlotMap it is now and as the std::map it replaced: clients destroy and create
+// some objects and look up others for setters, then draw drops what was
+// destroyed and walks every object once. The std::map side does what Renderer
+// did before: add probes for the lowest free id, get takes up to three lookups,
+// remove only marks and draw erases. The probing add makes the std::map side
+// quadratic in the churn, which is why the default run is short.
+//
+#include <Utils/SlotMap.h>
+
+#include <boost/chrono.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+	typedef boost::chrono::steady_clock Clock;
+
+	// Stands in for RenderBase: what the draw loop looks at
+	struct Object
+	{
+		int value;
+		bool markedForDeletion;
+	};
+
+	typedef std::shared_ptr<Object> SharedObject;
+
+	struct Workload
+	{
+		int objects;
+		int frames;
+		int churn;		// destroyed and created again per frame
+		int lookups;	// setters per frame
+	};
+
+	// Keeps the results alive so the loops aren't optimized away
+	volatile long g_lSink = 0;
+
+	class MapTable
+	{
+	public:
+		int add(SharedObject object)
+		{
+			int id = 0;
+
+			if (!_objects.empty())
+				for (;; id++)
+					if (_objects.find(id) == _objects.end())
+						break;
+
+			_objects[id] = object;
+			return id;
+		}
+
+		SharedObject get(int id)
+		{
+			if (_objects.empty())
+				return nullptr;
+
+			if (_objects.find(id) == _objects.end())
+				return nullptr;
+
+			if (_objects[id]->markedForDeletion)
+				return nullptr;
+
+			return _objects[id];
+		}
+
+		bool remove(int id)
+		{
+			auto object = get(id);
+			if (!object)
+				return false;
+
+			return object->markedForDeletion = true;
+		}
+
+		long draw()
+		{
+			long sum = 0;
+			for (auto it = _objects.begin(); it != _objects.end();)
+			{
+				if (it->second->markedForDeletion)
+				{
+					it = _objects.erase(it);
+					continue;
+				}
+
+				sum += it->second->value;
+				++it;
+			}
+
+			return sum;
+		}
+
+	private:
+		std::map<int, SharedObject> _objects;
+	};
+
+	class SlotTable
+	{
+	public:
+		int add(SharedObject object)
+		{
+			return _objects.insert(object);
+		}
+
+		SharedObject get(int id)
+		{
+			auto object = _objects.find(id);
+			if (object == nullptr || (*object)->markedForDeletion)
+				return nullptr;
+
+			return *object;
+		}
+
+		bool remove(int id)
+		{
+			auto object = get(id);
+			if (!object)
+				return false;
+
+			return object->markedForDeletion = true;
+		}
+
+		long draw()
+		{
+			_objects.eraseIf([](const SharedObject& object) { return object->markedForDeletion; });
+
+			long sum = 0;
+			for (auto& object : _objects)
+				sum += object->value;
+
+			return sum;
+		}
+
+	private:
+		SlotMap<SharedObject> _objects;
+	};
+
+	// Microseconds per frame
+	template<class Table>
+	double measure(const Workload& workload)
+	{
+		Table table;
+		std::vector<int> ids;
+
+		for (int i = 0; i < workload.objects; i++)
+			ids.push_back(table.add(std::make_shared<Object>(Object{ i, false })));
+
+		std::mt19937 rng(1);
+		std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+		long sum = 0;
+
+		auto start = Clock::now();
+		for (int frame = 0; frame < workload.frames; frame++)
+		{
+			std::vector<size_t> destroyed;
+			for (int i = 0; i < workload.churn; i++)
+			{
+				auto index = pick(rng);
+				if (table.remove(ids[index]))
+					destroyed.push_back(index);
+			}
+
+			for (int i = 0; i < workload.lookups; i++)
+			{
+				auto object = table.get(ids[pick(rng)]);
+				if (object)
+					object->value++;
+			}
+
+			sum += table.draw();
+
+			for (auto index : destroyed)
+				ids[index] = table.add(std::make_shared<Object>(Object{ frame, false }));
+		}
+
+		auto elapsed = boost::chrono::duration_cast<boost::chrono::nanoseconds>(Clock::now() - start);
+		g_lSink += sum;
+
+		return elapsed.count() / 1000.0 / workload.frames;
+	}
+}
+
+// Usage: slotmap-bench [objects] [frames]
+int main(int argc, char *argv[])
+{
+	Workload workload = { 10000, 100, 100, 1000 };
+
+	if (argc > 1)
+		workload.objects = atoi(argv[1]);
+	if (argc > 2)
+		workload.frames = atoi(argv[2]);
+
+	if (workload.objects <= 0 || workload.frames <= 0)
+	{
+		fprintf(stderr, "usage: %s [objects] [frames]\n", argv[0]);
+		return 1;
+	}
+
+	printf("%d objects, %d frames, per frame %d destroyed and created, %d lookups, one draw\n",
+		workload.objects, workload.frames, workload.churn, workload.lookups);
+
+	auto slotMap = measure<SlotTable>(workload);
+	auto map = measure<MapTable>(workload);
+
+	printf("SlotMap   %8.1f us/frame\n", slotMap);
+	printf("std::map  %8.1f us/frame   %5.1fx\n", map, map / slotMap);
+	return 0;
+}
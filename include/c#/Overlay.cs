@@ -10,64 +10,124 @@ namespace DX9OverlayAPI
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextCreate(string font, int fontSize, bool bBold, bool bItalic, int x, int y, uint color, string text, bool bShadow, bool bShow);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextCreateAt(int id, string font, int fontSize, bool bBold, bool bItalic, int x, int y, uint color, string text, bool bShadow, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextCreateAtNoReply(int id, string font, int fontSize, bool bBold, bool bItalic, int x, int y, uint color, string text, bool bShadow, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextDestroy(int id);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextSetShadow(int id, bool b);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetShadowNoReply(int id, bool b);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextSetShown(int id, bool b);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetShownNoReply(int id, bool b);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextSetColor(int id, uint color);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetColorNoReply(int id, uint color);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextSetPos(int id, int x, int y);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetPosNoReply(int id, int x, int y);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextSetString(int id, string str);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetStringNoReply(int id, string str);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int TextUpdate(int id, string font, int fontSize, bool bBold, bool bItalic);
 
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxCreate(int x, int y, int w, int h, uint dwColor, bool bShow);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxCreateAt(int id, int x, int y, int w, int h, uint dwColor, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxCreateAtNoReply(int id, int x, int y, int w, int h, uint dwColor, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxDestroy(int id);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxSetShown(int id, bool bShown);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetShownNoReply(int id, bool bShown);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxSetBorder(int id, int height, bool bShown);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetBorderNoReply(int id, int height, bool bShown);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxSetBorderColor(int id, uint dwColor);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetBorderColorNoReply(int id, uint dwColor);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxSetColor(int id, uint dwColor);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetColorNoReply(int id, uint dwColor);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxSetHeight(int id, int height);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetHeightNoReply(int id, int height);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxSetPos(int id, int x, int y);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetPosNoReply(int id, int x, int y);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int BoxSetWidth(int id, int width);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetWidthNoReply(int id, int width);
 
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int LineCreate(int x1, int y1, int x2, int y2, int width, uint color, bool bShow);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, uint color, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineCreateAtNoReply(int id, int x1, int y1, int x2, int y2, int width, uint color, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int LineDestroy(int id);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int LineSetShown(int id, bool bShown);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetShownNoReply(int id, bool bShown);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int LineSetColor(int id, uint color);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetColorNoReply(int id, uint color);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int LineSetWidth(int id, int width);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetWidthNoReply(int id, int width);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int LineSetPos(int id, int x1, int y1, int x2, int y2);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetPosNoReply(int id, int x1, int y1, int x2, int y2);
 
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
-        public static extern int ImageCreate(string path, int x, int y, int rotation, int align, bool bShow);
+        public static extern int ImageCreate(string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageCreateAt(int id, string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageCreateAtNoReply(int id, string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int ImageDestroy(int id);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int ImageSetShown(int id, bool bShown);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetShownNoReply(int id, bool bShown);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int ImageSetAlign(int id, int align);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetAlignNoReply(int id, int align);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int ImageSetPos(int id, int x, int y);
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetPosNoReply(int id, int x, int y);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int ImageSetRotation(int id, int rotation);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetRotationNoReply(int id, int rotation);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetScale(int id, float x, float y);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetScaleNoReply(int id, float x, float y);
 
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int DestroyAllVisual();
@@ -80,17 +140,143 @@ namespace DX9OverlayAPI
         public static extern int GetFrameRate();
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int GetScreenSpecs(out int width, out int height);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int GetErrorCount();
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int GetServerStats(out int opsPerSecond, out int p50, out int p99, out int p999);
 
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int SetCalculationRatio(int width, int height);
 
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int SetOverlayPriority(int id, int priority);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int SetOverlayPriorityNoReply(int id, int priority);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ReserveHandles(int count);
 
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern int Init();
         [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
         public static extern void SetParam(string _szParamName, string _szParamValue);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BeginBatch();
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int FlushBatch();
+
+        // Runs on the overlay's reader thread; keep the delegate referenced until it was called
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        public delegate void OverlayCallback(int request, int result, IntPtr context);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextCreateAsync(string font, int fontSize, bool bBold, bool bItalic, int x, int y, uint color, string text, bool bShadow, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextCreateAtAsync(int id, string font, int fontSize, bool bBold, bool bItalic, int x, int y, uint color, string text, bool bShadow, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextDestroyAsync(int id, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetShadowAsync(int id, bool b, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetShownAsync(int id, bool b, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetColorAsync(int id, uint color, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetPosAsync(int id, int x, int y, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextSetStringAsync(int id, string str, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int TextUpdateAsync(int id, string font, int fontSize, bool bBold, bool bItalic, OverlayCallback callback, IntPtr context);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxCreateAsync(int x, int y, int w, int h, uint dwColor, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxCreateAtAsync(int id, int x, int y, int w, int h, uint dwColor, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxDestroyAsync(int id, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetShownAsync(int id, bool bShown, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetBorderAsync(int id, int height, bool bShown, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetBorderColorAsync(int id, uint dwColor, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetColorAsync(int id, uint dwColor, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetHeightAsync(int id, int height, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetPosAsync(int id, int x, int y, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BoxSetWidthAsync(int id, int width, OverlayCallback callback, IntPtr context);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineCreateAsync(int x1, int y1, int x2, int y2, int width, uint color, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineCreateAtAsync(int id, int x1, int y1, int x2, int y2, int width, uint color, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineDestroyAsync(int id, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetShownAsync(int id, bool bShown, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetColorAsync(int id, uint color, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetWidthAsync(int id, int width, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int LineSetPosAsync(int id, int x1, int y1, int x2, int y2, OverlayCallback callback, IntPtr context);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageCreateAsync(string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageCreateAtAsync(int id, string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageDestroyAsync(int id, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetShownAsync(int id, bool bShown, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetAlignAsync(int id, int align, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetPosAsync(int id, int x, int y, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetRotationAsync(int id, int rotation, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ImageSetScaleAsync(int id, float x, float y, OverlayCallback callback, IntPtr context);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int GetFrameRateAsync(OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int SetOverlayPriorityAsync(int id, int priority, OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int GetErrorCountAsync(OverlayCallback callback, IntPtr context);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ReserveHandlesAsync(int count, OverlayCallback callback, IntPtr context);
+
+        [Flags]
+        public enum Features
+        {
+            Batch = 1 << 0,
+            SharedRing = 1 << 1,
+            Subscriptions = 1 << 2,
+            Transactions = 1 << 3,
+            Pipelining = 1 << 4,
+            ReservedHandles = 1 << 5
+        }
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int GetServerCapabilities(out int version, out int maxMessageSize, out int encodings, out Features features);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int BeginTransaction();
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int CommitTransaction();
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int Subscribe(int intervalMs);
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int GetStatus(out int frameRate, out int width, out int height, out int resets);
+
+        [DllImport(PATH, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void Disconnect();
     }
 }
 
@@ -2,37 +2,67 @@
 #define IMPORT extern "C" __declspec(dllimport)
 
 IMPORT int TextCreate(const char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, const char *text, bool bShadow, bool bShow);
+IMPORT int TextCreateAt(int id, const char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, const char *text, bool bShadow, bool bShow);
+IMPORT int TextCreateAtNoReply(int id, const char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, const char *text, bool bShadow, bool bShow);
 IMPORT int TextDestroy(int ID);
 IMPORT int TextSetShadow(int id, bool b);
+IMPORT int TextSetShadowNoReply(int id, bool b);
 IMPORT int TextSetShown(int id, bool b);
+IMPORT int TextSetShownNoReply(int id, bool b);
 IMPORT int TextSetColor(int id, unsigned int color);
+IMPORT int TextSetColorNoReply(int id, unsigned int color);
 IMPORT int TextSetPos(int id, int x, int y);
+IMPORT int TextSetPosNoReply(int id, int x, int y);
 IMPORT int TextSetString(int id, const char *str);
+IMPORT int TextSetStringNoReply(int id, const char *str);
 IMPORT int TextUpdate(int id, const char *Font, int FontSize, bool bBold, bool bItalic);
 
 IMPORT int BoxCreate(int x, int y, int w, int h, unsigned int dwColor, bool bShow);
+IMPORT int BoxCreateAt(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow);
+IMPORT int BoxCreateAtNoReply(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow);
 IMPORT int BoxDestroy(int id);
 IMPORT int BoxSetShown(int id, bool bShown);
+IMPORT int BoxSetShownNoReply(int id, bool bShown);
 IMPORT int BoxSetBorder(int id, int height, bool bShown);
+IMPORT int BoxSetBorderNoReply(int id, int height, bool bShown);
 IMPORT int BoxSetBorderColor(int id, unsigned int dwColor);
+IMPORT int BoxSetBorderColorNoReply(int id, unsigned int dwColor);
 IMPORT int BoxSetColor(int id, unsigned int dwColor);
+IMPORT int BoxSetColorNoReply(int id, unsigned int dwColor);
 IMPORT int BoxSetHeight(int id, int height);
+IMPORT int BoxSetHeightNoReply(int id, int height);
 IMPORT int BoxSetPos(int id, int x, int y);
+IMPORT int BoxSetPosNoReply(int id, int x, int y);
 IMPORT int BoxSetWidth(int id, int width);
+IMPORT int BoxSetWidthNoReply(int id, int width);
 
 IMPORT int LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
+IMPORT int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
+IMPORT int LineCreateAtNoReply(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
 IMPORT int LineDestroy(int id);
 IMPORT int LineSetShown(int id, bool bShown);
+IMPORT int LineSetShownNoReply(int id, bool bShown);
 IMPORT int LineSetColor(int id, unsigned int color);
+IMPORT int LineSetColorNoReply(int id, unsigned int color);
 IMPORT int LineSetWidth(int id, int width);
+IMPORT int LineSetWidthNoReply(int id, int width);
 IMPORT int LineSetPos(int id, int x1, int y1, int x2, int y2);
+IMPORT int LineSetPosNoReply(int id, int x1, int y1, int x2, int y2);
 
-IMPORT int ImageCreate(const char *path, int x, int y, int rotation, int align, bool bShow);
+IMPORT int ImageCreate(const char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
+IMPORT int ImageCreateAt(int id, const char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
+IMPORT int ImageCreateAtNoReply(int id, const char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
 IMPORT int ImageDestroy(int id);
 IMPORT int ImageSetShown(int id, bool bShown);
+IMPORT int ImageSetShownNoReply(int id, bool bShown);
 IMPORT int ImageSetAlign(int id, int align);
+IMPORT int ImageSetAlignNoReply(int id, int align);
 IMPORT int ImageSetPos(int id, int x, int y);
+IMPORT int ImageSetPosNoReply(int id, int x, int y);
 IMPORT int ImageSetRotation(int id, int rotation);
+IMPORT int ImageSetRotationNoReply(int id, int rotation);
+IMPORT int ImageSetScale(int id, float x, float y);
+IMPORT int ImageSetScaleNoReply(int id, float x, float y);
 
 IMPORT int DestroyAllVisual();
 IMPORT int ShowAllVisual();
@@ -40,10 +70,41 @@ IMPORT int HideAllVisual();
 
 IMPORT int GetFrameRate();
 IMPORT int GetScreenSpecs(int& width, int& height);
+IMPORT int GetErrorCount();
+IMPORT int GetServerStats(int& opsPerSecond, int& p50, int& p99, int& p999);
 
 IMPORT int SetCalculationRatio(int width, int height);
 
 IMPORT int SetOverlayPriority(int id, int priority);
+IMPORT int SetOverlayPriorityNoReply(int id, int priority);
+
+IMPORT int ReserveHandles(int count);
 
 IMPORT int  Init();
 IMPORT void SetParam(const char *_szParamName, const char *_szParamValue);
+
+IMPORT int BeginBatch();
+IMPORT int FlushBatch();
+
+// Bits of the features GetServerCapabilities reports
+#define OVERLAY_FEATURE_BATCH				(1 << 0)
+#define OVERLAY_FEATURE_SHARED_RING			(1 << 1)
+#define OVERLAY_FEATURE_SUBSCRIPTIONS		(1 << 2)
+#define OVERLAY_FEATURE_TRANSACTIONS		(1 << 3)
+#define OVERLAY_FEATURE_PIPELINING			(1 << 4)
+#define OVERLAY_FEATURE_RESERVED_HANDLES	(1 << 5)
+
+// Bits of the encodings GetServerCapabilities reports
+#define OVERLAY_ENCODING_BINARY				(1 << 0)
+#define OVERLAY_ENCODING_TEXT_ARCHIVE		(1 << 1)
+
+IMPORT int GetServerCapabilities(int& version, int& maxMessageSize, int& encodings, int& features);
+
+IMPORT int BeginTransaction();
+IMPORT int CommitTransaction();
+
+IMPORT int Subscribe(int intervalMs);
+IMPORT int GetStatus(int& frameRate, int& width, int& height, int& resets);
+
+// Closes the connection to the overlay, call before unloading the library
+IMPORT void Disconnect();
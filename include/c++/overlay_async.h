@@ -0,0 +1,299 @@
+#pragma once
+#include "overlay.h"
+
+#include <functional>
+#include <future>
+#include <memory>
+
+//
+// Asynchronous calls: they return once the request is on its way, with its id
+// (0 if it couldn't be sent, then the callback never runs). The callback gets
+// what the blocking call would have returned, on the overlay's reader thread and
+// in the order the requests were made, so it must not wait for another reply.
+//
+typedef void (__cdecl *OverlayCallback)(int request, int result, void *context);
+
+IMPORT int TextCreateAsync(const char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, const char *text, bool bShadow, bool bShow, OverlayCallback callback, void *context);
+IMPORT int TextCreateAtAsync(int id, const char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, const char *text, bool bShadow, bool bShow, OverlayCallback callback, void *context);
+IMPORT int TextDestroyAsync(int ID, OverlayCallback callback, void *context);
+IMPORT int TextSetShadowAsync(int id, bool b, OverlayCallback callback, void *context);
+IMPORT int TextSetShownAsync(int id, bool b, OverlayCallback callback, void *context);
+IMPORT int TextSetColorAsync(int id, unsigned int color, OverlayCallback callback, void *context);
+IMPORT int TextSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context);
+IMPORT int TextSetStringAsync(int id, const char *str, OverlayCallback callback, void *context);
+IMPORT int TextUpdateAsync(int id, const char *Font, int FontSize, bool bBold, bool bItalic, OverlayCallback callback, void *context);
+
+IMPORT int BoxCreateAsync(int x, int y, int w, int h, unsigned int dwColor, bool bShow, OverlayCallback callback, void *context);
+IMPORT int BoxCreateAtAsync(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow, OverlayCallback callback, void *context);
+IMPORT int BoxDestroyAsync(int id, OverlayCallback callback, void *context);
+IMPORT int BoxSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context);
+IMPORT int BoxSetBorderAsync(int id, int height, bool bShown, OverlayCallback callback, void *context);
+IMPORT int BoxSetBorderColorAsync(int id, unsigned int dwColor, OverlayCallback callback, void *context);
+IMPORT int BoxSetColorAsync(int id, unsigned int dwColor, OverlayCallback callback, void *context);
+IMPORT int BoxSetHeightAsync(int id, int height, OverlayCallback callback, void *context);
+IMPORT int BoxSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context);
+IMPORT int BoxSetWidthAsync(int id, int width, OverlayCallback callback, void *context);
+
+IMPORT int LineCreateAsync(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow, OverlayCallback callback, void *context);
+IMPORT int LineCreateAtAsync(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow, OverlayCallback callback, void *context);
+IMPORT int LineDestroyAsync(int id, OverlayCallback callback, void *context);
+IMPORT int LineSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context);
+IMPORT int LineSetColorAsync(int id, unsigned int color, OverlayCallback callback, void *context);
+IMPORT int LineSetWidthAsync(int id, int width, OverlayCallback callback, void *context);
+IMPORT int LineSetPosAsync(int id, int x1, int y1, int x2, int y2, OverlayCallback callback, void *context);
+
+IMPORT int ImageCreateAsync(const char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, void *context);
+IMPORT int ImageCreateAtAsync(int id, const char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, void *context);
+IMPORT int ImageDestroyAsync(int id, OverlayCallback callback, void *context);
+IMPORT int ImageSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context);
+IMPORT int ImageSetAlignAsync(int id, int align, OverlayCallback callback, void *context);
+IMPORT int ImageSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context);
+IMPORT int ImageSetRotationAsync(int id, int rotation, OverlayCallback callback, void *context);
+IMPORT int ImageSetScaleAsync(int id, float x, float y, OverlayCallback callback, void *context);
+
+IMPORT int GetFrameRateAsync(OverlayCallback callback, void *context);
+IMPORT int SetOverlayPriorityAsync(int id, int priority, OverlayCallback callback, void *context);
+IMPORT int GetErrorCountAsync(OverlayCallback callback, void *context);
+IMPORT int ReserveHandlesAsync(int count, OverlayCallback callback, void *context);
+
+//
+// C++ wrappers: creates and queries return a std::future<int>, everything else
+// takes an optional completion. A future of a request that couldn't be sent is
+// ready right away with what the blocking call returns on failure.
+//
+namespace overlay
+{
+	namespace detail
+	{
+		inline void __cdecl fulfil(int, int result, void *context)
+		{
+			std::unique_ptr<std::promise<int>> promise(static_cast<std::promise<int> *>(context));
+			promise->set_value(result);
+		}
+
+		inline void __cdecl complete(int, int result, void *context)
+		{
+			std::unique_ptr<std::function<void(int)>> done(static_cast<std::function<void(int)> *>(context));
+			if (*done)
+				(*done)(result);
+		}
+
+		template<class Submit>
+		std::future<int> future(int failResult, Submit submit)
+		{
+			auto promise = new std::promise<int>;
+			auto result = promise->get_future();
+
+			// Never completes when it wasn't sent, the promise is still ours
+			if (submit(&fulfil, promise) == 0)
+			{
+				promise->set_value(failResult);
+				delete promise;
+			}
+
+			return result;
+		}
+
+		template<class Submit>
+		int callback(std::function<void(int)> done, Submit submit)
+		{
+			auto context = new std::function<void(int)>(std::move(done));
+
+			auto request = submit(&complete, context);
+			if (request == 0)
+				delete context;
+
+			return request;
+		}
+	}
+
+	inline std::future<int> TextCreate(const char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, const char *text, bool bShadow, bool bShow)
+	{
+		return detail::future(-1, [&](OverlayCallback callback, void *context) { return TextCreateAsync(Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow, callback, context); });
+	}
+
+	inline int TextCreateAt(int id, const char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, const char *text, bool bShadow, bool bShow, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextCreateAtAsync(id, Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow, callback, context); });
+	}
+
+	inline int TextDestroy(int ID, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextDestroyAsync(ID, callback, context); });
+	}
+
+	inline int TextSetShadow(int id, bool b, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextSetShadowAsync(id, b, callback, context); });
+	}
+
+	inline int TextSetShown(int id, bool b, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextSetShownAsync(id, b, callback, context); });
+	}
+
+	inline int TextSetColor(int id, unsigned int color, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextSetColorAsync(id, color, callback, context); });
+	}
+
+	inline int TextSetPos(int id, int x, int y, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextSetPosAsync(id, x, y, callback, context); });
+	}
+
+	inline int TextSetString(int id, const char *str, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextSetStringAsync(id, str, callback, context); });
+	}
+
+	inline int TextUpdate(int id, const char *Font, int FontSize, bool bBold, bool bItalic, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return TextUpdateAsync(id, Font, FontSize, bBold, bItalic, callback, context); });
+	}
+
+	inline std::future<int> BoxCreate(int x, int y, int w, int h, unsigned int dwColor, bool bShow)
+	{
+		return detail::future(-1, [&](OverlayCallback callback, void *context) { return BoxCreateAsync(x, y, w, h, dwColor, bShow, callback, context); });
+	}
+
+	inline int BoxCreateAt(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxCreateAtAsync(id, x, y, w, h, dwColor, bShow, callback, context); });
+	}
+
+	inline int BoxDestroy(int id, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxDestroyAsync(id, callback, context); });
+	}
+
+	inline int BoxSetShown(int id, bool bShown, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxSetShownAsync(id, bShown, callback, context); });
+	}
+
+	inline int BoxSetBorder(int id, int height, bool bShown, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxSetBorderAsync(id, height, bShown, callback, context); });
+	}
+
+	inline int BoxSetBorderColor(int id, unsigned int dwColor, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxSetBorderColorAsync(id, dwColor, callback, context); });
+	}
+
+	inline int BoxSetColor(int id, unsigned int dwColor, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxSetColorAsync(id, dwColor, callback, context); });
+	}
+
+	inline int BoxSetHeight(int id, int height, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxSetHeightAsync(id, height, callback, context); });
+	}
+
+	inline int BoxSetPos(int id, int x, int y, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxSetPosAsync(id, x, y, callback, context); });
+	}
+
+	inline int BoxSetWidth(int id, int width, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return BoxSetWidthAsync(id, width, callback, context); });
+	}
+
+	inline std::future<int> LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow)
+	{
+		return detail::future(-1, [&](OverlayCallback callback, void *context) { return LineCreateAsync(x1, y1, x2, y2, width, color, bShow, callback, context); });
+	}
+
+	inline int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return LineCreateAtAsync(id, x1, y1, x2, y2, width, color, bShow, callback, context); });
+	}
+
+	inline int LineDestroy(int id, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return LineDestroyAsync(id, callback, context); });
+	}
+
+	inline int LineSetShown(int id, bool bShown, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return LineSetShownAsync(id, bShown, callback, context); });
+	}
+
+	inline int LineSetColor(int id, unsigned int color, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return LineSetColorAsync(id, color, callback, context); });
+	}
+
+	inline int LineSetWidth(int id, int width, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return LineSetWidthAsync(id, width, callback, context); });
+	}
+
+	inline int LineSetPos(int id, int x1, int y1, int x2, int y2, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return LineSetPosAsync(id, x1, y1, x2, y2, callback, context); });
+	}
+
+	inline std::future<int> ImageCreate(const char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow)
+	{
+		return detail::future(-1, [&](OverlayCallback callback, void *context) { return ImageCreateAsync(path, x, y, scaleX, scaleY, rotation, align, bShow, callback, context); });
+	}
+
+	inline int ImageCreateAt(int id, const char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return ImageCreateAtAsync(id, path, x, y, scaleX, scaleY, rotation, align, bShow, callback, context); });
+	}
+
+	inline int ImageDestroy(int id, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return ImageDestroyAsync(id, callback, context); });
+	}
+
+	inline int ImageSetShown(int id, bool bShown, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return ImageSetShownAsync(id, bShown, callback, context); });
+	}
+
+	inline int ImageSetAlign(int id, int align, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return ImageSetAlignAsync(id, align, callback, context); });
+	}
+
+	inline int ImageSetPos(int id, int x, int y, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return ImageSetPosAsync(id, x, y, callback, context); });
+	}
+
+	inline int ImageSetRotation(int id, int rotation, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return ImageSetRotationAsync(id, rotation, callback, context); });
+	}
+
+	inline int ImageSetScale(int id, float x, float y, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return ImageSetScaleAsync(id, x, y, callback, context); });
+	}
+
+	inline std::future<int> GetFrameRate()
+	{
+		return detail::future(-1, [&](OverlayCallback callback, void *context) { return GetFrameRateAsync(callback, context); });
+	}
+
+	inline int SetOverlayPriority(int id, int priority, std::function<void(int)> done = nullptr)
+	{
+		return detail::callback(std::move(done), [&](OverlayCallback callback, void *context) { return SetOverlayPriorityAsync(id, priority, callback, context); });
+	}
+
+	inline std::future<int> GetErrorCount()
+	{
+		return detail::future(-1, [&](OverlayCallback callback, void *context) { return GetErrorCountAsync(callback, context); });
+	}
+
+	inline std::future<int> ReserveHandles(int count)
+	{
+		return detail::future(-1, [&](OverlayCallback callback, void *context) { return ReserveHandlesAsync(count, callback, context); });
+	}
+}
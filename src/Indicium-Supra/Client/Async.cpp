@@ -0,0 +1,229 @@
+#include "Async.h"
+
+#include <Utils/Serializer.h>
+#include <Utils/MessageCodec.h>
+#include <Utils/PipeClient.h>
+#include <Shared/PipeMessages.h>
+
+#include <boost/filesystem.hpp>
+
+// failResult is what the callback gets when the connection broke before the reply came
+template<PipeMessages eMessage, class... Args>
+int SubmitAsync(int failResult, OverlayCallback callback, void *context, const Args&... args)
+{
+	// Queued commands go first, so nothing is overtaken
+	BATCH_SEND()
+	SERVER_CHECK(0)
+
+	Serializer serializerIn;
+
+	writeRequest<eMessage>(serializerIn, args...);
+
+	return static_cast<int>(clientTransport().submit(serializerIn, [=](uint32_t request, bool bSuccess, Serializer& serializerOut)
+	{
+		int result = failResult;
+		if (bSuccess && !readReply<eMessage>(serializerOut, result))
+			result = failResult;
+
+		if (callback)
+			callback(static_cast<int>(request), result, context);
+	}));
+}
+
+EXPORT int TextCreateAsync(char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextCreate>(-1, callback, context, Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow);
+}
+
+EXPORT int TextCreateAtAsync(int id, char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextCreateAt>(0, callback, context, id, Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow);
+}
+
+EXPORT int TextDestroyAsync(int Id, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextDestroy>(0, callback, context, Id);
+}
+
+EXPORT int TextSetShadowAsync(int id, bool b, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextSetShadow>(0, callback, context, id, b);
+}
+
+EXPORT int TextSetShownAsync(int id, bool b, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextSetShown>(0, callback, context, id, b);
+}
+
+EXPORT int TextSetColorAsync(int id, unsigned int color, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextSetColor>(0, callback, context, id, color);
+}
+
+EXPORT int TextSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextSetPos>(0, callback, context, id, x, y);
+}
+
+EXPORT int TextSetStringAsync(int id, char *str, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextSetString>(0, callback, context, id, str);
+}
+
+EXPORT int TextUpdateAsync(int id, char *Font, int FontSize, bool bBold, bool bItalic, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::TextUpdate>(0, callback, context, id, Font, FontSize, bBold, bItalic);
+}
+
+EXPORT int BoxCreateAsync(int x, int y, int w, int h, unsigned int dwColor, bool bShow, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxCreate>(-1, callback, context, x, y, w, h, dwColor, bShow);
+}
+
+EXPORT int BoxCreateAtAsync(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxCreateAt>(0, callback, context, id, x, y, w, h, dwColor, bShow);
+}
+
+EXPORT int BoxDestroyAsync(int id, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxDestroy>(0, callback, context, id);
+}
+
+EXPORT int BoxSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxSetShown>(0, callback, context, id, bShown);
+}
+
+EXPORT int BoxSetBorderAsync(int id, int height, bool bShown, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxSetBorder>(0, callback, context, id, height, bShown);
+}
+
+EXPORT int BoxSetBorderColorAsync(int id, unsigned int dwColor, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxSetBorderColor>(0, callback, context, id, dwColor);
+}
+
+EXPORT int BoxSetColorAsync(int id, unsigned int dwColor, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxSetColor>(0, callback, context, id, dwColor);
+}
+
+EXPORT int BoxSetHeightAsync(int id, int height, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxSetHeight>(0, callback, context, id, height);
+}
+
+EXPORT int BoxSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxSetPos>(0, callback, context, id, x, y);
+}
+
+EXPORT int BoxSetWidthAsync(int id, int width, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::BoxSetWidth>(0, callback, context, id, width);
+}
+
+EXPORT int LineCreateAsync(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::LineCreate>(-1, callback, context, x1, y1, x2, y2, width, color, bShow);
+}
+
+EXPORT int LineCreateAtAsync(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::LineCreateAt>(0, callback, context, id, x1, y1, x2, y2, width, color, bShow);
+}
+
+EXPORT int LineDestroyAsync(int id, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::LineDestroy>(0, callback, context, id);
+}
+
+EXPORT int LineSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::LineSetShown>(0, callback, context, id, bShown);
+}
+
+EXPORT int LineSetColorAsync(int id, unsigned int color, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::LineSetColor>(0, callback, context, id, color);
+}
+
+EXPORT int LineSetWidthAsync(int id, int width, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::LineSetWidth>(0, callback, context, id, width);
+}
+
+EXPORT int LineSetPosAsync(int id, int x1, int y1, int x2, int y2, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::LineSetPos>(0, callback, context, id, x1, y1, x2, y2);
+}
+
+EXPORT int ImageCreateAsync(char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, void *context)
+{
+	std::string abs_path = boost::filesystem::absolute(path).string();
+	if (!boost::filesystem::exists(abs_path))
+		return 0;
+
+	return SubmitAsync<PipeMessages::ImageCreate>(-1, callback, context, abs_path, x, y, scaleX, scaleY, rotation, align, bShow);
+}
+
+EXPORT int ImageCreateAtAsync(int id, char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, void *context)
+{
+	std::string abs_path = boost::filesystem::absolute(path).string();
+	if (!boost::filesystem::exists(abs_path))
+		return 0;
+
+	return SubmitAsync<PipeMessages::ImageCreateAt>(0, callback, context, id, abs_path, x, y, scaleX, scaleY, rotation, align, bShow);
+}
+
+EXPORT int ImageDestroyAsync(int id, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::ImageDestroy>(0, callback, context, id);
+}
+
+EXPORT int ImageSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::ImageSetShown>(0, callback, context, id, bShown);
+}
+
+EXPORT int ImageSetAlignAsync(int id, int align, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::ImageSetAlign>(0, callback, context, id, align);
+}
+
+EXPORT int ImageSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::ImageSetPos>(0, callback, context, id, x, y);
+}
+
+EXPORT int ImageSetRotationAsync(int id, int rotation, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::ImageSetRotation>(0, callback, context, id, rotation);
+}
+
+EXPORT int ImageSetScaleAsync(int id, float x, float y, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::ImageSetScale>(0, callback, context, id, x, y);
+}
+
+EXPORT int GetFrameRateAsync(OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::GetFrameRate>(-1, callback, context);
+}
+
+EXPORT int SetOverlayPriorityAsync(int id, int priority, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::SetOverlayPriority>(0, callback, context, id, priority);
+}
+
+EXPORT int GetErrorCountAsync(OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::GetErrorCount>(-1, callback, context);
+}
+
+EXPORT int ReserveHandlesAsync(int count, OverlayCallback callback, void *context)
+{
+	return SubmitAsync<PipeMessages::ReserveHandles>(-1, callback, context, count);
+}
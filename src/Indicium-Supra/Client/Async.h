@@ -0,0 +1,55 @@
+#pragma once
+#include "Client.h"
+
+//
+// Asynchronous counterparts of the exports in Render.h. They return as soon as
+// the request is on its way, with its id (0 if it couldn't be sent, then the
+// callback never runs); the callback gets the id and what the blocking export
+// would have returned. Requests share the connection with the blocking exports
+// and complete in the order they were made, on the client's reader thread, so
+// a callback must not wait for another reply itself.
+//
+typedef void (__cdecl *OverlayCallback)(int request, int result, void *context);
+
+EXPORT int TextCreateAsync(char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow, OverlayCallback callback, void *context);
+EXPORT int TextCreateAtAsync(int id, char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow, OverlayCallback callback, void *context);
+EXPORT int TextDestroyAsync(int Id, OverlayCallback callback, void *context);
+EXPORT int TextSetShadowAsync(int id, bool b, OverlayCallback callback, void *context);
+EXPORT int TextSetShownAsync(int id, bool b, OverlayCallback callback, void *context);
+EXPORT int TextSetColorAsync(int id, unsigned int color, OverlayCallback callback, void *context);
+EXPORT int TextSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context);
+EXPORT int TextSetStringAsync(int id, char *str, OverlayCallback callback, void *context);
+EXPORT int TextUpdateAsync(int id, char *Font, int FontSize, bool bBold, bool bItalic, OverlayCallback callback, void *context);
+
+EXPORT int BoxCreateAsync(int x, int y, int w, int h, unsigned int dwColor, bool bShow, OverlayCallback callback, void *context);
+EXPORT int BoxCreateAtAsync(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow, OverlayCallback callback, void *context);
+EXPORT int BoxDestroyAsync(int id, OverlayCallback callback, void *context);
+EXPORT int BoxSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context);
+EXPORT int BoxSetBorderAsync(int id, int height, bool bShown, OverlayCallback callback, void *context);
+EXPORT int BoxSetBorderColorAsync(int id, unsigned int dwColor, OverlayCallback callback, void *context);
+EXPORT int BoxSetColorAsync(int id, unsigned int dwColor, OverlayCallback callback, void *context);
+EXPORT int BoxSetHeightAsync(int id, int height, OverlayCallback callback, void *context);
+EXPORT int BoxSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context);
+EXPORT int BoxSetWidthAsync(int id, int width, OverlayCallback callback, void *context);
+
+EXPORT int LineCreateAsync(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow, OverlayCallback callback, void *context);
+EXPORT int LineCreateAtAsync(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow, OverlayCallback callback, void *context);
+EXPORT int LineDestroyAsync(int id, OverlayCallback callback, void *context);
+EXPORT int LineSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context);
+EXPORT int LineSetColorAsync(int id, unsigned int color, OverlayCallback callback, void *context);
+EXPORT int LineSetWidthAsync(int id, int width, OverlayCallback callback, void *context);
+EXPORT int LineSetPosAsync(int id, int x1, int y1, int x2, int y2, OverlayCallback callback, void *context);
+
+EXPORT int ImageCreateAsync(char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, void *context);
+EXPORT int ImageCreateAtAsync(int id, char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow, OverlayCallback callback, void *context);
+EXPORT int ImageDestroyAsync(int id, OverlayCallback callback, void *context);
+EXPORT int ImageSetShownAsync(int id, bool bShown, OverlayCallback callback, void *context);
+EXPORT int ImageSetAlignAsync(int id, int align, OverlayCallback callback, void *context);
+EXPORT int ImageSetPosAsync(int id, int x, int y, OverlayCallback callback, void *context);
+EXPORT int ImageSetRotationAsync(int id, int rotation, OverlayCallback callback, void *context);
+EXPORT int ImageSetScaleAsync(int id, float x, float y, OverlayCallback callback, void *context);
+
+EXPORT int GetFrameRateAsync(OverlayCallback callback, void *context);
+EXPORT int SetOverlayPriorityAsync(int id, int priority, OverlayCallback callback, void *context);
+EXPORT int GetErrorCountAsync(OverlayCallback callback, void *context);
+EXPORT int ReserveHandlesAsync(int count, OverlayCallback callback, void *context);
@@ -11,8 +11,16 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/log/trivial.hpp>
+#include <boost/thread/tss.hpp>
 #include <Utils/Serializer.h>
 #include <Utils/PipeClient.h>
+#include <Utils/SharedMemory.h>
+#include <Utils/SharedRing.h>
+#include <Utils/StatusMailbox.h>
+#include <Utils/MessageCodec.h>
+#include <Shared/Config.h>
+
+#include <mutex>
 
 struct stParamInfo
 {
@@ -20,20 +28,402 @@ struct stParamInfo
 	std::string szParamValue;
 };
 
-stParamInfo g_paramArray[3] =
+stParamInfo g_paramArray[4] =
 {
 	"process", "",
 	"window", "",
-	"use_window", "0"
+	"use_window", "0",
+	"use_shared_ring", "0"
+};
+
+struct stBatch
+{
+	Serializer commands;
+	uint32_t count;
+	int succeeded;
+	bool failed;
+};
+
+// Batches are per calling thread, so concurrent callers don't flush each other's commands
+boost::thread_specific_ptr<stBatch> g_batch;
+
+SharedMemory g_ringMemory;
+SharedRing g_ring;
+std::mutex g_ringMutex;
+
+struct stServerInfo
+{
+	uint32_t connection;
+	int version;
+	int maxMessageSize;
+	unsigned int encodings;
+	unsigned int features;
+};
+
+// What the server offered on the current connection, asked again after a reconnect
+stServerInfo g_serverInfo = { 0 };
+std::mutex g_serverInfoMutex;
+
+// Everything this client knows how to use
+const unsigned int g_uiClientFeatures = PipeFeatures::Batch | PipeFeatures::SharedRing | PipeFeatures::Subscriptions |
+	PipeFeatures::Transactions | PipeFeatures::Pipelining | PipeFeatures::ReservedHandles;
+
+struct stTransactions
+{
+	uint32_t connection;
+	int depth;
 };
 
+// Transactions belong to the pipe session, which the whole process shares; the server forgets them when it breaks
+stTransactions g_transactions = { 0 };
+std::mutex g_transactionsMutex;
+
+SharedMemory g_statusMemory;
+StatusMailbox g_status;
+std::mutex g_statusMutex;
+
+std::string GetParam(char *_szParamName);
+
+// PipeMessages::Batch + command count
+#define BATCH_HEADER_SIZE (sizeof(short) + sizeof(uint32_t))
+
+// A batch is applied under the render lock, so it is kept well below MAX_MESSAGE_SIZE
+#define MAX_BATCH_SIZE (64 * 1024)
+
 bool IsServerAvailable()
 {
+	// An open session counts as available, a broken pipe shows up on the next transaction
+	return clientTransport().connect();
+}
+
+bool QueryServerInfo(stServerInfo& info)
+{
+	auto& transport = clientTransport();
+	if (!transport.connect())
+		return false;
+
+	auto connection = transport.connectionId();
+
+	{
+		std::lock_guard<std::mutex> l(g_serverInfoMutex);
+
+		if (connection != 0 && g_serverInfo.connection == connection)
+		{
+			info = g_serverInfo;
+			return true;
+		}
+	}
+
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::Handshake>(serializerIn, PipeProtocolVersion, g_uiClientFeatures);
+
+	if (!PipeClient(serializerIn, serializerOut).success())
+		return false;
+
+	// A server from before the handshake answers with nothing; it is version 0 and left to try everything as before
+	stServerInfo server = { connection, 0, MAX_MESSAGE_SIZE, PipeEncodings::Binary, g_uiClientFeatures };
+
+	std::tuple<int, int, unsigned int, unsigned int> reply;
+	if (readReply<PipeMessages::Handshake>(serializerOut, reply))
+		std::tie(server.version, server.maxMessageSize, server.encodings, server.features) = reply;
+
+	std::lock_guard<std::mutex> l(g_serverInfoMutex);
+
+	g_serverInfo = server;
+	info = server;
+	return true;
+}
+
+bool HasServerFeature(unsigned int feature)
+{
+	// Without an answer the call itself is left to fail, as it did before there was a handshake
+	stServerInfo info;
+	return !QueryServerInfo(info) || (info.features & feature) != 0;
+}
+
+bool IsBatching()
+{
+	return g_batch.get() != nullptr;
+}
+
+void QueueBatch(Serializer& serializerIn)
+{
+	auto batch = g_batch.get();
+	auto size = static_cast<uint32_t>(serializerIn.numberOfBytesUsed());
+
+	if (batch->count > 0 && BATCH_HEADER_SIZE + batch->commands.numberOfBytesUsed() + sizeof(uint32_t) + size > MAX_BATCH_SIZE)
+		SendBatch();
+
+	batch->commands << size;
+	batch->commands.writeBytes(serializerIn.data(), size);
+	batch->count++;
+}
+
+int SendBatch()
+{
+	auto batch = g_batch.get();
+	if (batch == nullptr || batch->count == 0)
+		return 0;
+
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::Ping;
+	serializerIn << PipeMessages::Batch << batch->count;
+	serializerIn.writeBytes(batch->commands.data(), batch->commands.numberOfBytesUsed());
+
+	auto count = batch->count;
+	batch->commands.clear();
+	batch->count = 0;
 
-	return PipeClient(serializerIn, serializerOut).success();
+	if (!IsServerAvailable() && !Init())
+	{
+		batch->failed = true;
+		return -1;
+	}
+
+	if (!PipeClient(serializerIn, serializerOut).success())
+	{
+		batch->failed = true;
+		return -1;
+	}
+
+	std::vector<int> results;
+	serializerOut >> results;
+
+	int succeeded = 0;
+	for (auto result : results)
+	if (result > 0)
+		succeeded++;
+
+	batch->succeeded += succeeded;
+	return succeeded;
+}
+
+bool IsProcessAlive(DWORD dwPId)
+{
+	auto hProcess = OpenProcess(SYNCHRONIZE, FALSE, dwPId);
+	if (hProcess == nullptr)
+		return false;
+
+	bool bAlive = WaitForSingleObject(hProcess, 0) == WAIT_TIMEOUT;
+	CloseHandle(hProcess);
+
+	return bAlive;
+}
+
+int TransactionDepth()
+{
+	auto connection = clientTransport().connectionId();
+
+	std::lock_guard<std::mutex> l(g_transactionsMutex);
+
+	if (g_transactions.connection != connection)
+	{
+		g_transactions.connection = connection;
+		g_transactions.depth = 0;
+	}
+
+	return g_transactions.depth;
+}
+
+bool IsRingAvailable()
+{
+	// The ring bypasses the pipe session, its commands would slip past an open transaction
+	if (TransactionDepth() > 0)
+		return false;
+
+	if (!atoi(GetParam("use_shared_ring").c_str()) || !HasServerFeature(PipeFeatures::SharedRing))
+		return false;
+
+	std::lock_guard<std::mutex> l(g_ringMutex);
+
+	if (!g_ring.isAttached())
+	{
+		if (!g_ringMemory.open(g_strRingName, SharedRing::requiredSize(g_uiRingCapacity)))
+			return false;
+
+		if (!g_ring.attach(g_ringMemory.data(), g_ringMemory.size(), false))
+		{
+			g_ringMemory.close();
+			return false;
+		}
+	}
+
+	// The ring has a single producer; take it over only if its owner went away
+	auto dwPId = GetCurrentProcessId();
+	auto dwOwner = g_ring.producer();
+
+	if (dwOwner == dwPId)
+		return true;
+
+	if (dwOwner != 0 && IsProcessAlive(dwOwner))
+		return false;
+
+	return g_ring.claimProducer(dwPId, dwOwner);
+}
+
+bool QueueRing(Serializer& serializerIn)
+{
+	std::lock_guard<std::mutex> l(g_ringMutex);
+
+	auto size = static_cast<uint32_t>(serializerIn.numberOfBytesUsed());
+
+	// A full ring means the game hasn't presented for a while, give it one client time-out
+	for (int i = 0; i < TIME_OUT; i++)
+	{
+		if (g_ring.push(serializerIn.data(), size))
+			return true;
+
+		Sleep(1);
+	}
+
+	return false;
+}
+
+EXPORT int BeginBatch()
+{
+	if (IsBatching())
+		return 1;
+
+	auto batch = new stBatch;
+	batch->count = 0;
+	batch->succeeded = 0;
+	batch->failed = false;
+
+	g_batch.reset(batch);
+	return 1;
+}
+
+EXPORT int FlushBatch()
+{
+	if (!IsBatching())
+		return 0;
+
+	SendBatch();
+
+	int retn = g_batch->failed ? -1 : g_batch->succeeded;
+	g_batch.reset();
+
+	return retn;
+}
+
+EXPORT int GetServerCapabilities(int& version, int& maxMessageSize, int& encodings, int& features)
+{
+	BATCH_SEND()
+	SERVER_CHECK(0)
+
+	stServerInfo info;
+	if (!QueryServerInfo(info))
+		return 0;
+
+	version = info.version;
+	maxMessageSize = info.maxMessageSize;
+	encodings = static_cast<int>(info.encodings);
+	features = static_cast<int>(info.features);
+	return 1;
+}
+
+EXPORT int BeginTransaction()
+{
+	// Batches aren't held back by the server, so what is queued so far goes out first
+	BATCH_SEND()
+	SERVER_CHECK(0)
+
+	if (!HasServerFeature(PipeFeatures::Transactions))
+		return 0;
+
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::BeginTransaction>(serializerIn);
+
+	int result = 0;
+	if (!PipeClient(serializerIn, serializerOut).success() || !readReply<PipeMessages::BeginTransaction>(serializerOut, result) || !result)
+		return 0;
+
+	// Counted on the connection it was opened on, a reconnect starts from none
+	TransactionDepth();
+
+	std::lock_guard<std::mutex> l(g_transactionsMutex);
+	g_transactions.depth++;
+	return 1;
+}
+
+EXPORT int CommitTransaction()
+{
+	BATCH_SEND()
+	SERVER_CHECK(0)
+
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::CommitTransaction>(serializerIn);
+
+	int result = 0;
+	auto bSent = PipeClient(serializerIn, serializerOut).success() && readReply<PipeMessages::CommitTransaction>(serializerOut, result);
+
+	TransactionDepth();
+
+	{
+		// A commit the server didn't take means it has nothing open for us (anymore), one that got lost is gone with the connection
+		std::lock_guard<std::mutex> l(g_transactionsMutex);
+		g_transactions.depth = (bSent && result) ? max(g_transactions.depth - 1, 0) : 0;
+	}
+
+	return int(bSent && result != 0);
+}
+
+EXPORT int Subscribe(int intervalMs)
+{
+	BATCH_SEND()
+	SERVER_CHECK(0)
+
+	if (!HasServerFeature(PipeFeatures::Subscriptions))
+		return 0;
+
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::Subscribe>(serializerIn, intervalMs);
+
+	int result = 0;
+	if (!PipeClient(serializerIn, serializerOut).success() || !readReply<PipeMessages::Subscribe>(serializerOut, result) || !result)
+		return 0;
+
+	std::lock_guard<std::mutex> l(g_statusMutex);
+
+	if (g_status.isAttached())
+		return 1;
+
+	if (!g_statusMemory.open(g_strStatusName, StatusMailbox::requiredSize()))
+		return 0;
+
+	if (!g_status.attach(g_statusMemory.data(), g_statusMemory.size(), false))
+	{
+		g_statusMemory.close();
+		return 0;
+	}
+
+	return 1;
+}
+
+EXPORT int GetStatus(int& frameRate, int& width, int& height, int& resets)
+{
+	std::lock_guard<std::mutex> l(g_statusMutex);
+
+	// Reads shared memory only, no round trip to the game
+	StatusMailbox::Status status;
+	if (!g_status.isAttached() || !g_status.read(status) || status.updates == 0)
+		return 0;
+
+	frameRate = status.frameRate;
+	width = status.width;
+	height = status.height;
+	resets = static_cast<int>(status.resets);
+	return 1;
+}
+
+EXPORT void Disconnect()
+{
+	// Waits for the transport's threads, which DllMain can't do once the library is being unloaded
+	clientTransport().disconnect();
 }
 
 EXPORT void SetParam(char *_szParamName, char *_szParamValue)
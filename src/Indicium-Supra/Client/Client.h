@@ -11,7 +11,47 @@ if (!IsServerAvailable())	\
 		Sleep(250);			\
 }							\
 
+#define BATCH_QUEUE(serializer, retn)	\
+if (IsBatching())						\
+{										\
+	QueueBatch(serializer);				\
+	return retn;						\
+}										\
+
+#define BATCH_SEND()	\
+if (IsBatching())		\
+	SendBatch();		\
+
+// Only for the *NoReply setters: nobody reads their result, so the ring can't change what a call returns
+#define RING_QUEUE(serializer, retn, failn)		\
+if (IsRingAvailable())							\
+	return QueueRing(serializer) ? retn : failn;	\
+
+class Serializer;
+
 bool IsServerAvailable();
+// Whether the server offered one of PipeFeatures, also true when it can't be asked
+bool HasServerFeature(unsigned int feature);
+
+bool IsBatching();
+void QueueBatch(Serializer& serializerIn);
+int  SendBatch();
+
+bool IsRingAvailable();
+bool QueueRing(Serializer& serializerIn);
 
 EXPORT int  Init();
-EXPORT void	SetParam(char *_szParamName, char *_szParamValue);
\ No newline at end of file
+EXPORT void	SetParam(char *_szParamName, char *_szParamValue);
+
+EXPORT int	BeginBatch();
+EXPORT int	FlushBatch();
+
+EXPORT int	GetServerCapabilities(int& version, int& maxMessageSize, int& encodings, int& features);
+
+EXPORT int	BeginTransaction();
+EXPORT int	CommitTransaction();
+
+EXPORT int	Subscribe(int intervalMs);
+EXPORT int	GetStatus(int& frameRate, int& width, int& height, int& resets);
+
+EXPORT void	Disconnect();
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Render.h"
 
 #include <Utils/Serializer.h>
+#include <Utils/MessageCodec.h>
 #include <Utils/PipeClient.h>
 #include <Utils/Windows.h>
 #include <Shared/PipeMessages.h>
@@ -11,12 +12,12 @@
 
 EXPORT int TextCreate(char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow)
 {
+	BATCH_SEND()
 	SERVER_CHECK(-1)
 
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextCreate << std::string(Font) << FontSize << bBold << bItalic << x << y << color << std::string(text);
-	serializerIn << bShadow << bShow;
+	writeRequest<PipeMessages::TextCreate>(serializerIn, Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow);
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -24,13 +25,46 @@ EXPORT int TextCreate(char *Font, int FontSize, bool bBold, bool bItalic, int x,
 	return -1;
 }
 
-EXPORT int TextDestroy(int Id)
+EXPORT int TextCreateAt(int id, char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow)
 {
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::TextCreateAt>(serializerIn, id, Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
 	SERVER_CHECK(0)
 
+	if (PipeClient(serializerIn, serializerOut).success())
+		SERIALIZER_RET(int);
+
+	return 0;
+}
+
+EXPORT int TextCreateAtNoReply(int id, char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow)
+{
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::TextCreateAt>(serializerIn, id, Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
+
+	// Setters that follow may go through the ring, which must not overtake the create
+	if (IsRingAvailable())
+		return TextCreateAt(id, Font, FontSize, bBold, bItalic, x, y, color, text, bShadow, bShow);
+
+	SERVER_CHECK(0)
+
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int TextDestroy(int Id)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextDestroy << Id;
+	writeRequest<PipeMessages::TextDestroy>(serializerIn, Id);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -40,11 +74,12 @@ EXPORT int TextDestroy(int Id)
 
 EXPORT int TextSetShadow(int id, bool b)
 {
-	SERVER_CHECK(0)
-
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextSetShadow << id << b;
+	writeRequest<PipeMessages::TextSetShadow>(serializerIn, id, b);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -52,13 +87,27 @@ EXPORT int TextSetShadow(int id, bool b)
 	return 0;
 }
 
-EXPORT int TextSetShown(int id, bool b)
+EXPORT int TextSetShadowNoReply(int id, bool b)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::TextSetShadow>(serializerIn, id, b);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int TextSetShown(int id, bool b)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextSetShown << id << b;
+	writeRequest<PipeMessages::TextSetShown>(serializerIn, id, b);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -66,13 +115,27 @@ EXPORT int TextSetShown(int id, bool b)
 	return 0;
 }
 
-EXPORT int TextSetColor(int id, unsigned int color)
+EXPORT int TextSetShownNoReply(int id, bool b)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::TextSetShown>(serializerIn, id, b);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int TextSetColor(int id, unsigned int color)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextSetColor << id << color;
+	writeRequest<PipeMessages::TextSetColor>(serializerIn, id, color);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -80,13 +143,27 @@ EXPORT int TextSetColor(int id, unsigned int color)
 	return 0;
 }
 
-EXPORT int TextSetPos(int id, int x, int y)
+EXPORT int TextSetColorNoReply(int id, unsigned int color)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::TextSetColor>(serializerIn, id, color);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int TextSetPos(int id, int x, int y)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextSetPos << id << x << y;
+	writeRequest<PipeMessages::TextSetPos>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -94,13 +171,27 @@ EXPORT int TextSetPos(int id, int x, int y)
 	return 0;
 }
 
-EXPORT int TextSetString(int id, char *str)
+EXPORT int TextSetPosNoReply(int id, int x, int y)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::TextSetPos>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int TextSetString(int id, char *str)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextSetString << id << std::string(str);
+	writeRequest<PipeMessages::TextSetString>(serializerIn, id, str);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -108,13 +199,27 @@ EXPORT int TextSetString(int id, char *str)
 	return 0;
 }
 
-EXPORT int TextUpdate(int id, char *Font, int FontSize, bool bBold, bool bItalic)
+EXPORT int TextSetStringNoReply(int id, char *str)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::TextSetString>(serializerIn, id, str);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int TextUpdate(int id, char *Font, int FontSize, bool bBold, bool bItalic)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::TextUpdate << id << std::string(Font) << FontSize << bBold << bItalic;
+	writeRequest<PipeMessages::TextUpdate>(serializerIn, id, Font, FontSize, bBold, bItalic);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -124,11 +229,12 @@ EXPORT int TextUpdate(int id, char *Font, int FontSize, bool bBold, bool bItalic
 
 EXPORT int BoxCreate(int x, int y, int w, int h, unsigned int dwColor, bool bShow)
 {
+	BATCH_SEND()
 	SERVER_CHECK(-1)
 
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxCreate << x << y << w << h << dwColor << bShow;
+	writeRequest<PipeMessages::BoxCreate>(serializerIn, x, y, w, h, dwColor, bShow);
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -136,13 +242,46 @@ EXPORT int BoxCreate(int x, int y, int w, int h, unsigned int dwColor, bool bSho
 	return -1;
 }
 
-EXPORT int BoxDestroy(int id)
+EXPORT int BoxCreateAt(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow)
+{
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::BoxCreateAt>(serializerIn, id, x, y, w, h, dwColor, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
+
+	if (PipeClient(serializerIn, serializerOut).success())
+		SERIALIZER_RET(int);
+
+	return 0;
+}
+
+EXPORT int BoxCreateAtNoReply(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxCreateAt>(serializerIn, id, x, y, w, h, dwColor, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
+
+	// Setters that follow may go through the ring, which must not overtake the create
+	if (IsRingAvailable())
+		return BoxCreateAt(id, x, y, w, h, dwColor, bShow);
+
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int BoxDestroy(int id)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxDestroy << id;
+	writeRequest<PipeMessages::BoxDestroy>(serializerIn, id);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -152,11 +291,12 @@ EXPORT int BoxDestroy(int id)
 
 EXPORT int BoxSetShown(int id, bool bShown)
 {
-	SERVER_CHECK(0)
-
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxSetShown << id << bShown;
+	writeRequest<PipeMessages::BoxSetShown>(serializerIn, id, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -164,13 +304,27 @@ EXPORT int BoxSetShown(int id, bool bShown)
 	return 0;
 }
 
-EXPORT int BoxSetBorder(int id, int height, bool bShown)
+EXPORT int BoxSetShownNoReply(int id, bool bShown)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxSetShown>(serializerIn, id, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int BoxSetBorder(int id, int height, bool bShown)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxSetBorder << id << height << bShown;
+	writeRequest<PipeMessages::BoxSetBorder>(serializerIn, id, height, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -178,13 +332,27 @@ EXPORT int BoxSetBorder(int id, int height, bool bShown)
 	return 0;
 }
 
-EXPORT int BoxSetBorderColor(int id, unsigned int dwColor)
+EXPORT int BoxSetBorderNoReply(int id, int height, bool bShown)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxSetBorder>(serializerIn, id, height, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int BoxSetBorderColor(int id, unsigned int dwColor)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxSetBorderColor << id << dwColor;
+	writeRequest<PipeMessages::BoxSetBorderColor>(serializerIn, id, dwColor);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -192,13 +360,27 @@ EXPORT int BoxSetBorderColor(int id, unsigned int dwColor)
 	return 0;
 }
 
-EXPORT int BoxSetColor(int id, unsigned int dwColor)
+EXPORT int BoxSetBorderColorNoReply(int id, unsigned int dwColor)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxSetBorderColor>(serializerIn, id, dwColor);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int BoxSetColor(int id, unsigned int dwColor)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxSetColor << id << dwColor;
+	writeRequest<PipeMessages::BoxSetColor>(serializerIn, id, dwColor);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -206,13 +388,27 @@ EXPORT int BoxSetColor(int id, unsigned int dwColor)
 	return 0;
 }
 
-EXPORT int BoxSetHeight(int id, int height)
+EXPORT int BoxSetColorNoReply(int id, unsigned int dwColor)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxSetColor>(serializerIn, id, dwColor);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int BoxSetHeight(int id, int height)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxSetHeight << id << height;
+	writeRequest<PipeMessages::BoxSetHeight>(serializerIn, id, height);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -220,13 +416,27 @@ EXPORT int BoxSetHeight(int id, int height)
 	return 0;
 }
 
-EXPORT int BoxSetPos(int id, int x, int y)
+EXPORT int BoxSetHeightNoReply(int id, int height)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxSetHeight>(serializerIn, id, height);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int BoxSetPos(int id, int x, int y)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxSetPos << id << x << y;
+	writeRequest<PipeMessages::BoxSetPos>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -234,13 +444,27 @@ EXPORT int BoxSetPos(int id, int x, int y)
 	return 0;
 }
 
-EXPORT int BoxSetWidth(int id, int width)
+EXPORT int BoxSetPosNoReply(int id, int x, int y)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxSetPos>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int BoxSetWidth(int id, int width)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::BoxSetWidth << id << width;
+	writeRequest<PipeMessages::BoxSetWidth>(serializerIn, id, width);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -248,13 +472,27 @@ EXPORT int BoxSetWidth(int id, int width)
 	return 0;
 }
 
+EXPORT int BoxSetWidthNoReply(int id, int width)
+{
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::BoxSetWidth>(serializerIn, id, width);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
+	SERVER_CHECK(0)
+
+	return (int)PipeClient(serializerIn).success();
+}
+
 EXPORT int LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow)
 {
+	BATCH_SEND()
 	SERVER_CHECK(-1)
 
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::LineCreate << x1 << y1 << x2 << y2 << width << color << bShow;
+	writeRequest<PipeMessages::LineCreate>(serializerIn, x1, y1, x2, y2, width, color, bShow);
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -262,13 +500,46 @@ EXPORT int LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int co
 	return -1;
 }
 
-EXPORT int LineDestroy(int id)
+EXPORT int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow)
+{
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::LineCreateAt>(serializerIn, id, x1, y1, x2, y2, width, color, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
+
+	if (PipeClient(serializerIn, serializerOut).success())
+		SERIALIZER_RET(int);
+
+	return 0;
+}
+
+EXPORT int LineCreateAtNoReply(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::LineCreateAt>(serializerIn, id, x1, y1, x2, y2, width, color, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
+
+	// Setters that follow may go through the ring, which must not overtake the create
+	if (IsRingAvailable())
+		return LineCreateAt(id, x1, y1, x2, y2, width, color, bShow);
+
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int LineDestroy(int id)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::LineDestroy << id;
+	writeRequest<PipeMessages::LineDestroy>(serializerIn, id);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -278,11 +549,12 @@ EXPORT int LineDestroy(int id)
 
 EXPORT int LineSetShown(int id, bool bShown)
 {
-	SERVER_CHECK(0)
-
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::LineSetShown << id << bShown;
+	writeRequest<PipeMessages::LineSetShown>(serializerIn, id, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -290,13 +562,27 @@ EXPORT int LineSetShown(int id, bool bShown)
 	return 0;
 }
 
-EXPORT int LineSetColor(int id, unsigned int color)
+EXPORT int LineSetShownNoReply(int id, bool bShown)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::LineSetShown>(serializerIn, id, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int LineSetColor(int id, unsigned int color)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::LineSetColor << id << color;
+	writeRequest<PipeMessages::LineSetColor>(serializerIn, id, color);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -304,13 +590,27 @@ EXPORT int LineSetColor(int id, unsigned int color)
 	return 0;
 }
 
-EXPORT int LineSetWidth(int id, int width)
+EXPORT int LineSetColorNoReply(int id, unsigned int color)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::LineSetColor>(serializerIn, id, color);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int LineSetWidth(int id, int width)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::LineSetWidth << id << width;
+	writeRequest<PipeMessages::LineSetWidth>(serializerIn, id, width);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -318,13 +618,27 @@ EXPORT int LineSetWidth(int id, int width)
 	return 0;
 }
 
-EXPORT int LineSetPos(int id, int x1, int y1, int x2, int y2)
+EXPORT int LineSetWidthNoReply(int id, int width)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::LineSetWidth>(serializerIn, id, width);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int LineSetPos(int id, int x1, int y1, int x2, int y2)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::LineSetPos << id << x1 << y1 << x2 << y2;
+	writeRequest<PipeMessages::LineSetPos>(serializerIn, id, x1, y1, x2, y2);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -332,8 +646,22 @@ EXPORT int LineSetPos(int id, int x1, int y1, int x2, int y2)
 	return 0;
 }
 
+EXPORT int LineSetPosNoReply(int id, int x1, int y1, int x2, int y2)
+{
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::LineSetPos>(serializerIn, id, x1, y1, x2, y2);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
+	SERVER_CHECK(0)
+
+	return (int)PipeClient(serializerIn).success();
+}
+
 EXPORT int ImageCreate(char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow)
 {
+	BATCH_SEND()
 	SERVER_CHECK(-1)
 
 	Serializer serializerIn, serializerOut;
@@ -342,7 +670,7 @@ EXPORT int ImageCreate(char *path, int x, int y, float scaleX, float scaleY, int
 	if (!boost::filesystem::exists(abs_path))
 		return -2;
 
-	serializerIn << PipeMessages::ImageCreate << abs_path << x << y << scaleX << scaleY << rotation << align << bShow;
+	writeRequest<PipeMessages::ImageCreate>(serializerIn, abs_path, x, y, scaleX, scaleY, rotation, align, bShow);
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -350,13 +678,54 @@ EXPORT int ImageCreate(char *path, int x, int y, float scaleX, float scaleY, int
 	return -1;
 }
 
-EXPORT int ImageDestroy(int id)
+EXPORT int ImageCreateAt(int id, char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow)
 {
+	Serializer serializerIn, serializerOut;
+
+	std::string abs_path = boost::filesystem::absolute(path).string();
+	if (!boost::filesystem::exists(abs_path))
+		return -2;
+
+	writeRequest<PipeMessages::ImageCreateAt>(serializerIn, id, abs_path, x, y, scaleX, scaleY, rotation, align, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
+
+	if (PipeClient(serializerIn, serializerOut).success())
+		SERIALIZER_RET(int);
+
+	return 0;
+}
+
+EXPORT int ImageCreateAtNoReply(int id, char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow)
+{
+	Serializer serializerIn;
+
+	std::string abs_path = boost::filesystem::absolute(path).string();
+	if (!boost::filesystem::exists(abs_path))
+		return -2;
+
+	writeRequestNoReply<PipeMessages::ImageCreateAt>(serializerIn, id, abs_path, x, y, scaleX, scaleY, rotation, align, bShow);
+
+	BATCH_QUEUE(serializerIn, 1)
+
+	// Setters that follow may go through the ring, which must not overtake the create
+	if (IsRingAvailable())
+		return ImageCreateAt(id, path, x, y, scaleX, scaleY, rotation, align, bShow);
+
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int ImageDestroy(int id)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::ImageDestroy << id;
+	writeRequest<PipeMessages::ImageDestroy>(serializerIn, id);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -366,11 +735,12 @@ EXPORT int ImageDestroy(int id)
 
 EXPORT int ImageSetShown(int id, bool bShown)
 {
-	SERVER_CHECK(0)
-
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::ImageSetShown << id << bShown;
+	writeRequest<PipeMessages::ImageSetShown>(serializerIn, id, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -378,13 +748,27 @@ EXPORT int ImageSetShown(int id, bool bShown)
 	return 0;
 }
 
-EXPORT int ImageSetAlign(int id, int align)
+EXPORT int ImageSetShownNoReply(int id, bool bShown)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::ImageSetShown>(serializerIn, id, bShown);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int ImageSetAlign(int id, int align)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::ImageSetAlign << id << align;
+	writeRequest<PipeMessages::ImageSetAlign>(serializerIn, id, align);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -392,13 +776,27 @@ EXPORT int ImageSetAlign(int id, int align)
 	return 0;
 }
 
-EXPORT int ImageSetPos(int id, int x, int y)
+EXPORT int ImageSetAlignNoReply(int id, int align)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::ImageSetAlign>(serializerIn, id, align);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int ImageSetPos(int id, int x, int y)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::ImageSetPos << id << x << y;
+	writeRequest<PipeMessages::ImageSetPos>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -406,13 +804,27 @@ EXPORT int ImageSetPos(int id, int x, int y)
 	return 0;
 }
 
-EXPORT int ImageSetRotation(int id, int rotation)
+EXPORT int ImageSetPosNoReply(int id, int x, int y)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::ImageSetPos>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int ImageSetRotation(int id, int rotation)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::ImageSetRotation << id << rotation;
+	writeRequest<PipeMessages::ImageSetRotation>(serializerIn, id, rotation);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -420,13 +832,27 @@ EXPORT int ImageSetRotation(int id, int rotation)
 	return 0;
 }
 
-EXPORT int ImageSetScale(int id, float x, float y)
+EXPORT int ImageSetRotationNoReply(int id, int rotation)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::ImageSetRotation>(serializerIn, id, rotation);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int ImageSetScale(int id, float x, float y)
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::ImageSetScale << id << x << y;
+	writeRequest<PipeMessages::ImageSetScale>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -434,13 +860,27 @@ EXPORT int ImageSetScale(int id, float x, float y)
 	return 0;
 }
 
-EXPORT int DestroyAllVisual()
+EXPORT int ImageSetScaleNoReply(int id, float x, float y)
 {
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::ImageSetScale>(serializerIn, id, x, y);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int DestroyAllVisual()
+{
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::DestroyAllVisual;
+	writeRequest<PipeMessages::DestroyAllVisual>(serializerIn);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		return 1;
@@ -450,11 +890,12 @@ EXPORT int DestroyAllVisual()
 
 EXPORT int ShowAllVisual()
 {
-	SERVER_CHECK(0)
-
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::ShowAllVisual;
+	writeRequest<PipeMessages::ShowAllVisual>(serializerIn);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		return 1;
@@ -464,11 +905,12 @@ EXPORT int ShowAllVisual()
 
 EXPORT int HideAllVisual()
 {
-	SERVER_CHECK(0)
-
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::HideAllVisual;
+	writeRequest<PipeMessages::HideAllVisual>(serializerIn);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		return 1;
@@ -478,11 +920,12 @@ EXPORT int HideAllVisual()
 
 EXPORT int GetFrameRate()
 {
+	BATCH_SEND()
 	SERVER_CHECK(-1)
 
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::GetFrameRate;
+	writeRequest<PipeMessages::GetFrameRate>(serializerIn);
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
@@ -492,15 +935,20 @@ EXPORT int GetFrameRate()
 
 EXPORT int GetScreenSpecs(int& width, int& height)
 {
+	BATCH_SEND()
 	SERVER_CHECK(0)
 
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::GetScreenSpecs;
+	writeRequest<PipeMessages::GetScreenSpecs>(serializerIn);
 
 	if (PipeClient(serializerIn, serializerOut).success())
 	{
-		serializerOut >> width >> height;
+		std::tuple<int, int> specs;
+		if (!readReply<PipeMessages::GetScreenSpecs>(serializerOut, specs))
+			return 0;
+
+		std::tie(width, height) = specs;
 		return 1;
 	}
 
@@ -509,27 +957,92 @@ EXPORT int GetScreenSpecs(int& width, int& height)
 
 EXPORT int SetCalculationRatio(int width, int height)
 {
-	SERVER_CHECK(0)
-
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::SetCalculationRatio << width << height;
+	writeRequest<PipeMessages::SetCalculationRatio>(serializerIn, width, height);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
 
 	return (int)PipeClient(serializerIn, serializerOut).success();
 }
 
 EXPORT int SetOverlayPriority(int id, int priority)
 {
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::SetOverlayPriority>(serializerIn, id, priority);
+
+	BATCH_QUEUE(serializerIn, 1)
+	SERVER_CHECK(0)
+
+	if (PipeClient(serializerIn, serializerOut).success())
+		SERIALIZER_RET(int);
+
+	return 0;
+}
+
+EXPORT int SetOverlayPriorityNoReply(int id, int priority)
+{
+	Serializer serializerIn;
+
+	writeRequestNoReply<PipeMessages::SetOverlayPriority>(serializerIn, id, priority);
+
+	BATCH_QUEUE(serializerIn, 1)
+	RING_QUEUE(serializerIn, 1, 0)
 	SERVER_CHECK(0)
 
+	return (int)PipeClient(serializerIn).success();
+}
+
+EXPORT int GetErrorCount()
+{
+	BATCH_SEND()
+	SERVER_CHECK(-1)
+
 	Serializer serializerIn, serializerOut;
 
-	serializerIn << PipeMessages::SetOverlayPriority << id << priority;
+	writeRequest<PipeMessages::GetErrorCount>(serializerIn);
 
 	if (PipeClient(serializerIn, serializerOut).success())
 		SERIALIZER_RET(int);
 
+	return -1;
+}
+
+EXPORT int GetServerStats(int& opsPerSecond, int& p50, int& p99, int& p999)
+{
+	BATCH_SEND()
+	SERVER_CHECK(0)
+
+	Serializer serializerIn, serializerOut;
+
+	writeRequest<PipeMessages::GetServerStats>(serializerIn);
+
+	if (PipeClient(serializerIn, serializerOut).success())
+	{
+		std::tuple<int, int, int, int> stats;
+		if (!readReply<PipeMessages::GetServerStats>(serializerOut, stats))
+			return 0;
+
+		std::tie(opsPerSecond, p50, p99, p999) = stats;
+		return 1;
+	}
+
 	return 0;
 }
 
+EXPORT int ReserveHandles(int count)
+{
+	BATCH_SEND()
+	SERVER_CHECK(-1)
+
+	Serializer serializerIn, serializerOut;
 
+	writeRequest<PipeMessages::ReserveHandles>(serializerIn, count);
+
+	if (PipeClient(serializerIn, serializerOut).success())
+		SERIALIZER_RET(int);
+
+	return -1;
+}
\ No newline at end of file
@@ -2,38 +2,67 @@
 #include "Client.h"
 
 EXPORT int TextCreate(char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow);
+EXPORT int TextCreateAt(int id, char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow);
+EXPORT int TextCreateAtNoReply(int id, char *Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, char *text, bool bShadow, bool bShow);
 EXPORT int TextDestroy(int ID);
 EXPORT int TextSetShadow(int id, bool b);
+EXPORT int TextSetShadowNoReply(int id, bool b);
 EXPORT int TextSetShown(int id, bool b);
+EXPORT int TextSetShownNoReply(int id, bool b);
 EXPORT int TextSetColor(int id, unsigned int color);
+EXPORT int TextSetColorNoReply(int id, unsigned int color);
 EXPORT int TextSetPos(int id, int x, int y);
+EXPORT int TextSetPosNoReply(int id, int x, int y);
 EXPORT int TextSetString(int id, char *str);
+EXPORT int TextSetStringNoReply(int id, char *str);
 EXPORT int TextUpdate(int id, char *Font, int FontSize, bool bBold, bool bItalic);
 
 EXPORT int BoxCreate(int x, int y, int w, int h, unsigned int dwColor, bool bShow);
+EXPORT int BoxCreateAt(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow);
+EXPORT int BoxCreateAtNoReply(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow);
 EXPORT int BoxDestroy(int id);
 EXPORT int BoxSetShown(int id, bool bShown);
+EXPORT int BoxSetShownNoReply(int id, bool bShown);
 EXPORT int BoxSetBorder(int id, int height, bool bShown);
+EXPORT int BoxSetBorderNoReply(int id, int height, bool bShown);
 EXPORT int BoxSetBorderColor(int id, unsigned int dwColor);
+EXPORT int BoxSetBorderColorNoReply(int id, unsigned int dwColor);
 EXPORT int BoxSetColor(int id, unsigned int dwColor);
+EXPORT int BoxSetColorNoReply(int id, unsigned int dwColor);
 EXPORT int BoxSetHeight(int id, int height);
+EXPORT int BoxSetHeightNoReply(int id, int height);
 EXPORT int BoxSetPos(int id, int x, int y);
+EXPORT int BoxSetPosNoReply(int id, int x, int y);
 EXPORT int BoxSetWidth(int id, int width);
+EXPORT int BoxSetWidthNoReply(int id, int width);
 
 EXPORT int LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
+EXPORT int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
+EXPORT int LineCreateAtNoReply(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
 EXPORT int LineDestroy(int id);
 EXPORT int LineSetShown(int id, bool bShown);
+EXPORT int LineSetShownNoReply(int id, bool bShown);
 EXPORT int LineSetColor(int id, unsigned int color);
+EXPORT int LineSetColorNoReply(int id, unsigned int color);
 EXPORT int LineSetWidth(int id, int width);
+EXPORT int LineSetWidthNoReply(int id, int width);
 EXPORT int LineSetPos(int id, int x1, int y1, int x2, int y2);
+EXPORT int LineSetPosNoReply(int id, int x1, int y1, int x2, int y2);
 
 EXPORT int ImageCreate(char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
+EXPORT int ImageCreateAt(int id, char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
+EXPORT int ImageCreateAtNoReply(int id, char *path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow);
 EXPORT int ImageDestroy(int id);
 EXPORT int ImageSetShown(int id, bool bShown);
+EXPORT int ImageSetShownNoReply(int id, bool bShown);
 EXPORT int ImageSetAlign(int id, int align);
+EXPORT int ImageSetAlignNoReply(int id, int align);
 EXPORT int ImageSetPos(int id, int x, int y);
+EXPORT int ImageSetPosNoReply(int id, int x, int y);
 EXPORT int ImageSetRotation(int id, int rotation);
+EXPORT int ImageSetRotationNoReply(int id, int rotation);
 EXPORT int ImageSetScale(int id, float x, float y);
+EXPORT int ImageSetScaleNoReply(int id, float x, float y);
 
 EXPORT int DestroyAllVisual();
 EXPORT int ShowAllVisual();
@@ -41,6 +70,12 @@ EXPORT int HideAllVisual();
 
 EXPORT int GetFrameRate();
 EXPORT int GetScreenSpecs(int& width, int& height);
+EXPORT int GetErrorCount();
+EXPORT int GetServerStats(int& opsPerSecond, int& p50, int& p99, int& p999);
 
 EXPORT int SetCalculationRatio(int width, int height);
-EXPORT int SetOverlayPriority(int id, int priority);
\ No newline at end of file
+EXPORT int SetOverlayPriority(int id, int priority);
+EXPORT int SetOverlayPriorityNoReply(int id, int priority);
+
+// First of count handles for the *CreateAt calls, -1 on failure
+EXPORT int ReserveHandles(int count);
\ No newline at end of file
@@ -1,12 +1,22 @@
 #include <Utils/Windows.h>
 #include <Utils/Hook.h>
-#include <Utils/PipeServer.h>
+#include <Utils/Transport.h>
+#include <Utils/Dispatcher.h>
+#include <Utils/SharedMemory.h>
+#include <Utils/SharedRing.h>
+#include <Utils/StatusMailbox.h>
+#include <Utils/SessionLog.h>
+#include <Shared/Config.h>
 
 #include "Game.h"
 #include "Messagehandler.h"
 
 #include "Rendering/Renderer.h"
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include <Psapi.h>
 #pragma comment(lib, "psapi.lib")
 
@@ -20,8 +30,6 @@
 #include <Utils/PluginManager.h>
 
 
-#define BIND(T) PaketHandler[PipeMessages::T] = std::bind(T, std::placeholders::_1, std::placeholders::_2);
-
 // D3D9
 Hook<CallConvention::stdcall_t, HRESULT, LPDIRECT3DDEVICE9, CONST RECT *, CONST RECT *, HWND, CONST RGNDATA *> g_present9Hook;
 Hook<CallConvention::stdcall_t, HRESULT, LPDIRECT3DDEVICE9, D3DPRESENT_PARAMETERS *> g_reset9Hook;
@@ -49,9 +57,17 @@ Hook<CallConvention::stdcall_t, HRESULT, LPDIRECTINPUTDEVICE8, LPDIDEVICEOBJECTI
 
 PluginManager g_plugins;
 Renderer g_pRenderer;
+SharedMemory g_ringMemory;
+SharedRing g_ring;
+SharedMemory g_statusMemory;
+StatusMailbox g_status;
+std::atomic<int> g_iStatusInterval(0);
+std::atomic<uint32_t> g_uiResets(0);
 bool g_bEnabled = false;
 bool g_bIsUsingPresent = false;
 
+void drawOverlay(LPDIRECT3DDEVICE9 dev);
+
 extern "C" __declspec(dllexport) void enable()
 {
 	g_bEnabled = true;
@@ -169,74 +185,161 @@ void initGame()
 	}
 
 
-	typedef std::map<PipeMessages, std::function<void(Serializer&, Serializer&)>> MessagePaketHandler;
-	MessagePaketHandler PaketHandler;
-
-	BIND(TextCreate);
-	BIND(TextDestroy);
-	BIND(TextSetShadow);
-	BIND(TextSetShown);
-	BIND(TextSetColor);
-	BIND(TextSetPos);
-	BIND(TextSetString);
-	BIND(TextUpdate);
-
-	BIND(BoxCreate);
-	BIND(BoxDestroy);
-	BIND(BoxSetShown);
-	BIND(BoxSetBorder);
-	BIND(BoxSetBorderColor);
-	BIND(BoxSetColor);
-	BIND(BoxSetHeight);
-	BIND(BoxSetPos);
-	BIND(BoxSetWidth);
-
-	BIND(LineCreate);
-	BIND(LineDestroy);
-	BIND(LineSetShown);
-	BIND(LineSetColor);
-	BIND(LineSetWidth);
-	BIND(LineSetPos);
-
-	BIND(ImageCreate);
-	BIND(ImageDestroy);
-	BIND(ImageSetShown);
-	BIND(ImageSetAlign);
-	BIND(ImageSetPos);
-	BIND(ImageSetRotation);
-	BIND(ImageSetScale);
-
-	BIND(DestroyAllVisual);
-	BIND(ShowAllVisual);
-	BIND(HideAllVisual);
-
-	BIND(GetFrameRate);
-	BIND(GetScreenSpecs);
-
-	BIND(SetCalculationRatio);
-	BIND(SetOverlayPriority);
-
-	new PipeServer([&](Serializer& serializerIn, Serializer& serializerOut)
+	static Dispatcher dispatcher;
+	RegisterHandlers(dispatcher);
+
+	// Requests are logged for replaySession when capturing was asked for
+	std::unique_ptr<SessionRecorder> recorder;
+	char szCapture[MAX_PATH + 1] = { 0 };
+	if (GetEnvironmentVariableA(g_strCaptureVariable, szCapture, sizeof(szCapture)) > 0)
+	{
+		recorder.reset(new SessionRecorder(szCapture));
+		if (!recorder->isOpen())
+		{
+			BOOST_LOG_TRIVIAL(error) << "Couldn't open capture file " << szCapture;
+			recorder.reset();
+		}
+		else
 		{
-			SERIALIZATION_READ(serializerIn, PipeMessages, eMessage);
-
-			try
-			{
-				auto it = PaketHandler.find(eMessage);
-				if (it == PaketHandler.end())
-					return;
-
-				if (!PaketHandler[eMessage])
-					return;
-
-				PaketHandler[eMessage](serializerIn, serializerOut);
-			}
-			catch (...)
-			{
-			}
+			BOOST_LOG_TRIVIAL(info) << "Capturing requests to " << szCapture;
+		}
+	}
+
+	// Fire-and-forget updates wait for the next frame, collapsed to the latest per object and property
+	Coalescer coalescer(boost::bind(&Dispatcher::dispatch, &dispatcher, _1, _2));
+	RegisterCoalescing(coalescer);
+
+	// Changes between BeginTransaction and CommitTransaction are applied together when committed
+	TransactionQueue transactions(boost::bind(&Coalescer::receive, &coalescer, _1, _2));
+	RegisterTransactions(transactions);
+
+	// Clients from before the binary wire format still send boost text archives
+	TextArchiveCodec textArchives(boost::bind(&TransactionQueue::receive, &transactions, _1, _2));
+	RegisterTextArchive(textArchives);
+
+	// Per-frame updates may also arrive through the shared-memory ring. Both are set up before the listener,
+	// whose first Handshake reports whether they are available
+	if (!g_ringMemory.create(g_strRingName, SharedRing::requiredSize(g_uiRingCapacity)) ||
+		!g_ring.attach(g_ringMemory.data(), g_ringMemory.size(), true))
+	{
+		BOOST_LOG_TRIVIAL(error) << "Couldn't create shared command ring, falling back to pipe only";
+	}
+
+	// Subscribers read frame rate, screen size and resets from here instead of polling the pipe
+	if (!g_statusMemory.create(g_strStatusName, StatusMailbox::requiredSize()) ||
+		!g_status.attach(g_statusMemory.data(), g_statusMemory.size(), true))
+	{
+		BOOST_LOG_TRIVIAL(error) << "Couldn't create shared status mailbox, subscriptions are unavailable";
+	}
+
+	// The ring belongs to the pipe session its producer had when it was first drained
+	uint32_t uiRingProducer = 0;
+	SessionId ringSession = NoSession;
+
+	// Applies the staged updates and the ring, with the render mutex held
+	auto applyQueued = [&]()
+	{
+		// Staged pipe updates are older than the ring records that follow them
+		coalescer.flush();
+
+		if (!g_ring.isAttached())
+			return;
+
+		// A producer that reconnected over the pipe gets its new session
+		auto uiProducer = g_ring.producer();
+		if (uiProducer != uiRingProducer || ringSession == NoSession)
+		{
+			uiRingProducer = uiProducer;
+			ringSession = uiProducer != 0 ? sessionOfProcess(uiProducer) : NoSession;
+		}
+
+		SessionScope scope(ringSession);
+
+		g_ring.drain([&](const char *data, uint32_t length)
+		{
+			// Without a pipe session nothing would ever clean up after them, so they are dropped
+			if (ringSession == NoSession)
+				return;
+
+			if (recorder)
+				recorder->record(data, length);
+
+			Serializer serializerIn(data, length);
+			Serializer serializerOut;
+
+			dispatcher.dispatch(serializerIn, serializerOut);
+
+			// Nobody waits on ring commands, keep their failures countable (flagged ones were counted by dispatch)
+			PipeMessages eMessage;
+			Serializer(data, length) >> eMessage;
+
+			if (wantsReply(eMessage))
+				dispatcher.completed(serializerOut);
 		});
+	};
+
+	IListener::Callback callback = boost::bind(&TextArchiveCodec::receive, &textArchives, _1, _2);
+	if (recorder)
+		callback = recorder->wrap(callback);
+
+	// A pipe request of the ring's producer mustn't overtake the ring records it queued before, those go first
+	auto ordered = [&](Serializer& serializerIn, Serializer& serializerOut)
+	{
+		if (g_ring.isAttached() && !g_ring.empty() && sessionOfProcess(g_ring.producer()) == currentSession())
+		{
+			std::lock_guard<std::recursive_mutex> l(g_pRenderer.renderMutex());
+			applyQueued();
+		}
+
+		callback(serializerIn, serializerOut);
+	};
+
+	// Objects of a client that went away are destroyed along with its session, by the update loop below:
+	// the listener's I/O thread serves every other client and mustn't wait for the render lock
+	std::mutex closedMutex;
+	std::vector<SessionId> closedSessions;
+
+	auto listener = createListener(g_strPipeName, ordered,
+		[&](SessionId session)
+	{
+		std::lock_guard<std::mutex> l(closedMutex);
+		closedSessions.push_back(session);
+	});
+
+	// Each frame only wakes this thread, which applies what came in meanwhile under the render mutex.
+	// The render thread doesn't wait for that: a draw that finds the mutex taken shows the last published scene.
+	auto hFrame = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	g_pRenderer.setFrameCallback([&]()
+	{
+		SetEvent(hFrame);
+	});
 
-	// block this thread infinitely
+	while (WaitForSingleObject(hFrame, INFINITE) == WAIT_OBJECT_0)
+	{
+		std::vector<SessionId> closed;
+		{
+			std::lock_guard<std::mutex> l(closedMutex);
+			closed.swap(closedSessions);
+		}
+
+		std::lock_guard<std::recursive_mutex> l(g_pRenderer.renderMutex());
+
+		for (auto session : closed)
+		{
+			transactions.closed(session);
+			coalescer.closed(session);
+			g_pRenderer.destroyAll(session);
+
+			if (session == ringSession)
+				ringSession = NoSession;
+		}
+
+		applyQueued();
+	}
+
+	// Only without the event; requests are still served, fire-and-forget updates wait for good
+	BOOST_LOG_TRIVIAL(error) << "Couldn't wait for frames, staged updates aren't applied";
 	WaitForSingleObject(INVALID_HANDLE_VALUE, INFINITE);
 }
 
@@ -245,6 +348,79 @@ void logOnce(std::string message)
 	BOOST_LOG_TRIVIAL(info) << message;
 }
 
+bool subscribeStatus(int intervalMs)
+{
+	if (!g_status.isAttached())
+		return false;
+
+	intervalMs = max(intervalMs, g_iMinStatusInterval);
+
+	// There is one mailbox for everybody, so it is kept up to date for the most demanding subscriber
+	int current = g_iStatusInterval.load();
+	while ((current == 0 || intervalMs < current) && !g_iStatusInterval.compare_exchange_weak(current, intervalMs))
+		;
+
+	return true;
+}
+
+void notifyReset()
+{
+	g_uiResets++;
+}
+
+unsigned int availableFeatures()
+{
+	unsigned int features = PipeFeatures::Batch | PipeFeatures::Transactions | PipeFeatures::Pipelining | PipeFeatures::ReservedHandles;
+
+	// Shared memory may have failed to come up, the pipe alone works regardless
+	if (g_ring.isAttached())
+		features |= PipeFeatures::SharedRing;
+	if (g_status.isAttached())
+		features |= PipeFeatures::Subscriptions;
+
+	return features;
+}
+
+void publishStatus()
+{
+	static DWORD dwLastPublish = 0;
+	static uint32_t uiUpdates = 0;
+
+	int interval = g_iStatusInterval.load();
+	if (interval == 0 || !g_status.isAttached())
+		return;
+
+	DWORD dwNow = GetTickCount();
+	if (dwNow - dwLastPublish < static_cast<DWORD>(interval))
+		return;
+
+	dwLastPublish = dwNow;
+
+	StatusMailbox::Status status;
+	status.frameRate = g_pRenderer.frameRate();
+	status.width = g_pRenderer.screenWidth();
+	status.height = g_pRenderer.screenHeight();
+	status.resets = g_uiResets.load();
+	status.updates = ++uiUpdates;
+
+	g_status.publish(status);
+}
+
+void drawOverlay(LPDIRECT3DDEVICE9 dev)
+{
+	// Present comes after the game's EndScene, the overlay needs a scene of its own
+	bool bScene = SUCCEEDED(dev->BeginScene());
+
+	// Drawn even without a scene, so ring and deferred updates keep being applied
+	g_pRenderer.draw(dev);
+
+	// Also on frames whose draw found the render mutex taken, subscribers go by the frame rate
+	publishStatus();
+
+	if (bScene)
+		dev->EndScene();
+}
+
 void HookDX9(UINTX* vtable9)
 {
 	BOOST_LOG_TRIVIAL(info) << "Hooking IDirect3DDevice9::Present";
@@ -254,6 +430,8 @@ void HookDX9(UINTX* vtable9)
 		                     static boost::once_flag flag = BOOST_ONCE_INIT;
 		                     boost::call_once(flag, boost::bind(&logOnce, "++ IDirect3DDevice9::Present called"));
 
+		                     drawOverlay(dev);
+
 		                     g_plugins.present(IID_IDirect3DDevice9, dev);
 
 		                     return g_present9Hook.callOrig(dev, a1, a2, a3, a4);
@@ -266,7 +444,9 @@ void HookDX9(UINTX* vtable9)
 		                   static boost::once_flag flag = BOOST_ONCE_INIT;
 		                   boost::call_once(flag, boost::bind(&logOnce, "++ IDirect3DDevice9::Reset called"));
 
-		                   // g_pRenderer.reset(dev);
+		                   g_pRenderer.reset(dev);
+
+		                   notifyReset();
 
 		                   return g_reset9Hook.callOrig(dev, pp);
 	                   });
@@ -310,6 +490,8 @@ void HookDX9Ex(UINTX* vtable9Ex)
 		                       static boost::once_flag flag = BOOST_ONCE_INIT;
 		                       boost::call_once(flag, boost::bind(&logOnce, "++ IDirect3DDevice9Ex::PresentEx called"));
 
+		                       drawOverlay(dev);
+
 		                       g_plugins.present(IID_IDirect3DDevice9Ex, dev);
 
 		                       return g_present9ExHook.callOrig(dev, a1, a2, a3, a4, a5);
@@ -322,7 +504,9 @@ void HookDX9Ex(UINTX* vtable9Ex)
 		                     static boost::once_flag flag = BOOST_ONCE_INIT;
 		                     boost::call_once(flag, boost::bind(&logOnce, "++ IDirect3DDevice9Ex::ResetEx called"));
 
-		                     // g_pRenderer.reset(dev);
+		                     g_pRenderer.reset(dev);
+
+		                     notifyReset();
 
 		                     return g_reset9ExHook.callOrig(dev, pp, ppp);
 	                     });
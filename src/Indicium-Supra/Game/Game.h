@@ -21,6 +21,12 @@ extern class Renderer g_pRenderer;
 void initGame();
 void logOnce(std::string message);
 
+// Starts publishing to the status mailbox at least every intervalMs, false if there is none
+bool subscribeStatus(int intervalMs);
+void notifyReset();
+// PipeFeatures this server can offer right now
+unsigned int availableFeatures();
+
 void HookDX9(UINTX* vtable9);
 void HookDX9Ex(UINTX* vtable9Ex);
 void HookDX10(UINTX* vtable10SwapChain);
@@ -9,361 +9,346 @@
 #include "Rendering/Renderer.h"
 #include "Rendering/RenderBase.h"
 
-#define READ(X, Y) SERIALIZATION_READ(serializerIn, X, Y);
-#define WRITE(X) serializerOut << X;
+#define BIND(T) dispatcher.bind<PipeMessages::T, T>();
 
-void TextCreate(Serializer& serializerIn, Serializer& serializerOut)
+int TextCreate(std::string Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, std::string string, bool bShadow, bool bShow)
 {
-	READ(std::string, Font); 
-	READ(int, FontSize); 
-	READ(bool, bBold);
-	READ(bool, bItalic);
-	READ(int, x); 
-	READ(int, y);
-	READ(unsigned int, color);
-	READ(std::string, string);
-	READ(bool, bShadow);
-	READ(bool, bShow);
+	return g_pRenderer.add(std::make_shared<Text>(&g_pRenderer, Font, FontSize, bBold, bItalic, x, y, color, string, bShadow, bShow));
+}
 
-	WRITE(g_pRenderer.add(std::make_shared<Text>(&g_pRenderer, Font, FontSize, bBold, bItalic, x, y, color, string, bShadow, bShow)));
+int TextCreateAt(int id, std::string Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, std::string string, bool bShadow, bool bShow)
+{
+	return int(g_pRenderer.addAt(id, std::make_shared<Text>(&g_pRenderer, Font, FontSize, bBold, bItalic, x, y, color, string, bShadow, bShow)));
 }
 
-void TextDestroy(Serializer& serializerIn, Serializer& serializerOut)
+int TextDestroy(int id)
 {
-	READ(int, id);
-	WRITE(int(g_pRenderer.remove(id)));
+	return int(g_pRenderer.remove(id));
 }
 
-void TextSetShadow(Serializer& serializerIn, Serializer& serializerOut)
+int TextSetShadow(int id, bool bShadow)
 {
-	READ(int, id); 
-	READ(bool, bShadow);
-	
-	WRITE(int(safeExecuteWithValidation([&](){ 
+	return int(safeExecuteWithValidation([&](){ 
 		g_pRenderer.getAs<Text>(id)->setShadow(bShadow); 
-	})));
+	}));
 }
 
-void TextSetShown(Serializer& serializerIn, Serializer& serializerOut)
+int TextSetShown(int id, bool bShown)
 {
-	READ(int, id); 
-	READ(bool, bShown);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Text>(id)->setShown(bShown);
-	})));
+	}));
 }
 
-void TextSetColor(Serializer& serializerIn, Serializer& serializerOut)
+int TextSetColor(int id, unsigned int color)
 {
-	READ(int, id); 
-	READ(unsigned int, color);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Text>(id)->setColor(color);
-	})));
+	}));
 }
 
-void TextSetPos(Serializer& serializerIn, Serializer& serializerOut)
+int TextSetPos(int id, int x, int y)
 {
-	READ(int, id); 
-	READ(int, x); 
-	READ(int, y);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Text>(id)->setPos(x, y);
-	})));
+	}));
 }
 
-void TextSetString(Serializer& serializerIn, Serializer& serializerOut)
+int TextSetString(int id, std::string str)
 {
-	READ(int, id); 
-	READ(std::string, str);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Text>(id)->setText(str);
-	})));
+	}));
 }
 
-void TextUpdate(Serializer& serializerIn, Serializer& serializerOut)
+int TextUpdate(int id, std::string Font, int FontSize, bool bBold, bool bItalic)
 {
-	READ(int, id); 
-	READ(std::string, Font); 
-	READ(int, FontSize); 
-	READ(bool, bBold); 
-	READ(bool, bItalic);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Text>(id)->updateText(Font, FontSize, bBold, bItalic);
-	})));
+	}));
 }
 
-void BoxCreate(Serializer& serializerIn, Serializer& serializerOut)
+int BoxCreate(int x, int y, int w, int h, unsigned int dwColor, bool bShow)
 {
-	READ(int, x); 
-	READ(int, y); 
-	READ(int, w); 
-	READ(int, h); 
-	READ(unsigned int, dwColor); 
-	READ(bool, bShow);
-
-	WRITE(g_pRenderer.add(std::make_shared<Box>(&g_pRenderer, x, y, w, h, dwColor, bShow)));
+	return g_pRenderer.add(std::make_shared<Box>(&g_pRenderer, x, y, w, h, dwColor, bShow));
 }
 
-void BoxDestroy(Serializer& serializerIn, Serializer& serializerOut)
+int BoxCreateAt(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow)
 {
-	READ(int, id);
-	WRITE((int) g_pRenderer.remove(id));
+	return int(g_pRenderer.addAt(id, std::make_shared<Box>(&g_pRenderer, x, y, w, h, dwColor, bShow)));
 }
 
-void BoxSetShown(Serializer& serializerIn, Serializer& serializerOut)
+int BoxDestroy(int id)
 {
-	READ(int, id); 
-	READ(bool, bShown);
+	return (int) g_pRenderer.remove(id);
+}
 
-	WRITE(int(safeExecuteWithValidation([&](){
+int BoxSetShown(int id, bool bShown)
+{
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Box>(id)->setShown(bShown);
-	})));
+	}));
 }
 
-void BoxSetBorder(Serializer& serializerIn, Serializer& serializerOut)
+int BoxSetBorder(int id, int height, bool bShown)
 {
-	READ(int, id); 
-	READ(int, height); 
-	READ(bool, bShown);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Box>(id)->setBorderWidth(height);
 		g_pRenderer.getAs<Box>(id)->setBorderShown(bShown);
-	})));
+	}));
 }
 
-void BoxSetBorderColor(Serializer& serializerIn, Serializer& serializerOut)
+int BoxSetBorderColor(int id, unsigned int dwColor)
 {
-	READ(int, id); 
-	READ(unsigned int, dwColor);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Box>(id)->setBorderColor(dwColor);
-	})));
+	}));
 }
 
-void BoxSetColor(Serializer& serializerIn, Serializer& serializerOut)
+int BoxSetColor(int id, unsigned int dwColor)
 {
-	READ(int, id); 
-	READ(unsigned int, dwColor);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Box>(id)->setBoxColor(dwColor);
-	})));
+	}));
 }
 
-void BoxSetHeight(Serializer& serializerIn, Serializer& serializerOut)
+int BoxSetHeight(int id, int height)
 {
-	READ(int, id); 
-	READ(int, height);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Box>(id)->setBoxHeight(height);
-	})));
+	}));
 }
 
-void BoxSetPos(Serializer& serializerIn, Serializer& serializerOut)
+int BoxSetPos(int id, int x, int y)
 {
-	READ(int, id); 
-	READ(int, x); 
-	READ(int, y);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Box>(id)->setPos(x, y);
-	})));
+	}));
 }
 
-void BoxSetWidth(Serializer& serializerIn, Serializer& serializerOut)
+int BoxSetWidth(int id, int width)
 {
-	READ(int, id); 
-	READ(int, width);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Box>(id)->setBoxWidth(width);
-	})));
+	}));
 }
 
-void LineCreate(Serializer& serializerIn, Serializer& serializerOut)
+int LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow)
 {
-	READ(int, x1); 
-	READ(int, y1); 
-	READ(int, x2); 
-	READ(int, y2); 
-	READ(int, width); 
-	READ(unsigned int, color);
-	READ(bool, bShow);
-
-	WRITE(g_pRenderer.add(std::make_shared<Line>(&g_pRenderer, x1, y1, x2, y2, width, color, bShow)));
+	return g_pRenderer.add(std::make_shared<Line>(&g_pRenderer, x1, y1, x2, y2, width, color, bShow));
 }
 
-void LineDestroy(Serializer& serializerIn, Serializer& serializerOut)
+int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow)
 {
-	READ(int, id);
-	WRITE((int) g_pRenderer.remove(id));
+	return int(g_pRenderer.addAt(id, std::make_shared<Line>(&g_pRenderer, x1, y1, x2, y2, width, color, bShow)));
 }
 
-void LineSetShown(Serializer& serializerIn, Serializer& serializerOut)
+int LineDestroy(int id)
 {
-	READ(int, id); 
-	READ(bool, bShown);
+	return (int) g_pRenderer.remove(id);
+}
 
-	WRITE(int(safeExecuteWithValidation([&](){
+int LineSetShown(int id, bool bShown)
+{
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Line>(id)->setShown(bShown);
-	})));
+	}));
 }
 
-void LineSetColor(Serializer& serializerIn, Serializer& serializerOut)
+int LineSetColor(int id, unsigned int color)
 {
-	READ(int, id); 
-	READ(unsigned int, color);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Line>(id)->setColor(color);
-	})));
+	}));
 }
 
-void LineSetWidth(Serializer& serializerIn, Serializer& serializerOut)
+int LineSetWidth(int id, int width)
 {
-	READ(int, id); 
-	READ(int, width);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Line>(id)->setWidth(width);
-	})));
+	}));
 }
 
-void LineSetPos(Serializer& serializerIn, Serializer& serializerOut)
+int LineSetPos(int id, int x1, int y1, int x2, int y2)
 {
-	READ(int, id); 
-	READ(int, x1); 
-	READ(int, y1); 
-	READ(int, x2); 
-	READ(int, y2);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Line>(id)->setPos(x1, y1, x2, y2);
-	})));
+	}));
 }
 
-void ImageCreate(Serializer& serializerIn, Serializer& serializerOut)
+int ImageCreate(std::string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool show)
 {
-	READ(std::string, path); 
-	READ(int, x); 
-	READ(int, y); 
-	READ(float, scaleX);
-	READ(float, scaleY);
-	READ(int, rotation); 
-	READ(int, align); 
-	READ(bool, show);
-	
-	WRITE(g_pRenderer.add(std::make_shared<Image>(&g_pRenderer, path.c_str(), x, y, scaleX, scaleY, rotation, align, show)));
+	return g_pRenderer.add(std::make_shared<Image>(&g_pRenderer, path.c_str(), x, y, scaleX, scaleY, rotation, align, show));
 }
 
-void ImageDestroy(Serializer& serializerIn, Serializer& serializerOut)
+int ImageCreateAt(int id, std::string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool show)
 {
-	READ(int, id);
-	WRITE((int) g_pRenderer.remove(id));
+	return int(g_pRenderer.addAt(id, std::make_shared<Image>(&g_pRenderer, path.c_str(), x, y, scaleX, scaleY, rotation, align, show)));
 }
 
-void ImageSetShown(Serializer& serializerIn, Serializer& serializerOut)
+int ImageDestroy(int id)
 {
-	READ(int, id); 
-	READ(bool, bShow);
+	return (int) g_pRenderer.remove(id);
+}
 
-	WRITE(int(safeExecuteWithValidation([&](){
+int ImageSetShown(int id, bool bShow)
+{
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Image>(id)->setShown(bShow);
-	})));
+	}));
 }
 
-void ImageSetAlign(Serializer& serializerIn, Serializer& serializerOut)
+int ImageSetAlign(int id, int align)
 {
-	READ(int, id); 
-	READ(int, align);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Image>(id)->setAlign(align);
-	})));
+	}));
 }
 
-void ImageSetPos(Serializer& serializerIn, Serializer& serializerOut)
+int ImageSetPos(int id, int x, int y)
 {
-	READ(int, id); 
-	READ(int, x); 
-	READ(int, y);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Image>(id)->setPos(x, y);
-	})));
+	}));
 }
 
-void ImageSetRotation(Serializer& serializerIn, Serializer& serializerOut)
+int ImageSetRotation(int id, int rotation)
 {
-	READ(int, id); 
-	READ(int, rotation);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Image>(id)->setRotation(rotation);
-	})));
+	}));
 }
 
-void ImageSetScale(Serializer& serializerIn, Serializer& serializerOut)
+int ImageSetScale(int id, float x, float y)
 {
-	READ(int, id);
-	READ(float, x);
-	READ(float, y);
-
-	WRITE(int(safeExecuteWithValidation([&](){
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.getAs<Image>(id)->setScale(x, y);
-	})));
+	}));
 }
 
-void DestroyAllVisual(Serializer& serializerIn, Serializer& serializerOut)
+void DestroyAllVisual()
 {
-	g_pRenderer.destroyAll();
+	g_pRenderer.destroyAll(currentSession());
 }
 
-void ShowAllVisual(Serializer& serializerIn, Serializer& serializerOut)
+void ShowAllVisual()
 {
-	g_pRenderer.showAll();
+	g_pRenderer.showAll(currentSession());
 }
 
-void HideAllVisual(Serializer& serializerIn, Serializer& serializerOut)
+void HideAllVisual()
 {
-	g_pRenderer.hideAll();
+	g_pRenderer.hideAll(currentSession());
 }
 
-void GetFrameRate(Serializer& serializerIn, Serializer& serializerOut)
+int GetFrameRate()
 {
-	WRITE(g_pRenderer.frameRate());
+	return g_pRenderer.frameRate();
 }
 
-void GetScreenSpecs(Serializer& serializerIn, Serializer& serializerOut)
+std::tuple<int, int> GetScreenSpecs()
 {
-	WRITE(g_pRenderer.screenWidth()); 
-	WRITE(g_pRenderer.screenHeight());
+	return std::make_tuple(g_pRenderer.screenWidth(), g_pRenderer.screenHeight());
 }
 
-void SetCalculationRatio(Serializer& serializerIn, Serializer& serializerOut)
+void SetCalculationRatio(int width, int height)
 {
-	READ(int, width);
-	READ(int, height);
-
 	RenderBase::xCalculator = width;
 	RenderBase::yCalculator = height;
 }
 
-void SetOverlayPriority(Serializer& serializerIn, Serializer& serializerOut)
+int ReserveHandles(int count)
+{
+	return g_pRenderer.reserve(count);
+}
+
+int Subscribe(int intervalMs)
+{
+	return int(subscribeStatus(intervalMs));
+}
+
+std::tuple<int, int, unsigned int, unsigned int> Handshake(int version, unsigned int features)
 {
-	READ(int, id);
-	READ(int, priority);
+	BOOST_LOG_TRIVIAL(info) << "Client speaks protocol version " << version;
 
-	WRITE(int(safeExecuteWithValidation([&](){
+	// Only what both sides know is offered, unknown bits of a newer client are dropped
+	return std::make_tuple(PipeProtocolVersion, MAX_MESSAGE_SIZE, static_cast<unsigned int>(PipeEncodings::Binary | PipeEncodings::TextArchive), availableFeatures() & features);
+}
+
+int SetOverlayPriority(int id, int priority)
+{
+	// Looked up and moved under one hold, so the object can't leave the scene in between
+	std::lock_guard<std::recursive_mutex> l(g_pRenderer.renderMutex());
+
+	return int(safeExecuteWithValidation([&](){
 		g_pRenderer.get(id)->setPriority(priority);
-	})));
+	}));
 }
+
+void Batch(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher)
+{
+	// Apply the whole batch under one lock so the render thread sees it at once
+	std::lock_guard<std::recursive_mutex> l(g_pRenderer.renderMutex());
+
+	RouteBatch(serializerIn, serializerOut, dispatcher);
+}
+
+void RegisterHandlers(Dispatcher& dispatcher)
+{
+	BIND(TextCreate);
+	BIND(TextCreateAt);
+	BIND(TextDestroy);
+	BIND(TextSetShadow);
+	BIND(TextSetShown);
+	BIND(TextSetColor);
+	BIND(TextSetPos);
+	BIND(TextSetString);
+	BIND(TextUpdate);
+
+	BIND(BoxCreate);
+	BIND(BoxCreateAt);
+	BIND(BoxDestroy);
+	BIND(BoxSetShown);
+	BIND(BoxSetBorder);
+	BIND(BoxSetBorderColor);
+	BIND(BoxSetColor);
+	BIND(BoxSetHeight);
+	BIND(BoxSetPos);
+	BIND(BoxSetWidth);
+
+	BIND(LineCreate);
+	BIND(LineCreateAt);
+	BIND(LineDestroy);
+	BIND(LineSetShown);
+	BIND(LineSetColor);
+	BIND(LineSetWidth);
+	BIND(LineSetPos);
+
+	BIND(ImageCreate);
+	BIND(ImageCreateAt);
+	BIND(ImageDestroy);
+	BIND(ImageSetShown);
+	BIND(ImageSetAlign);
+	BIND(ImageSetPos);
+	BIND(ImageSetRotation);
+	BIND(ImageSetScale);
+
+	BIND(DestroyAllVisual);
+	BIND(ShowAllVisual);
+	BIND(HideAllVisual);
+
+	BIND(GetFrameRate);
+	BIND(GetScreenSpecs);
+
+	BIND(SetCalculationRatio);
+	BIND(SetOverlayPriority);
+
+	BIND(ReserveHandles);
+	BIND(Subscribe);
+	BIND(Handshake);
+
+	dispatcher.bindWithDispatcher<PipeMessages::Batch, Batch>();
+	dispatcher.bindWithDispatcher<PipeMessages::GetErrorCount, GetErrorCount>();
+	dispatcher.bindWithDispatcher<PipeMessages::GetServerStats, GetServerStats>();
+}
+
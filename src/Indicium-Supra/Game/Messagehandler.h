@@ -1,50 +1,63 @@
 #pragma once
 #include <Utils/Serializer.h>
+#include <Utils/Dispatcher.h>
+#include <Utils/MessageTable.h>
 #include <Shared/PipeMessages.h>
 
-#include <functional>
-
-void TextCreate(Serializer& serializerIn, Serializer& serializerOut);
-void TextDestroy(Serializer& serializerIn, Serializer& serializerOut);
-void TextSetShadow(Serializer& serializerIn, Serializer& serializerOut);
-void TextSetShown(Serializer& serializerIn, Serializer& serializerOut);
-void TextSetColor(Serializer& serializerIn, Serializer& serializerOut);
-void TextSetPos(Serializer& serializerIn, Serializer& serializerOut);
-void TextSetString(Serializer& serializerIn, Serializer& serializerOut);
-void TextUpdate(Serializer& serializerIn, Serializer& serializerOut);
-
-void BoxCreate(Serializer& serializerIn, Serializer& serializerOut);
-void BoxDestroy(Serializer& serializerIn, Serializer& serializerOut);
-void BoxSetShown(Serializer& serializerIn, Serializer& serializerOut);
-void BoxSetBorder(Serializer& serializerIn, Serializer& serializerOut);
-void BoxSetBorderColor(Serializer& serializerIn, Serializer& serializerOut);
-void BoxSetColor(Serializer& serializerIn, Serializer& serializerOut);
-void BoxSetHeight(Serializer& serializerIn, Serializer& serializerOut);
-void BoxSetPos(Serializer& serializerIn, Serializer& serializerOut);
-void BoxSetWidth(Serializer& serializerIn, Serializer& serializerOut);
-
-void LineCreate(Serializer& serializerIn, Serializer& serializerOut);
-void LineDestroy(Serializer& serializerIn, Serializer& serializerOut);
-void LineSetShown(Serializer& serializerIn, Serializer& serializerOut);
-void LineSetColor(Serializer& serializerIn, Serializer& serializerOut);
-void LineSetWidth(Serializer& serializerIn, Serializer& serializerOut);
-void LineSetPos(Serializer& serializerIn, Serializer& serializerOut);
-
-void ImageCreate(Serializer& serializerIn, Serializer& serializerOut);
-void ImageDestroy(Serializer& serializerIn, Serializer& serializerOut);
-void ImageSetShown(Serializer& serializerIn, Serializer& serializerOut);
-void ImageSetAlign(Serializer& serializerIn, Serializer& serializerOut);
-void ImageSetPos(Serializer& serializerIn, Serializer& serializerOut);
-void ImageSetRotation(Serializer& serializerIn, Serializer& serializerOut);
-void ImageSetScale(Serializer& serializerIn, Serializer& serializerOut);
-
-void DestroyAllVisual(Serializer& serializerIn, Serializer& serializerOut);
-void ShowAllVisual(Serializer& serializerIn, Serializer& serializerOut);
-void HideAllVisual(Serializer& serializerIn, Serializer& serializerOut);
-
-void GetFrameRate(Serializer& serializerIn, Serializer& serializerOut);
-void GetScreenSpecs(Serializer& serializerIn, Serializer& serializerOut);
-
-void SetCalculationRatio(Serializer& serializerIn, Serializer& serializerOut);
-
-void SetOverlayPriority(Serializer& serializerIn, Serializer& serializerOut);
\ No newline at end of file
+int TextCreate(std::string Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, std::string string, bool bShadow, bool bShow);
+int TextCreateAt(int id, std::string Font, int FontSize, bool bBold, bool bItalic, int x, int y, unsigned int color, std::string string, bool bShadow, bool bShow);
+int TextDestroy(int id);
+int TextSetShadow(int id, bool bShadow);
+int TextSetShown(int id, bool bShown);
+int TextSetColor(int id, unsigned int color);
+int TextSetPos(int id, int x, int y);
+int TextSetString(int id, std::string str);
+int TextUpdate(int id, std::string Font, int FontSize, bool bBold, bool bItalic);
+
+int BoxCreate(int x, int y, int w, int h, unsigned int dwColor, bool bShow);
+int BoxCreateAt(int id, int x, int y, int w, int h, unsigned int dwColor, bool bShow);
+int BoxDestroy(int id);
+int BoxSetShown(int id, bool bShown);
+int BoxSetBorder(int id, int height, bool bShown);
+int BoxSetBorderColor(int id, unsigned int dwColor);
+int BoxSetColor(int id, unsigned int dwColor);
+int BoxSetHeight(int id, int height);
+int BoxSetPos(int id, int x, int y);
+int BoxSetWidth(int id, int width);
+
+int LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
+int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool bShow);
+int LineDestroy(int id);
+int LineSetShown(int id, bool bShown);
+int LineSetColor(int id, unsigned int color);
+int LineSetWidth(int id, int width);
+int LineSetPos(int id, int x1, int y1, int x2, int y2);
+
+int ImageCreate(std::string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool show);
+int ImageCreateAt(int id, std::string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool show);
+int ImageDestroy(int id);
+int ImageSetShown(int id, bool bShow);
+int ImageSetAlign(int id, int align);
+int ImageSetPos(int id, int x, int y);
+int ImageSetRotation(int id, int rotation);
+int ImageSetScale(int id, float x, float y);
+
+void DestroyAllVisual();
+void ShowAllVisual();
+void HideAllVisual();
+
+int GetFrameRate();
+std::tuple<int, int> GetScreenSpecs();
+
+void SetCalculationRatio(int width, int height);
+
+int SetOverlayPriority(int id, int priority);
+
+int ReserveHandles(int count);
+int Subscribe(int intervalMs);
+std::tuple<int, int, unsigned int, unsigned int> Handshake(int version, unsigned int features);
+
+void Batch(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher);
+
+// Binds every handler above and the dispatcher's own from MessageTable.h to their messages
+void RegisterHandlers(Dispatcher& dispatcher);
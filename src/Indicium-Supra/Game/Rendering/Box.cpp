@@ -1,8 +1,7 @@
 #include "Box.h"
-#include "dx_utils.h"
 
 Box::Box(Renderer *renderer,  int x, int y, int w, int h, D3DCOLOR color, bool show)
-	: RenderBase(renderer), m_bShown(false)
+	: RenderBase(renderer), m_pending(), m_state()
 {
 	setPos(x, y);
 	setBoxWidth(w);
@@ -18,58 +17,50 @@ Box::Box(Renderer *renderer,  int x, int y, int w, int h, D3DCOLOR color, bool s
 
 void Box::setPos(int x,int y)
 {
-	m_iX = x, m_iY = y;
+	auto l = beginUpdate();
+	m_pending.iX = x, m_pending.iY = y;
 }
 
 void Box::setBorderColor(D3DCOLOR dwColor)
 {
-	m_dwBorderColor = dwColor;
+	auto l = beginUpdate();
+	m_pending.dwBorderColor = dwColor;
 }
 
 void Box::setBoxColor(D3DCOLOR dwColor)
 {
-	m_dwBoxColor = dwColor;
+	auto l = beginUpdate();
+	m_pending.dwBoxColor = dwColor;
 }
 
 void Box::setBorderWidth(DWORD dwWidth)
 {
-	m_dwBorderWidth = dwWidth;
+	auto l = beginUpdate();
+	m_pending.dwBorderWidth = dwWidth;
 }
 
 void Box::setBoxWidth(DWORD dwWidth)
 {
-	m_dwBoxWidth = dwWidth;
+	auto l = beginUpdate();
+	m_pending.dwBoxWidth = dwWidth;
 }
 
 void Box::setBoxHeight(DWORD dwHeight)
 {
-	m_dwBoxHeight = dwHeight;
+	auto l = beginUpdate();
+	m_pending.dwBoxHeight = dwHeight;
 }
 
 void Box::setBorderShown(bool b)
 {
-	m_bBorderShown = b;
+	auto l = beginUpdate();
+	m_pending.bBorderShown = b;
 }
 
 void Box::setShown(bool b)
 {
-	m_bShown = b;
-}
-
-void Box::draw(IDirect3DDevice9 *pDevice)
-{
-	if(!m_bShown)
-		return;
-
-	float x = (float)calculatedXPos(m_iX);
-	float y = (float)calculatedYPos(m_iY);
-	float w = (float)calculatedXPos(m_dwBoxWidth);
-	float h = (float)calculatedYPos(m_dwBoxHeight);
-
-	Drawing::DrawBox(x, y, w, h, m_dwBoxColor, pDevice);
-
-	if(m_bBorderShown)
-		Drawing::DrawRectangular(x, y, w, h, (float)m_dwBorderWidth, m_dwBorderColor, pDevice);
+	auto l = beginUpdate();
+	m_pending.bShown = b;
 }
 
 void Box::reset(IDirect3DDevice9 *pDevice)
@@ -89,8 +80,8 @@ void Box::hide()
 
 void Box::releaseResourcesForDeletion(IDirect3DDevice9 *pDevice)
 {
-	m_bShown = false;
-	m_bBorderShown = false;
+	m_state.bShown = false;
+	m_state.bBorderShown = false;
 }
 
 bool Box::canBeDeleted()
@@ -106,4 +97,25 @@ bool Box::loadResource(IDirect3DDevice9 *pDevice)
 void Box::firstDrawAfterReset(IDirect3DDevice9 *pDevice)
 {
 	
+}
+
+void Box::publish()
+{
+	m_state = m_pending;
+}
+
+bool Box::drawnAsBox() const
+{
+	return true;
+}
+
+void Box::storeBox(BoxArray& boxes, size_t index)
+{
+	uint8_t flags = 0;
+	if (m_state.bShown)
+		flags |= BoxArray::Shown;
+	if (m_state.bBorderShown)
+		flags |= BoxArray::BorderShown;
+
+	boxes.set(index, m_state.iX, m_state.iY, m_state.dwBoxWidth, m_state.dwBoxHeight, m_state.dwBoxColor, m_state.dwBorderColor, m_state.dwBorderWidth, flags);
 }
\ No newline at end of file
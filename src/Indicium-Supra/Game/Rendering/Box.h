@@ -18,7 +18,6 @@ public:
 	void setShown(bool b);
 
 protected:
-	virtual void draw(IDirect3DDevice9 *pDevice) sealed;
 	virtual void reset(IDirect3DDevice9 *pDevice) sealed;
 
 	virtual void show() sealed;
@@ -30,9 +29,20 @@ protected:
 	virtual bool loadResource(IDirect3DDevice9 *pDevice) override sealed;
 	virtual void firstDrawAfterReset(IDirect3DDevice9 *pDevice) override sealed;
 
+	virtual void publish() override sealed;
+
+	virtual bool drawnAsBox() const override sealed;
+	virtual void storeBox(BoxArray& boxes, size_t index) override sealed;
+
 private:
-	bool m_bShown, m_bBorderShown;
-	D3DCOLOR m_dwBoxColor, m_dwBorderColor;
-	DWORD m_dwBorderWidth, m_dwBoxWidth, m_dwBoxHeight;
-	int	m_iX, m_iY;
+	struct State
+	{
+		bool bShown, bBorderShown;
+		D3DCOLOR dwBoxColor, dwBorderColor;
+		DWORD dwBorderWidth, dwBoxWidth, dwBoxHeight;
+		int	iX, iY;
+	};
+
+	// Written by the setters, drawn once published
+	State m_pending, m_state;
 };
\ No newline at end of file
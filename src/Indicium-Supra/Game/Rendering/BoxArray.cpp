@@ -0,0 +1,18 @@
+#include "BoxArray.h"
+
+void BoxArray::draw(size_t first, size_t last, IDirect3DDevice9 *pDevice)
+{
+	for (size_t i = first; i < last; i++)
+	{
+		if (!(_flags[i] & Shown))
+			continue;
+
+		_batch.addBox(_screenX[i], _screenY[i], _screenWidth[i], _screenHeight[i], _color[i]);
+
+		// Added in the order they were drawn one by one, a draw call keeps it
+		if (_flags[i] & BorderShown)
+			_batch.addRectangular(_screenX[i], _screenY[i], _screenWidth[i], _screenHeight[i], _borderWidth[i], _borderColor[i]);
+	}
+
+	_batch.flush(pDevice);
+}
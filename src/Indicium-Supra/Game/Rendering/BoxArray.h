@@ -0,0 +1,21 @@
+#pragma once
+#include <d3dx9.h>
+
+#include "BoxColumns.h"
+#include "dx_utils.h"
+
+#include <cstddef>
+
+//
+// BoxColumns drawn with Direct3D: the boxes of a run of the draw order and
+// their borders go out as one batch of quads.
+//
+class BoxArray : public BoxColumns
+{
+public:
+	// Entries [first, last) as of the last transform, boxes and borders with one draw call
+	void draw(size_t first, size_t last, IDirect3DDevice9 *pDevice);
+
+private:
+	Drawing::QuadBatch _batch;
+};
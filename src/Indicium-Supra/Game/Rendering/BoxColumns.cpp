@@ -0,0 +1,52 @@
+#include "BoxColumns.h"
+
+void BoxColumns::clear()
+{
+	// Keeps the storage, rebuilding after an order change doesn't allocate
+	_x.clear(), _y.clear(), _width.clear(), _height.clear();
+	_color.clear(), _borderColor.clear(), _borderWidth.clear(), _flags.clear();
+}
+
+size_t BoxColumns::append()
+{
+	auto index = _x.size();
+	auto size = index + 1;
+
+	_x.resize(size), _y.resize(size), _width.resize(size), _height.resize(size);
+	_color.resize(size), _borderColor.resize(size), _borderWidth.resize(size), _flags.resize(size);
+
+	return index;
+}
+
+void BoxColumns::set(size_t index, int x, int y, uint32_t width, uint32_t height, uint32_t color, uint32_t borderColor, uint32_t borderWidth, uint8_t flags)
+{
+	_x[index] = (float)x;
+	_y[index] = (float)y;
+	_width[index] = (float)(int)width;
+	_height[index] = (float)(int)height;
+	_color[index] = color;
+	_borderColor[index] = borderColor;
+	_borderWidth[index] = (float)borderWidth;
+	_flags[index] = flags;
+}
+
+size_t BoxColumns::size() const
+{
+	return _x.size();
+}
+
+void BoxColumns::transform(float baseWidth, float baseHeight, float screenWidth, float screenHeight)
+{
+	auto count = _x.size();
+
+	_screenX.resize(count), _screenY.resize(count), _screenWidth.resize(count), _screenHeight.resize(count);
+
+	// Independent iterations over plain arrays, left for the compiler to vectorise
+	for (size_t i = 0; i < count; i++)
+	{
+		_screenX[i] = (float)(int)((_x[i] / baseWidth) * screenWidth);
+		_screenY[i] = (float)(int)((_y[i] / baseHeight) * screenHeight);
+		_screenWidth[i] = (float)(int)((_width[i] / baseWidth) * screenWidth);
+		_screenHeight[i] = (float)(int)((_height[i] / baseHeight) * screenHeight);
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//
+// The published state of every box, in draw order and one array per field,
+// so a frame scales all of them to the screen in a single pass instead of
+// going through each object. Kept apart from Direct3D so the update path also
+// builds headless; BoxArray adds drawing. Filled by the render thread only.
+//
+class BoxColumns
+{
+public:
+	enum Flags : uint8_t
+	{
+		Shown = 1 << 0,
+		BorderShown = 1 << 1
+	};
+
+	void clear();
+	// Adds an entry for set() to fill, returns its index
+	size_t append();
+	void set(size_t index, int x, int y, uint32_t width, uint32_t height, uint32_t color, uint32_t borderColor, uint32_t borderWidth, uint8_t flags);
+
+	size_t size() const;
+
+	// Screen coordinates of all entries for positions given on a baseWidth x baseHeight grid
+	void transform(float baseWidth, float baseHeight, float screenWidth, float screenHeight);
+
+protected:
+	// Positions and sizes on the client's grid
+	std::vector<float> _x, _y, _width, _height;
+	// The same on screen, truncated to whole pixels like calculatedXPos does
+	std::vector<float> _screenX, _screenY, _screenWidth, _screenHeight;
+
+	std::vector<uint32_t> _color, _borderColor;
+	std::vector<float> _borderWidth;
+	std::vector<uint8_t> _flags;
+};
@@ -3,7 +3,7 @@
 #include "dx_utils.h"
 
 Image::Image(Renderer *renderer, const std::string& file_path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow)
-	: RenderBase(renderer), m_pTexture(nullptr), m_pSprite(nullptr)
+	: RenderBase(renderer), m_pending(), m_state(), m_pTexture(nullptr), m_pSprite(nullptr)
 {
 	setFilePath(file_path);
 	setPos(x, y);
@@ -15,37 +15,46 @@ Image::Image(Renderer *renderer, const std::string& file_path, int x, int y, flo
 
 void Image::setFilePath(const std::string & path)
 {
-	m_filePath = path;
+	auto l = beginUpdate();
+	m_pending.filePath = path;
 }
 
 void Image::setPos(int x, int y)
 {
-	m_x = x, m_y = y;
+	auto l = beginUpdate();
+	m_pending.x = x, m_pending.y = y;
 }
 
 void Image::setRotation(int rotation)
 {
-	m_rotation = rotation;
+	auto l = beginUpdate();
+	m_pending.rotation = rotation;
 }
 
 void Image::setAlign(int align)
 {
-	m_align = align;
+	auto l = beginUpdate();
+	m_pending.align = align;
 }
 
 void Image::setShown(bool show)
 {
-	m_bShow = show;
+	auto l = beginUpdate();
+	m_pending.bShow = show;
 }
 
 void Image::setScale(float x, float y)
 {
-	m_scale_x = x;
-	m_scale_y = y;
+	auto l = beginUpdate();
+	m_pending.scale_x = x;
+	m_pending.scale_y = y;
 }
 
 bool Image::updateImage(const std::string& file_path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool bShow)
 {
+	// Held across the setters, so the new image isn't published with only part of it
+	auto l = beginUpdate();
+
 	setFilePath(file_path);
 	setPos(x, y);
 	setRotation(rotation);
@@ -60,23 +69,21 @@ bool Image::updateImage(const std::string& file_path, int x, int y, float scaleX
 
 void Image::draw(IDirect3DDevice9 *pDevice)
 {
-	if(!m_bShow)
+	if(!m_state.bShow)
 		return;
 
-	int x = calculatedXPos(m_x);
-	int y = calculatedYPos(m_y);
+	int x = calculatedXPos(m_state.x);
+	int y = calculatedYPos(m_state.y);
 
 	if(m_pTexture && m_pSprite)
-		Drawing::DrawSprite(m_pSprite, m_pTexture, x, y, m_scale_x, m_scale_y, m_rotation, m_align);
+		Drawing::DrawSprite(m_pSprite, m_pTexture, x, y, m_state.scale_x, m_state.scale_y, m_state.rotation, m_state.align);
 }
 
 void Image::reset(IDirect3DDevice9 *pDevice)
 {
+	// Before the device resets, the sprite comes back with the first draw after it
 	if(m_pSprite)
-	{
 		m_pSprite->OnLostDevice();
-		m_pSprite->OnResetDevice();
-	}
 }
 
 void Image::show()
@@ -123,9 +130,9 @@ bool Image::loadResource(IDirect3DDevice9 *pDevice)
 		m_pTexture = nullptr;
 	}
 
-	if (FAILED(D3DXCreateTextureFromFileA(pDevice, m_filePath.c_str(), &m_pTexture)))
+	if (FAILED(D3DXCreateTextureFromFileA(pDevice, m_state.filePath.c_str(), &m_pTexture)))
 	{
-		BOOST_LOG_TRIVIAL(error) << "Couldn't load texture from file " << m_filePath;
+		BOOST_LOG_TRIVIAL(error) << "Couldn't load texture from file " << m_state.filePath;
 		return false;
 	}
 
@@ -143,5 +150,12 @@ bool Image::loadResource(IDirect3DDevice9 *pDevice)
 
 void Image::firstDrawAfterReset(IDirect3DDevice9 *pDevice)
 {
-
+	if(m_pSprite)
+		m_pSprite->OnResetDevice();
 }
+
+
+void Image::publish()
+{
+	m_state = m_pending;
+}
\ No newline at end of file
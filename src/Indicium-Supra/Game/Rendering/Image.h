@@ -29,14 +29,19 @@ protected:
 	virtual bool loadResource(IDirect3DDevice9 *pDevice) override sealed;
 	virtual void firstDrawAfterReset(IDirect3DDevice9 *pDevice) override sealed;
 
-private:
-	std::string			m_filePath;
-
-	int	m_x, m_y, m_rotation, m_align;
+	virtual void publish() override sealed;
 
-	bool m_bShow;
-
-	float m_scale_x, m_scale_y;
+private:
+	struct State
+	{
+		std::string filePath;
+		int	x, y, rotation, align;
+		bool bShow;
+		float scale_x, scale_y;
+	};
+
+	// Written by the setters, drawn once published
+	State m_pending, m_state;
 
 	LPDIRECT3DTEXTURE9 m_pTexture;
 	LPD3DXSPRITE m_pSprite;
@@ -1,7 +1,7 @@
 #include "Line.h"
 
 Line::Line(Renderer *renderer, int x1,int y1,int x2,int y2,int width,D3DCOLOR color, bool bShow)
-	: RenderBase(renderer), m_Line(NULL)
+	: RenderBase(renderer), m_pending(), m_state(), m_Line(NULL)
 {
 	setPos(x1,y1,x2,y2);
 	setWidth(width);
@@ -11,53 +11,55 @@ Line::Line(Renderer *renderer, int x1,int y1,int x2,int y2,int width,D3DCOLOR co
 
 void Line::setPos(int x1,int y1,int x2,int y2)
 {
-	m_X1 = x1, m_X2 = x2;
-	m_Y1 = y1, m_Y2 = y2;
+	auto l = beginUpdate();
+	m_pending.X1 = x1, m_pending.X2 = x2;
+	m_pending.Y1 = y1, m_pending.Y2 = y2;
 }
 
 void Line::setWidth(int width)
 {
-	m_Width = width;
+	auto l = beginUpdate();
+	m_pending.Width = width;
 }
 
 void Line::setColor(D3DCOLOR color)
 {
-	m_Color = color;
+	auto l = beginUpdate();
+	m_pending.Color = color;
 }
 
 void Line::setShown(bool show)
 {
-	m_bShow = show;
+	auto l = beginUpdate();
+	m_pending.bShow = show;
 }
 
 void Line::draw(IDirect3DDevice9 *pDevice)
 {
-	if(!m_bShow || m_Line == NULL)
+	if(!m_state.bShow || m_Line == NULL)
 		return;
 
 	D3DXVECTOR2	LinePos[2];
 
 	m_Line->SetAntialias(TRUE);
-	m_Line->SetWidth((FLOAT)m_Width);
+	m_Line->SetWidth((FLOAT)m_state.Width);
 
 	m_Line->Begin();
 
-	LinePos[0].x = (float)calculatedXPos(m_X1);
-	LinePos[0].y = (float)calculatedYPos(m_Y1);
-	LinePos[1].x = (float)calculatedXPos(m_X2);
-	LinePos[1].y = (float)calculatedYPos(m_Y2);
+	LinePos[0].x = (float)calculatedXPos(m_state.X1);
+	LinePos[0].y = (float)calculatedYPos(m_state.Y1);
+	LinePos[1].x = (float)calculatedXPos(m_state.X2);
+	LinePos[1].y = (float)calculatedYPos(m_state.Y2);
 
-	m_Line->Draw(LinePos,2,m_Color);
+	m_Line->Draw(LinePos,2,m_state.Color);
 	m_Line->End();	
 }
 
 void Line::reset(IDirect3DDevice9 *pDevice)
 {
+	// Before the device resets, the line comes back with the first draw after it
 	if(m_Line)
-	{
 		m_Line->OnLostDevice();
-		m_Line->OnResetDevice();
-	}
 }
 
 void Line::show()
@@ -99,5 +101,11 @@ bool Line::loadResource(IDirect3DDevice9 *pDevice)
 
 void Line::firstDrawAfterReset(IDirect3DDevice9 *pDevice)
 {
+	if(m_Line)
+		m_Line->OnResetDevice();
+}
 
+void Line::publish()
+{
+	m_state = m_pending;
 }
\ No newline at end of file
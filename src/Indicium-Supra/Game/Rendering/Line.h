@@ -26,12 +26,18 @@ protected:
 	virtual bool loadResource(IDirect3DDevice9 *pDevice) override sealed;
 	virtual void firstDrawAfterReset(IDirect3DDevice9 *pDevice) override sealed;
 
-private:
-	int	m_X1, m_X2, m_Y1, m_Y2, m_Width;
-
-	bool m_bShow;
+	virtual void publish() override sealed;
 
-	D3DCOLOR m_Color;
+private:
+	struct State
+	{
+		int	X1, X2, Y1, Y2, Width;
+		bool bShow;
+		D3DCOLOR Color;
+	};
+
+	// Written by the setters, drawn once published
+	State m_pending, m_state;
 
 	LPD3DXLINE m_Line;
 };
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "RenderBase.h"
 
-int RenderBase::xCalculator = 800;
-int RenderBase::yCalculator = 600;
+std::atomic<int> RenderBase::xCalculator(800);
+std::atomic<int> RenderBase::yCalculator(600);
 
 RenderBase::RenderBase(Renderer *renderer)
 	: _renderer(renderer), _isMarkedForDeletion(false), _resourceChanged(false), _hasToBeInitialised(true), _firstDrawAfterReset(false)
@@ -14,7 +14,7 @@ RenderBase::~RenderBase()
 
 void RenderBase::setPriority(int p)
 {
-	_priority = p;
+	_renderer->setPriority(this, p);
 }
 
 int RenderBase::priority()
@@ -22,9 +22,38 @@ int RenderBase::priority()
 	return _priority;
 }
 
+std::unique_lock<std::recursive_mutex> RenderBase::beginUpdate()
+{
+	return _renderer->update(this);
+}
+
+void RenderBase::draw(IDirect3DDevice9 *pDevice)
+{
+}
+
+bool RenderBase::drawnAsBox() const
+{
+	return false;
+}
+
+void RenderBase::storeBox(BoxArray& boxes, size_t index)
+{
+}
+
 void RenderBase::changeResource()
 {
-	_resourceChanged = true;
+	_resourceChangePending = true;
+}
+
+void RenderBase::publishState()
+{
+	publish();
+
+	if (_resourceChangePending)
+	{
+		_resourceChanged = true;
+		_resourceChangePending = false;
+	}
 }
 
 int RenderBase::calculatedXPos(int x)
@@ -5,8 +5,8 @@ class RenderBase
 {
 	friend class Renderer;
 public:
-	static int xCalculator;
-	static int yCalculator;
+	static std::atomic<int> xCalculator;
+	static std::atomic<int> yCalculator;
 
 	RenderBase(Renderer *render);
 	virtual ~RenderBase(void);
@@ -15,7 +15,8 @@ public:
 	int priority();
 
 protected:
-	virtual void draw(IDirect3DDevice9 *pDevice)  = 0;
+	// Not called for objects drawnAsBox, which have no use for it
+	virtual void draw(IDirect3DDevice9 *pDevice);
 	virtual void reset(IDirect3DDevice9 *pDevice) = 0;
 
 	virtual void show() = 0;
@@ -29,6 +30,16 @@ protected:
 
 	virtual void firstDrawAfterReset(IDirect3DDevice9 *pDevice) = 0;
 
+	// Setters change the pending state while holding this, draw only sees it once published
+	std::unique_lock<std::recursive_mutex> beginUpdate();
+	// Copies the pending state over the one draw uses, on the render thread with the render mutex held
+	virtual void publish() = 0;
+
+	// Objects drawn through the renderer's BoxArray instead of draw() write their published state to entry index
+	virtual bool drawnAsBox() const;
+	virtual void storeBox(BoxArray& boxes, size_t index);
+
+	// Reloads resources once the pending state is published, call within an update
 	void changeResource();
 
 	int calculatedXPos(int x);
@@ -37,9 +48,21 @@ protected:
 	Renderer *renderer();
 
 private:
-	bool _hasToBeInitialised, _isMarkedForDeletion, _resourceChanged, _firstDrawAfterReset;
+	void publishState();
+
+	// Render thread only
+	bool _hasToBeInitialised, _resourceChanged, _firstDrawAfterReset;
+	size_t _boxIndex = 0;
+
+	// Under the render mutex
+	bool _isMarkedForDeletion, _resourceChangePending = false, _updateQueued = false;
 
 	int _priority = 0;
+	// Creation order among objects of equal priority, 0 while not in the renderer's draw order
+	uint64_t _order = 0;
+
+	// Session that created the object, it is destroyed when that client goes away
+	SessionId _owner = NoSession;
 
 	Renderer *_renderer;
 };
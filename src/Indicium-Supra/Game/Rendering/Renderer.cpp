@@ -1,31 +1,67 @@
-#include <Utils/algorithm.h>
 #include <algorithm>
 
 #include "Renderer.h"
 #include "RenderBase.h"
+#include "dx_utils.h"
+
+#include <Shared/Config.h>
 
 #include <boost/range/algorithm.hpp>
 #include <boost/date_time.hpp>
 
 Renderer::RenderObjects	Renderer::_renderObjects;
+std::vector<RenderBase *> Renderer::_drawOrder;
+bool Renderer::_drawOrderChanged = false;
+uint64_t Renderer::_nextOrder = 0;
+std::vector<RenderBase *> Renderer::_updated;
+std::vector<Renderer::DrawStep> Renderer::_drawList;
+BoxArray Renderer::_boxes;
 std::recursive_mutex Renderer::_mtx;
 
+Renderer::Renderer()
+	: _frameRate(0), _width(0), _height(0)
+{
+}
+
 int Renderer::add(SharedRenderObject Object)
 {
 	std::lock_guard<std::recursive_mutex> l(_mtx);
 
-	int id = 0;
+	Object->_owner = currentSession();
 
-	if(!_renderObjects.empty())
-		for(;;id++)
-			if(_renderObjects.find(id) == _renderObjects.end())
-				break;
-	
-	_renderObjects[id] = Object;
+	int id = _renderObjects.insert(Object);
+	if (id >= 0)
+		insertOrdered(Object.get());
 
 	return id;
 }
 
+int Renderer::reserve(int count)
+{
+	std::lock_guard<std::recursive_mutex> l(_mtx);
+
+	// Held for the session until it uses them or goes away, so one without an end can't hold any
+	auto session = currentSession();
+	if (session == NoSession || count <= 0 || count > g_iMaxReservedHandles - static_cast<int>(_renderObjects.reserved(session)))
+		return -1;
+
+	return _renderObjects.reserve(count, session);
+}
+
+bool Renderer::addAt(int id, SharedRenderObject Object)
+{
+	std::lock_guard<std::recursive_mutex> l(_mtx);
+
+	// Only ids from an earlier reserve that aren't in use
+	Object->_owner = currentSession();
+
+	if (!_renderObjects.insertAt(id, Object))
+		return false;
+
+	insertOrdered(Object.get());
+	return true;
+}
+
 bool Renderer::remove(int id)
 {
 	std::lock_guard<std::recursive_mutex> l(_mtx);
@@ -39,22 +75,161 @@ bool Renderer::remove(int id)
 
 std::shared_ptr<RenderBase> Renderer::get(int id)
 {
-	if (_renderObjects.empty())
-		return nullptr;
-
-	if (_renderObjects.find(id) == _renderObjects.end())
-		return nullptr;
+	std::lock_guard<std::recursive_mutex> l(_mtx);
 
-	if (_renderObjects[id]->_isMarkedForDeletion)
+	auto obj = _renderObjects.find(id);
+	if (!obj || (*obj)->_isMarkedForDeletion)
 		return nullptr;
 
-	return _renderObjects[id];
+	return *obj;
 }
 
-void Renderer::draw(IDirect3DDevice9 *pDevice)
+void Renderer::setPriority(RenderBase *obj, int priority)
 {
 	std::lock_guard<std::recursive_mutex> l(_mtx);
 
+	// A deleted object must not get back into the draw order, draw() would walk it after it is gone
+	if (obj->_isMarkedForDeletion || obj->_priority == priority)
+		return;
+
+	// Not added yet, it is put in place once it is
+	if (!obj->_order)
+	{
+		obj->_priority = priority;
+		return;
+	}
+
+	removeOrdered(obj);
+	obj->_priority = priority;
+	obj->_order = 0;
+	insertOrdered(obj);
+}
+
+bool Renderer::drawsBefore(const RenderBase *first, const RenderBase *second)
+{
+	if (first->_priority != second->_priority)
+		return first->_priority < second->_priority;
+
+	return first->_order < second->_order;
+}
+
+void Renderer::insertOrdered(RenderBase *obj)
+{
+	// Drawn after, so on top of, everything of equal priority already there
+	if (!obj->_order)
+		obj->_order = ++_nextOrder;
+
+	_drawOrder.insert(std::upper_bound(_drawOrder.begin(), _drawOrder.end(), obj, drawsBefore), obj);
+	_drawOrderChanged = true;
+
+	// A new object's first state goes out with the order that contains it
+	if (!obj->_updateQueued)
+	{
+		obj->_updateQueued = true;
+		_updated.push_back(obj);
+	}
+}
+
+void Renderer::removeOrdered(RenderBase *obj)
+{
+	auto it = std::lower_bound(_drawOrder.begin(), _drawOrder.end(), obj, drawsBefore);
+	if (it != _drawOrder.end() && *it == obj)
+	{
+		_drawOrder.erase(it);
+		_drawOrderChanged = true;
+	}
+}
+
+std::unique_lock<std::recursive_mutex> Renderer::update(RenderBase *obj)
+{
+	std::unique_lock<std::recursive_mutex> l(_mtx);
+
+	// Objects not added yet go out whole once they are. A setter may come after its object was
+	// marked or even erased, handlers drop the lock between lookup and set; that change is moot
+	if (obj->_order && !obj->_updateQueued && !obj->_isMarkedForDeletion)
+	{
+		obj->_updateQueued = true;
+		_updated.push_back(obj);
+	}
+
+	return l;
+}
+
+void Renderer::publish(IDirect3DDevice9 *pDevice)
+{
+	for (auto obj : _updated)
+	{
+		obj->publishState();
+		obj->_updateQueued = false;
+	}
+
+	// New objects have no entry yet, the rebuild below stores them
+	if (!_drawOrderChanged)
+	{
+		for (auto obj : _updated)
+		if (obj->drawnAsBox())
+			obj->storeBox(_boxes, obj->_boxIndex);
+	}
+
+	_updated.clear();
+
+	// Delete all objects which are marked for deletion, their ids go stale
+	_renderObjects.eraseIf([&](SharedRenderObject& obj) -> bool
+	{
+		if(obj->_isMarkedForDeletion)
+		{
+			obj->releaseResourcesForDeletion(pDevice);
+			if (!obj->canBeDeleted())
+				return false;
+
+			removeOrdered(obj.get());
+			// Handlers may still hold it, update() must not queue it again
+			obj->_order = 0;
+			return true;
+		}
+
+		return false;
+	});
+
+	if (_drawOrderChanged)
+	{
+		rebuildDrawList();
+		_drawOrderChanged = false;
+	}
+}
+
+void Renderer::rebuildDrawList()
+{
+	// Reuses the storage of both, a steady scene costs no allocation
+	_drawList.clear();
+	_boxes.clear();
+
+	for (auto obj : _drawOrder)
+	{
+		if (!obj->drawnAsBox())
+		{
+			DrawStep step = { obj, 0, 0 };
+			_drawList.push_back(step);
+			continue;
+		}
+
+		obj->_boxIndex = _boxes.append();
+		obj->storeBox(_boxes, obj->_boxIndex);
+
+		// Boxes next to each other in draw order go out together
+		if (!_drawList.empty() && !_drawList.back().obj)
+		{
+			_drawList.back().last++;
+			continue;
+		}
+
+		DrawStep step = { nullptr, obj->_boxIndex, obj->_boxIndex + 1 };
+		_drawList.push_back(step);
+	}
+}
+
+void Renderer::draw(IDirect3DDevice9 *pDevice)
+{
 	// Read frame rate
 	{
 		static DWORD dwFrames = 0;
@@ -84,35 +259,34 @@ void Renderer::draw(IDirect3DDevice9 *pDevice)
 		_height = viewPort.Height;
 	}
 
-	if(_renderObjects.empty())
-		return;
-
-	// Delete all objects from the map which are marked for deletion
-	erase_if(_renderObjects, [&](int id, SharedRenderObject obj) -> bool 
+	// A client holding the scene doesn't stall the frame, its changes come with a later one
 	{
-		if(obj->_isMarkedForDeletion)
+		std::unique_lock<std::recursive_mutex> l(_mtx, std::try_to_lock);
+		if (l.owns_lock())
 		{
-			obj->releaseResourcesForDeletion(pDevice);
-			return obj->canBeDeleted();
+			if (_frameCallback)
+				_frameCallback();
+
+			publish(pDevice);
 		}
+	}
 
-		return false;
-	});
+	_boxes.transform((float)RenderBase::xCalculator, (float)RenderBase::yCalculator, (float)_width, (float)_height);
 
+	// Box runs set what they need themselves, the game gets its state back once after the frame
+	Drawing::SavedState state(pDevice);
 
-	// Push all render objects in a vector which will be sorted later
-	std::vector<SharedRenderObject> sortedObjects;
-	for (auto it = _renderObjects.begin(); it != _renderObjects.end(); it++)
-		sortedObjects.push_back(it->second);
+	// Process render objects by priority
+	for (auto& step : _drawList)
+	{
+		if (!step.obj)
+		{
+			_boxes.draw(step.first, step.last, pDevice);
+			continue;
+		}
 
-	// Sort render objects by priority
-	std::sort(sortedObjects.begin(), sortedObjects.end(), [](SharedRenderObject& i, SharedRenderObject& j){
-		return i->priority() < j->priority();
-	});
+		auto i = step.obj;
 
-	// Process sorted render objects
-	for (auto& i : sortedObjects)
-	{
 		if(i->_hasToBeInitialised)
 		{
 			if(!i->loadResource(pDevice))
@@ -140,6 +314,13 @@ void Renderer::draw(IDirect3DDevice9 *pDevice)
 	}
 }
 
+void Renderer::setFrameCallback(std::function<void()> callback)
+{
+	std::lock_guard<std::recursive_mutex> l(_mtx);
+
+	_frameCallback = callback;
+}
+
 void Renderer::reset(IDirect3DDevice9 *pDevice)
 {
 	std::lock_guard<std::recursive_mutex> l(_mtx);
@@ -149,12 +330,12 @@ void Renderer::reset(IDirect3DDevice9 *pDevice)
 	
 	for(auto it = _renderObjects.begin(); it != _renderObjects.end(); it ++)
 	{
-		it->second->reset(pDevice);
-		it->second->_firstDrawAfterReset = true;
+		(*it)->reset(pDevice);
+		(*it)->_firstDrawAfterReset = true;
 	}
 }
 
-void Renderer::showAll()
+void Renderer::showAll(SessionId owner)
 {
 	std::lock_guard<std::recursive_mutex> l(_mtx);
 
@@ -163,14 +344,14 @@ void Renderer::showAll()
 
 	for(auto it = _renderObjects.begin(); it != _renderObjects.end();it ++)
 	{
-		if(it->second->_isMarkedForDeletion)
+		if((*it)->_isMarkedForDeletion || (*it)->_owner != owner)
 			continue;
 
-		it->second->show();
+		(*it)->show();
 	}
 }
 
-void Renderer::hideAll()
+void Renderer::hideAll(SessionId owner)
 {
 	std::lock_guard<std::recursive_mutex> l(_mtx);
 
@@ -179,22 +360,23 @@ void Renderer::hideAll()
 
 	for(auto it = _renderObjects.begin(); it != _renderObjects.end();it ++)
 	{
-		if(it->second->_isMarkedForDeletion)
+		if((*it)->_isMarkedForDeletion || (*it)->_owner != owner)
 			continue;
 
-		it->second->hide();
+		(*it)->hide();
 	}
 }
 
-void Renderer::destroyAll()
+void Renderer::destroyAll(SessionId owner)
 {
 	std::lock_guard<std::recursive_mutex> l(_mtx);
 
-	if(_renderObjects.empty())
-		return;
-
+	// Marked objects are released and dropped by the next draw
 	for(auto it = _renderObjects.begin(); it != _renderObjects.end(); it ++)
-		it->second->_isMarkedForDeletion = true;
+	if((*it)->_owner == owner)
+		(*it)->_isMarkedForDeletion = true;
+
+	_renderObjects.releaseReserved(owner);
 }
 
 int Renderer::frameRate() const
@@ -1,40 +1,57 @@
 #pragma once
 #include <d3dx9.h>
 
+#include <Utils/Session.h>
+#include <Utils/SlotMap.h>
+
+#include "BoxArray.h"
+
+#include <atomic>
+#include <cstdint>
 #include <memory>
-#include <map>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 class RenderBase;
 
+//
+// The objects and their order form the scene, which clients change through
+// the render mutex. draw doesn't wait for it: it only publishes the changes
+// made since the last frame when it gets the mutex right away, and otherwise
+// draws the last published state again. Changes made under one hold of the
+// mutex (a batch, a transaction) are therefore seen together.
+//
 class Renderer
 {
+	friend class RenderBase;
+
 	typedef std::shared_ptr<RenderBase> SharedRenderObject;
-	typedef std::map<int, SharedRenderObject> RenderObjects;
+	// Ids are generational handles, one kept by a client after destroy never reaches a newer object
+	typedef SlotMap<SharedRenderObject> RenderObjects;
 
 public:
+	Renderer();
+
 	int add(SharedRenderObject Object);
 
+	// Hands out count consecutive ids for addAt, returns the first or -1 (also past the session's g_iMaxReservedHandles)
+	int reserve(int count);
+	bool addAt(int id, SharedRenderObject Object);
+
 	bool remove(int id);
 
 	template<typename T> 
 	std::shared_ptr<T> getAs(int id)
 	{
-		if(_renderObjects.empty())
-			return nullptr;
-
-		if(_renderObjects.find(id) == _renderObjects.end())
-			return nullptr;
-
-		if(_renderObjects[id]->_isMarkedForDeletion)
-			return nullptr;
-
-		return std::dynamic_pointer_cast<T, RenderBase>(_renderObjects[id]);
+		return std::dynamic_pointer_cast<T, RenderBase>(get(id));
 	}
 
 	std::shared_ptr<RenderBase> get(int id);
 
+	// Moves the object to its place among the others, objects of equal priority keep their creation order
+	void setPriority(RenderBase *obj, int priority);
+
 	template<typename T> 
 	void execute(int id, std::function<void(std::shared_ptr<T>)> successor = nullptr, std::function<void()> error = nullptr)
 	{
@@ -47,11 +64,16 @@ public:
 	}
 
 	void draw(IDirect3DDevice9 *pDevice);
+	// Before the device is reset, objects restore what they need on their next draw
 	void reset(IDirect3DDevice9 *pDevice);
 
-	void showAll();
-	void hideAll();
-	void destroyAll();
+	// Called at the start of every draw that publishes, with the render mutex held
+	void setFrameCallback(std::function<void()> callback);
+
+	// Only touch the objects created by owner
+	void showAll(SessionId owner);
+	void hideAll(SessionId owner);
+	void destroyAll(SessionId owner);
 
 	int frameRate() const;
 
@@ -61,9 +83,38 @@ public:
 	std::recursive_mutex& renderMutex();
 
 private:
-	int _frameRate, _width, _height;
+	static bool drawsBefore(const RenderBase *first, const RenderBase *second);
+	void insertOrdered(RenderBase *obj);
+	void removeOrdered(RenderBase *obj);
+
+	// Locks the scene for a change to obj, which is then published with the next frame
+	std::unique_lock<std::recursive_mutex> update(RenderBase *obj);
+	// Render thread with the render mutex held
+	void publish(IDirect3DDevice9 *pDevice);
+	void rebuildDrawList();
+
+	std::atomic<int> _frameRate, _width, _height;
+
+	std::function<void()> _frameCallback;
 
 	static RenderObjects _renderObjects;
+	// Objects by priority, only changed on add, setPriority and deletion; published to _drawList
+	static std::vector<RenderBase *> _drawOrder;
+	static bool _drawOrderChanged;
+	static uint64_t _nextOrder;
+	// Objects changed since the last publish
+	static std::vector<RenderBase *> _updated;
+
+	// One object drawn on its own, or when null, a run of consecutive entries of _boxes
+	struct DrawStep
+	{
+		RenderBase *obj;
+		size_t first, last;
+	};
+
+	// What draw goes through, only touched by the render thread; objects leave the scene during publish, so none is gone while drawn
+	static std::vector<DrawStep> _drawList;
+	static BoxArray _boxes;
 	static std::recursive_mutex _mtx;
 };
 
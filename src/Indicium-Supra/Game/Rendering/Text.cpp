@@ -4,7 +4,7 @@
 #include "dx_utils.h"
 
 Text::Text(Renderer *renderer, const std::string& font,int iFontSize,bool Bold,bool Italic,int x,int y,D3DCOLOR color,const std::string& text, bool bShadow, bool bShow)
-	: RenderBase(renderer), m_2DFont(nullptr)
+	: RenderBase(renderer), m_pending(), m_state(), m_2DFont(nullptr)
 {
 	setPos(x,y);
 	setColor(color);
@@ -12,19 +12,20 @@ Text::Text(Renderer *renderer, const std::string& font,int iFontSize,bool Bold,b
 	setShadow(bShadow);
 	setShown(bShow);
 
-	m_Font = font;
-	m_FontSize = iFontSize;
-	m_bBold = Bold;
-	m_bItalic = Italic;
+	m_pending.Font = font;
+	m_pending.FontSize = iFontSize;
+	m_pending.bBold = Bold;
+	m_pending.bItalic = Italic;
 }
 
 
 bool Text::updateText(const std::string& Font,int FontSize,bool Bold,bool Italic)
 {
-	m_Font = Font;
-	m_FontSize = FontSize;
-	m_bBold = Bold;
-	m_bItalic = Italic;
+	auto l = beginUpdate();
+	m_pending.Font = Font;
+	m_pending.FontSize = FontSize;
+	m_pending.bBold = Bold;
+	m_pending.bItalic = Italic;
 
 	changeResource();
 	return true;
@@ -32,48 +33,53 @@ bool Text::updateText(const std::string& Font,int FontSize,bool Bold,bool Italic
 
 void Text::setText(const std::string& str)
 {
-	m_Text = str;
+	auto l = beginUpdate();
+	m_pending.Text = str;
 }
 
 void Text::setColor(D3DCOLOR color)
 {
-	m_Color = color;
+	auto l = beginUpdate();
+	m_pending.Color = color;
 }
 
 void Text::setPos(int x,int y)
 {
-	m_X = x, m_Y = y;
+	auto l = beginUpdate();
+	m_pending.X = x, m_pending.Y = y;
 }
 
 void Text::setShown(bool bShown)
 {
-	m_bShown = bShown;
+	auto l = beginUpdate();
+	m_pending.bShown = bShown;
 }
 
 void Text::setShadow(bool bShadow)
 {
-	m_bShadow = bShadow;
+	auto l = beginUpdate();
+	m_pending.bShadow = bShadow;
 }
 
 void Text::draw(IDirect3DDevice9 *pDevice)
 {
-	if(!m_bShown)
+	if(!m_state.bShown)
 		return;
 
-	int x = calculatedXPos(m_X);
-	int y = calculatedYPos(m_Y);
+	int x = calculatedXPos(m_state.X);
+	int y = calculatedYPos(m_state.Y);
 
-	if(m_bShadow)
+	if(m_state.bShadow)
 	{
 		const int shadowOffset = 1;
 
-		drawText(x - shadowOffset, y, D3DCOLOR_ARGB(255, 0, 0, 0), m_Text);
-		drawText(x + shadowOffset, y, D3DCOLOR_ARGB(255, 0, 0, 0), m_Text);
-		drawText(x, y - shadowOffset, D3DCOLOR_ARGB(255, 0, 0, 0), m_Text);
-		drawText(x, y + shadowOffset, D3DCOLOR_ARGB(255, 0, 0, 0), m_Text);
+		drawText(x - shadowOffset, y, D3DCOLOR_ARGB(255, 0, 0, 0), m_state.Text);
+		drawText(x + shadowOffset, y, D3DCOLOR_ARGB(255, 0, 0, 0), m_state.Text);
+		drawText(x, y - shadowOffset, D3DCOLOR_ARGB(255, 0, 0, 0), m_state.Text);
+		drawText(x, y + shadowOffset, D3DCOLOR_ARGB(255, 0, 0, 0), m_state.Text);
 	}
 
-	drawText(x, y, m_Color, m_Text, D3DFONT_COLORTABLE);
+	drawText(x, y, m_state.Color, m_state.Text, D3DFONT_COLORTABLE);
 }
 
 void Text::reset(IDirect3DDevice9 *pDevice)
@@ -114,10 +120,10 @@ void Text::firstDrawAfterReset(IDirect3DDevice9 *pDevice)
 
 void Text::initFont(IDirect3DDevice9 *pDevice)
 {
-	int size = calculatedYPos(m_FontSize);
+	int size = calculatedYPos(m_state.FontSize);
 
 	m_2DFont = std::make_shared<C2DFont>();
-	m_2DFont->Initialize(pDevice, m_Font.c_str(), size, m_bBold, m_bItalic);
+	m_2DFont->Initialize(pDevice, m_state.Font.c_str(), size, m_state.bBold, m_state.bItalic);
 }
 
 void Text::resetFont()
@@ -128,6 +134,11 @@ void Text::resetFont()
 bool Text::drawText(int x, int y, DWORD dwColor, const std::string& strText, DWORD dwFlags /*= 0L*/)
 {
 	return safeExecuteWithValidation([&](){
-		m_2DFont->Print(m_Text.c_str(), x, y, dwColor);
+		m_2DFont->Print(strText.c_str(), x, y, dwColor);
 	});
 }
+
+void Text::publish()
+{
+	m_state = m_pending;
+}
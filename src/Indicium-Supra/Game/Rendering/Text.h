@@ -32,12 +32,21 @@ protected:
 	virtual bool loadResource(IDirect3DDevice9 *pDevice) override sealed;
 	virtual void firstDrawAfterReset(IDirect3DDevice9 *pDevice) override sealed;
 
+	virtual void publish() override sealed;
+
 private:
-	std::string	m_Text, m_Font;
-	int	m_X, m_Y, m_FontSize;
-	D3DCOLOR m_Color;
+	struct State
+	{
+		std::string	Text, Font;
+		int	X, Y, FontSize;
+		D3DCOLOR Color;
+		bool bShown, bShadow, bItalic, bBold;
+	};
+
+	// Written by the setters, drawn once published
+	State m_pending, m_state;
+
 	std::shared_ptr<C2DFont> m_2DFont;
-	bool m_bShown, m_bShadow, m_bItalic, m_bBold;
 
 	void initFont(IDirect3DDevice9 *pDevice);
 	void resetFont();
@@ -1,8 +1,35 @@
 #include "dx_utils.h"
 #include <math.h>
 
-void Drawing::DrawBox(float x, float y, float w, float h, DWORD color, LPDIRECT3DDEVICE9 pDevice)
+void Drawing::DrawSprite(LPD3DXSPRITE SpriteInterface, LPDIRECT3DTEXTURE9 TextureInterface, int PosX, int PosY, float ScaleX, float ScaleY, int Rotation, int Align)
+{
+	if (SpriteInterface == NULL || TextureInterface == NULL)
+		return;
+
+	D3DXMATRIX mat;
+	D3DXVECTOR2 scaling(ScaleX, ScaleY);
+	D3DSURFACE_DESC desc;
+
+	TextureInterface->GetLevelDesc(0, &desc);
+
+	D3DXVECTOR2 spriteCentre;
+	if (Align == 1)
+		spriteCentre = D3DXVECTOR2((FLOAT) desc.Width / 2, (FLOAT) desc.Height / 2);
+	else
+		spriteCentre = D3DXVECTOR2(0, 0);
+
+	D3DXVECTOR2 trans = D3DXVECTOR2((FLOAT)PosX, (FLOAT)PosY);
+	D3DXMatrixTransformation2D(&mat, NULL, 0.0, &scaling, &spriteCentre, (FLOAT)((Rotation * acos(-1.0)) / 180), &trans);
+
+	SpriteInterface->SetTransform(&mat);
+	SpriteInterface->Begin(D3DXSPRITE_ALPHABLEND);
+	SpriteInterface->Draw(TextureInterface, nullptr, nullptr, nullptr, 0xFFFFFFFF);
+	SpriteInterface->End();
+}
+
+void Drawing::QuadBatch::addBox(float x, float y, float w, float h, D3DCOLOR color)
 {
+	// Corners in strip order: top left, top right, bottom left, bottom right
 	stVertex q[4];
 
 	q[0].dwColor = q[1].dwColor = q[2].dwColor = q[3].dwColor = color;
@@ -15,60 +42,64 @@ void Drawing::DrawBox(float x, float y, float w, float h, DWORD color, LPDIRECT3
 	q[1].fX = q[3].fX = x + w;
 	q[2].fY = q[3].fY = y + h;
 
-	Drawing::DrawPrimtive(pDevice, D3DPT_TRIANGLESTRIP, 2, q, sizeof(stVertex));
+	_vertices.insert(_vertices.end(), q, q + 4);
 }
 
-void Drawing::DrawRectangular(float X, float Y, float Width, float Height, float Thickness, D3DCOLOR Color, LPDIRECT3DDEVICE9 pDev)
+void Drawing::QuadBatch::addRectangular(float X, float Y, float Width, float Height, float Thickness, D3DCOLOR Color)
 {
-	Drawing::DrawBox(X, Y + Height - Thickness, Width, Thickness, Color, pDev);
-	Drawing::DrawBox(X, Y, Thickness, Height, Color, pDev);
-	Drawing::DrawBox(X, Y, Width, Thickness, Color, pDev);
-	Drawing::DrawBox(X + Width - Thickness, Y, Thickness, Height, Color, pDev);
+	addBox(X, Y + Height - Thickness, Width, Thickness, Color);
+	addBox(X, Y, Thickness, Height, Color);
+	addBox(X, Y, Width, Thickness, Color);
+	addBox(X + Width - Thickness, Y, Thickness, Height, Color);
 }
 
-void Drawing::DrawPrimtive(LPDIRECT3DDEVICE9 pDevice, D3DPRIMITIVETYPE PrimitiveType, UINT PrimitiveCount, CONST void* pVertexStreamZeroData, UINT VertexStreamZeroStride, DWORD FVF)
+void Drawing::QuadBatch::flush(LPDIRECT3DDEVICE9 pDevice)
 {
-	DWORD dwOldFVF;
-	LPDIRECT3DPIXELSHADER9 ppixelShader;
-	LPDIRECT3DBASETEXTURE9 ppTexture;
+	if (_vertices.empty())
+		return;
+
+	size_t quads = _vertices.size() / 4;
 
-	pDevice->GetFVF(&dwOldFVF);
-	pDevice->GetPixelShader(&ppixelShader);
-	pDevice->GetTexture(0, &ppTexture);
+	// Two triangles per quad, wound as the strip of its corners would be
+	static const WORD corners[] = { 0, 1, 2, 2, 1, 3 };
+
+	for (size_t i = _indices.size() / 6; i < quads && i < MaxQuads; i++)
+	for (auto corner : corners)
+		_indices.push_back(static_cast<WORD>(i * 4 + corner));
 
 	pDevice->SetPixelShader(NULL);
 	pDevice->SetTexture(0, NULL);
-	pDevice->SetFVF(FVF);
+	pDevice->SetFVF(QUAD_FVF);
+
+	for (size_t first = 0; first < quads; first += MaxQuads)
+	{
+		auto count = min(quads - first, static_cast<size_t>(MaxQuads));
 
-	pDevice->DrawPrimitiveUP(PrimitiveType, PrimitiveCount, pVertexStreamZeroData, VertexStreamZeroStride);
+		pDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, static_cast<UINT>(count * 4), static_cast<UINT>(count * 2),
+			_indices.data(), D3DFMT_INDEX16, &_vertices[first * 4], sizeof(stVertex));
+	}
 
-	pDevice->SetPixelShader(ppixelShader);
-	pDevice->SetTexture(0, ppTexture);
-	pDevice->SetFVF(dwOldFVF);
+	_vertices.clear();
 }
 
-void Drawing::DrawSprite(LPD3DXSPRITE SpriteInterface, LPDIRECT3DTEXTURE9 TextureInterface, int PosX, int PosY, float ScaleX, float ScaleY, int Rotation, int Align)
+Drawing::SavedState::SavedState(LPDIRECT3DDEVICE9 pDevice)
+	: _pDevice(pDevice), _pPixelShader(NULL), _pTexture(NULL)
 {
-	if (SpriteInterface == NULL || TextureInterface == NULL)
-		return;
-
-	D3DXMATRIX mat;
-	D3DXVECTOR2 scaling(ScaleX, ScaleY);
-	D3DSURFACE_DESC desc;
-
-	TextureInterface->GetLevelDesc(0, &desc);
+	_pDevice->GetFVF(&_dwFVF);
+	_pDevice->GetPixelShader(&_pPixelShader);
+	_pDevice->GetTexture(0, &_pTexture);
+}
 
-	D3DXVECTOR2 spriteCentre;
-	if (Align == 1)
-		spriteCentre = D3DXVECTOR2((FLOAT) desc.Width / 2, (FLOAT) desc.Height / 2);
-	else
-		spriteCentre = D3DXVECTOR2(0, 0);
+Drawing::SavedState::~SavedState()
+{
+	_pDevice->SetPixelShader(_pPixelShader);
+	_pDevice->SetTexture(0, _pTexture);
+	_pDevice->SetFVF(_dwFVF);
 
-	D3DXVECTOR2 trans = D3DXVECTOR2((FLOAT)PosX, (FLOAT)PosY);
-	D3DXMatrixTransformation2D(&mat, NULL, 0.0, &scaling, &spriteCentre, (FLOAT)((Rotation * acos(-1.0)) / 180), &trans);
+	// The getters added a reference each
+	if (_pPixelShader)
+		_pPixelShader->Release();
 
-	SpriteInterface->SetTransform(&mat);
-	SpriteInterface->Begin(D3DXSPRITE_ALPHABLEND);
-	SpriteInterface->Draw(TextureInterface, nullptr, nullptr, nullptr, 0xFFFFFFFF);
-	SpriteInterface->End();
+	if (_pTexture)
+		_pTexture->Release();
 }
@@ -1,7 +1,9 @@
 #pragma once
 #include <d3dx9.h>
 
-#define DRAW_FVF (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
+#include <vector>
+
+#define QUAD_FVF (D3DFVF_XYZRHW | D3DFVF_DIFFUSE)
 
 class CD3DFont;
 
@@ -13,9 +15,41 @@ namespace Drawing
 		D3DCOLOR dwColor;
 	};
 
-	void DrawBox(float x, float y, float w, float h, DWORD color, LPDIRECT3DDEVICE9 pDevice);
-	void DrawRectangular(float X, float Y, float Width, float Height, float Thickness, D3DCOLOR Color, LPDIRECT3DDEVICE9 pDev);
-	void DrawPrimtive(LPDIRECT3DDEVICE9 pDevice, D3DPRIMITIVETYPE PrimitiveType, UINT PrimitiveCount, CONST void* pVertexStreamZeroData, UINT VertexStreamZeroStride, DWORD FVF = DRAW_FVF);
-
 	void DrawSprite(LPD3DXSPRITE SpriteInterface, LPDIRECT3DTEXTURE9 TextureInterface, int PosX, int PosY, float ScaleX, float ScaleY, int Rotation, int Align);
+
+	// Untextured quads collected from many boxes and drawn together
+	class QuadBatch
+	{
+	public:
+		void addBox(float x, float y, float w, float h, D3DCOLOR color);
+		void addRectangular(float X, float Y, float Width, float Height, float Thickness, D3DCOLOR Color);
+
+		// Draws what was added with one call per MaxQuads, then starts over; changes the state SavedState covers
+		void flush(LPDIRECT3DDEVICE9 pDevice);
+
+	private:
+		// 16 bit indices reach this many quads
+		enum { MaxQuads = 65536 / 4 };
+
+		std::vector<stVertex> _vertices;
+		// The same two triangles for every quad, only ever extended
+		std::vector<WORD> _indices;
+	};
+
+	// FVF, pixel shader and texture 0 as found on construction, set back on destruction
+	class SavedState
+	{
+	public:
+		explicit SavedState(LPDIRECT3DDEVICE9 pDevice);
+		~SavedState();
+
+	private:
+		SavedState(const SavedState&);
+		SavedState& operator=(const SavedState&);
+
+		LPDIRECT3DDEVICE9 _pDevice;
+		DWORD _dwFVF;
+		LPDIRECT3DPIXELSHADER9 _pPixelShader;
+		LPDIRECT3DBASETEXTURE9 _pTexture;
+	};
 }
@@ -1,3 +1,17 @@
 #pragma once
 
-const char *const g_strPipeName = "Overlay_Server";
\ No newline at end of file
+const char *const g_strPipeName = "Overlay_Server";
+const char *const g_strRingName = "Overlay_Server_Ring";
+const char *const g_strStatusName = "Overlay_Server_Status";
+
+// Environment variable of the game process naming a file to capture all requests to
+const char *const g_strCaptureVariable = "OVERLAY_CAPTURE";
+
+// Data capacity of the shared-memory command ring (power of two)
+const unsigned int g_uiRingCapacity = 256 * 1024;
+
+// Handles a session may hold reserved and not yet used at once
+const int g_iMaxReservedHandles = 64 * 1024;
+
+// Shortest interval in ms between two status publishes a subscriber can ask for
+const int g_iMinStatusInterval = 10;
\ No newline at end of file
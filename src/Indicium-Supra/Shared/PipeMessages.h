@@ -1,4 +1,6 @@
 #pragma once
+#include <string>
+#include <tuple>
 
 enum class PipeMessages : short
 {
@@ -39,5 +41,156 @@ enum class PipeMessages : short
 	GetFrameRate,
 	GetScreenSpecs,
 	SetCalculationRatio,
-	SetOverlayPriority
-};
\ No newline at end of file
+	SetOverlayPriority,
+	Batch,
+	GetErrorCount,
+	GetServerStats,
+	ReserveHandles,
+	TextCreateAt,
+	BoxCreateAt,
+	LineCreateAt,
+	ImageCreateAt,
+	Subscribe,
+	BeginTransaction,
+	CommitTransaction,
+	Handshake,
+
+	// Keep last, sizes the server's dispatch table
+	Count
+};
+
+// Set on the message id when the client doesn't wait for a reply
+const short PipeMessageNoReply = 0x4000;
+
+// Bumped whenever a message changes in a way older peers can't parse
+const int PipeProtocolVersion = 1;
+
+// Payload encodings a server understands, reported by Handshake
+namespace PipeEncodings
+{
+	enum : unsigned int
+	{
+		Binary = 1 << 0,
+		// Boost text archives of clients from before Binary, which never send a Handshake
+		TextArchive = 1 << 1
+	};
+}
+
+// Optional parts of the protocol, negotiated by Handshake
+namespace PipeFeatures
+{
+	enum : unsigned int
+	{
+		Batch = 1 << 0,
+		SharedRing = 1 << 1,
+		Subscriptions = 1 << 2,
+		Transactions = 1 << 3,
+		Pipelining = 1 << 4,
+		ReservedHandles = 1 << 5
+	};
+}
+
+inline PipeMessages noReply(PipeMessages message)
+{
+	return static_cast<PipeMessages>(static_cast<short>(message) | PipeMessageNoReply);
+}
+
+inline bool wantsReply(PipeMessages message)
+{
+	return (static_cast<short>(message) & PipeMessageNoReply) == 0;
+}
+
+inline PipeMessages messageId(PipeMessages message)
+{
+	return static_cast<PipeMessages>(static_cast<short>(message) & ~PipeMessageNoReply);
+}
+
+//
+// Wire layout of every message with a fixed set of fields, written once as the
+// signature of its server handler: the parameters are the request fields in wire
+// order, the return type is the reply (void for none, a tuple for several values).
+// Client encoders, server decoders and buffer sizes are all derived from this.
+//
+template<PipeMessages eMessage>
+struct MessageSchema;
+
+template<class T>
+struct MessageTraits;
+
+template<class R, class... A>
+struct MessageTraits<R(A...)>
+{
+	typedef R Signature(A...);
+	typedef R (*Handler)(A...);
+	typedef std::tuple<A...> Request;
+	typedef R Reply;
+};
+
+#define MESSAGE_SCHEMA(M, ...) \
+	template<> struct MessageSchema<PipeMessages::M> : MessageTraits<__VA_ARGS__> {};
+
+MESSAGE_SCHEMA(TextCreate, int(std::string font, int fontSize, bool bold, bool italic, int x, int y, unsigned int color, std::string text, bool shadow, bool show))
+MESSAGE_SCHEMA(TextDestroy, int(int id))
+MESSAGE_SCHEMA(TextSetShadow, int(int id, bool shadow))
+MESSAGE_SCHEMA(TextSetShown, int(int id, bool shown))
+MESSAGE_SCHEMA(TextSetColor, int(int id, unsigned int color))
+MESSAGE_SCHEMA(TextSetPos, int(int id, int x, int y))
+MESSAGE_SCHEMA(TextSetString, int(int id, std::string text))
+MESSAGE_SCHEMA(TextUpdate, int(int id, std::string font, int fontSize, bool bold, bool italic))
+
+MESSAGE_SCHEMA(BoxCreate, int(int x, int y, int width, int height, unsigned int color, bool show))
+MESSAGE_SCHEMA(BoxDestroy, int(int id))
+MESSAGE_SCHEMA(BoxSetShown, int(int id, bool shown))
+MESSAGE_SCHEMA(BoxSetBorder, int(int id, int height, bool shown))
+MESSAGE_SCHEMA(BoxSetBorderColor, int(int id, unsigned int color))
+MESSAGE_SCHEMA(BoxSetColor, int(int id, unsigned int color))
+MESSAGE_SCHEMA(BoxSetHeight, int(int id, int height))
+MESSAGE_SCHEMA(BoxSetPos, int(int id, int x, int y))
+MESSAGE_SCHEMA(BoxSetWidth, int(int id, int width))
+
+MESSAGE_SCHEMA(LineCreate, int(int x1, int y1, int x2, int y2, int width, unsigned int color, bool show))
+MESSAGE_SCHEMA(LineDestroy, int(int id))
+MESSAGE_SCHEMA(LineSetShown, int(int id, bool shown))
+MESSAGE_SCHEMA(LineSetColor, int(int id, unsigned int color))
+MESSAGE_SCHEMA(LineSetWidth, int(int id, int width))
+MESSAGE_SCHEMA(LineSetPos, int(int id, int x1, int y1, int x2, int y2))
+
+MESSAGE_SCHEMA(ImageCreate, int(std::string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool show))
+MESSAGE_SCHEMA(ImageDestroy, int(int id))
+MESSAGE_SCHEMA(ImageSetShown, int(int id, bool shown))
+MESSAGE_SCHEMA(ImageSetAlign, int(int id, int align))
+MESSAGE_SCHEMA(ImageSetPos, int(int id, int x, int y))
+MESSAGE_SCHEMA(ImageSetRotation, int(int id, int rotation))
+MESSAGE_SCHEMA(ImageSetScale, int(int id, float x, float y))
+
+MESSAGE_SCHEMA(DestroyAllVisual, void())
+MESSAGE_SCHEMA(ShowAllVisual, void())
+MESSAGE_SCHEMA(HideAllVisual, void())
+
+MESSAGE_SCHEMA(GetFrameRate, int())
+MESSAGE_SCHEMA(GetScreenSpecs, std::tuple<int, int>())
+
+MESSAGE_SCHEMA(SetCalculationRatio, void(int width, int height))
+MESSAGE_SCHEMA(SetOverlayPriority, int(int id, int priority))
+
+// Batch has no fixed layout: a count followed by length-prefixed messages
+MESSAGE_SCHEMA(GetErrorCount, int())
+MESSAGE_SCHEMA(GetServerStats, std::tuple<int, int, int, int>())
+
+// Creates under a handle from ReserveHandles, so the client needn't wait for the id
+MESSAGE_SCHEMA(ReserveHandles, int(int count))
+MESSAGE_SCHEMA(TextCreateAt, int(int id, std::string font, int fontSize, bool bold, bool italic, int x, int y, unsigned int color, std::string text, bool shadow, bool show))
+MESSAGE_SCHEMA(BoxCreateAt, int(int id, int x, int y, int width, int height, unsigned int color, bool show))
+MESSAGE_SCHEMA(LineCreateAt, int(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool show))
+MESSAGE_SCHEMA(ImageCreateAt, int(int id, std::string path, int x, int y, float scaleX, float scaleY, int rotation, int align, bool show))
+
+// Status is then published to the shared mailbox at least every intervalMs
+MESSAGE_SCHEMA(Subscribe, int(int intervalMs))
+
+// Updates in between are applied together on commit, see TransactionQueue
+MESSAGE_SCHEMA(BeginTransaction, int())
+MESSAGE_SCHEMA(CommitTransaction, int())
+
+// The client's version and the features it knows; the server answers with its version, MAX_MESSAGE_SIZE,
+// its encodings and the features both sides have. A server predating it sends an empty reply
+MESSAGE_SCHEMA(Handshake, std::tuple<int, int, unsigned int, unsigned int>(int version, unsigned int features))
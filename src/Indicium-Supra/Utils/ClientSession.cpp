@@ -0,0 +1,320 @@
+#include "ClientSession.h"
+#include "PipeClient.h"
+#include "Serializer.h"
+
+#include <Shared/PipeMessages.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+
+namespace
+{
+	// What a blocking transact() waits on; the reply may arrive after it gave up
+	struct Waiter
+	{
+		std::mutex mutex;
+		std::condition_variable done;
+		bool completed;
+		bool success;
+		std::vector<char> reply;
+	};
+}
+
+ClientSession::ClientSession(const std::string& name) :
+m_strName(name), m_uiConnection(0), m_uiNextRequest(0), m_uiBackoff(RECONNECT_BACKOFF_MIN)
+{
+}
+
+ClientSession::~ClientSession()
+{
+	disconnect();
+}
+
+bool ClientSession::connect()
+{
+	std::lock_guard<std::recursive_mutex> l(m_mutex);
+
+	if (m_link)
+	{
+		std::lock_guard<std::mutex> lLink(m_link->mutex);
+		if (!m_link->broken)
+			return true;
+	}
+
+	return open();
+}
+
+void ClientSession::disconnect()
+{
+	std::vector<std::unique_ptr<boost::thread>> readers;
+
+	{
+		std::lock_guard<std::recursive_mutex> l(m_mutex);
+
+		close();
+		readers.swap(m_readers);
+	}
+
+	// Outside the lock: a reply callback still running may be sending
+	join(readers);
+}
+
+void ClientSession::release()
+{
+	std::lock_guard<std::recursive_mutex> l(m_mutex);
+
+	close();
+
+	// Their receive returns now, they end without anyone waiting for them
+	for (auto& reader : m_readers)
+		reader->detach();
+
+	m_readers.clear();
+}
+
+uint32_t ClientSession::connectionId()
+{
+	std::lock_guard<std::recursive_mutex> l(m_mutex);
+
+	return m_link ? m_uiConnection : 0;
+}
+
+bool ClientSession::transact(Serializer& serializerIn, Serializer& serializerOut)
+{
+	auto waiter = std::make_shared<Waiter>();
+	waiter->completed = false;
+	waiter->success = false;
+
+	auto request = submit(serializerIn, [waiter](uint32_t, bool bSuccess, Serializer& serializerReply)
+	{
+		std::lock_guard<std::mutex> l(waiter->mutex);
+
+		if (bSuccess)
+		{
+			auto data = serializerReply.unread();
+			waiter->reply.assign(data, data + serializerReply.numberOfBytesLeft());
+		}
+
+		waiter->success = bSuccess;
+		waiter->completed = true;
+		waiter->done.notify_all();
+	});
+
+	if (request == 0)
+		return false;
+
+	std::unique_lock<std::mutex> l(waiter->mutex);
+
+	// A late reply still comes off the connection in turn, it just finds nobody waiting
+	if (!waiter->done.wait_for(l, std::chrono::milliseconds(TRANSACT_TIME_OUT), [&]() { return waiter->completed; }) || !waiter->success)
+		return false;
+
+	serializerOut.setData(waiter->reply.data(), waiter->reply.size());
+	return true;
+}
+
+bool ClientSession::post(Serializer& serializerIn)
+{
+	std::lock_guard<std::recursive_mutex> l(m_mutex);
+
+	return send(serializerIn, ReplyCallback(), 0);
+}
+
+uint32_t ClientSession::submit(Serializer& serializerIn, ReplyCallback callback)
+{
+	std::lock_guard<std::recursive_mutex> l(m_mutex);
+
+	// The server doesn't answer these, waiting for a reply would take the next request's
+	PipeMessages eMessage;
+	Serializer serializerPeek(serializerIn.data(), static_cast<unsigned int>(serializerIn.numberOfBytesUsed()));
+	serializerPeek >> eMessage;
+
+	if (!serializerPeek.good() || !wantsReply(eMessage))
+	{
+		send(serializerIn, ReplyCallback(), 0);
+		return 0;
+	}
+
+	if (++m_uiNextRequest == 0)
+		++m_uiNextRequest;
+
+	auto request = m_uiNextRequest;
+	return send(serializerIn, callback, request) ? request : 0;
+}
+
+bool ClientSession::open()
+{
+	close();
+
+	if (m_retryAt != boost::chrono::steady_clock::time_point() && boost::chrono::steady_clock::now() < m_retryAt)
+		return false;
+
+	auto connection = openConnection(m_strName);
+	if (!connection)
+	{
+		m_retryAt = boost::chrono::steady_clock::now() + boost::chrono::milliseconds(m_uiBackoff);
+		m_uiBackoff = (std::min)(m_uiBackoff * 2, static_cast<unsigned int>(RECONNECT_BACKOFF_MAX));
+		return false;
+	}
+
+	m_link = std::make_shared<Link>();
+	m_link->connection = std::move(connection);
+	m_link->broken = false;
+
+	if (++m_uiConnection == 0)
+		++m_uiConnection;
+
+	// Readers of earlier connections that are done by now needn't be kept
+	m_readers.erase(std::remove_if(m_readers.begin(), m_readers.end(),
+		[](const std::unique_ptr<boost::thread>& reader) { return reader->try_join_for(boost::chrono::milliseconds(0)); }), m_readers.end());
+
+	m_readers.push_back(std::unique_ptr<boost::thread>(new boost::thread(boost::bind(&ClientSession::reader, m_link))));
+
+	m_retryAt = boost::chrono::steady_clock::time_point();
+	m_uiBackoff = RECONNECT_BACKOFF_MIN;
+	return true;
+}
+
+void ClientSession::close()
+{
+	if (!m_link)
+		return;
+
+	std::deque<Pending> pending;
+
+	{
+		std::lock_guard<std::mutex> l(m_link->mutex);
+
+		m_link->broken = true;
+		m_link->pending.swap(pending);
+	}
+
+	// The reader releases the connection once its receive returns
+	m_link->connection->shutdown();
+	m_link.reset();
+
+	fail(pending);
+}
+
+bool ClientSession::send(Serializer& serializerIn, const ReplyCallback& callback, uint32_t request)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		bool bBroken = true;
+
+		if (m_link)
+		{
+			std::lock_guard<std::mutex> l(m_link->mutex);
+			bBroken = m_link->broken;
+		}
+
+		if (bBroken && !open())
+			return false;
+
+		auto link = m_link;
+
+		// Queued before it goes out, the reply may be back before send returns
+		if (request != 0)
+		{
+			std::lock_guard<std::mutex> l(link->mutex);
+			link->pending.push_back({ request, callback });
+		}
+
+		if (link->connection->send(serializerIn.data(), static_cast<uint32_t>(serializerIn.numberOfBytesUsed())))
+			return true;
+
+		auto bRetry = link->connection->retryable();
+
+		// Taken back before closing, so it isn't failed with the others when it may still go out again
+		if (request != 0)
+		{
+			std::lock_guard<std::mutex> l(link->mutex);
+
+			for (auto it = link->pending.begin(); it != link->pending.end(); ++it)
+			if (it->request == request)
+			{
+				link->pending.erase(it);
+				break;
+			}
+		}
+
+		close();
+
+		// Only a request that never left may be sent again, on a fresh connection
+		if (!bRetry)
+			break;
+	}
+
+	return false;
+}
+
+void ClientSession::reader(std::shared_ptr<Link> link)
+{
+	std::vector<char> reply;
+
+	while (link->connection->receive(reply))
+	{
+		Pending pending;
+
+		{
+			std::lock_guard<std::mutex> l(link->mutex);
+
+			// A reply nobody asked for means both sides lost count, nothing after it can be trusted
+			if (link->pending.empty())
+				break;
+
+			pending = std::move(link->pending.front());
+			link->pending.pop_front();
+		}
+
+		Serializer serializerReply(reply.data(), static_cast<unsigned int>(reply.size()));
+
+		if (pending.callback)
+			pending.callback(pending.request, true, serializerReply);
+	}
+
+	std::deque<Pending> pending;
+
+	{
+		std::lock_guard<std::mutex> l(link->mutex);
+
+		link->broken = true;
+		link->pending.swap(pending);
+	}
+
+	fail(pending);
+}
+
+void ClientSession::fail(std::deque<Pending>& pending)
+{
+	Serializer serializerReply;
+
+	for (auto& waiting : pending)
+	if (waiting.callback)
+		waiting.callback(waiting.request, false, serializerReply);
+}
+
+void ClientSession::join(std::vector<std::unique_ptr<boost::thread>>& readers)
+{
+	for (auto& reader : readers)
+	{
+		// A reply callback that disconnects can't wait for its own thread
+		if (reader->get_id() == boost::this_thread::get_id())
+		{
+			reader->detach();
+			continue;
+		}
+
+		reader->join();
+	}
+
+	readers.clear();
+}
+
+std::unique_ptr<ITransport> createTransport(const std::string& name)
+{
+	return std::unique_ptr<ITransport>(new ClientSession(name));
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Transport.h"
+
+#include <boost/chrono.hpp>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace boost { class thread; }
+
+//
+// Pipelined client transport over an IConnection. Requests are sent on the
+// caller's thread and their callbacks queued in the same order; a reader thread
+// per connection takes the replies off and completes the oldest one. transact()
+// is submit() plus a wait, so blocking and asynchronous callers share the one
+// connection and with it the server session. A broken connection is only
+// replaced on the next send, spaced out with an exponential backoff. Readers of
+// replaced connections are joined once they finished, the rest on disconnect().
+//
+class ClientSession : public ITransport
+{
+public:
+	explicit ClientSession(const std::string& name);
+	~ClientSession();
+
+	bool connect() override;
+	void disconnect() override;
+	void release() override;
+	uint32_t connectionId() override;
+
+	bool transact(Serializer& serializerIn, Serializer& serializerOut) override;
+	bool post(Serializer& serializerIn) override;
+	uint32_t submit(Serializer& serializerIn, ReplyCallback callback) override;
+
+private:
+	ClientSession(const ClientSession&);
+	ClientSession& operator=(const ClientSession&);
+
+	struct Pending
+	{
+		uint32_t request;
+		ReplyCallback callback;
+	};
+
+	// Shared with the reader thread, which may outlive it by the time a blocked receive takes to return
+	struct Link
+	{
+		std::unique_ptr<IConnection> connection;
+		std::mutex mutex;
+		std::deque<Pending> pending;
+		bool broken;
+	};
+
+	bool open();
+	void close();
+	bool send(Serializer& serializerIn, const ReplyCallback& callback, uint32_t request);
+
+	static void reader(std::shared_ptr<Link> link);
+	static void fail(std::deque<Pending>& pending);
+	static void join(std::vector<std::unique_ptr<boost::thread>>& readers);
+
+	std::string m_strName;
+	std::shared_ptr<Link> m_link;
+	std::vector<std::unique_ptr<boost::thread>> m_readers;
+	uint32_t m_uiConnection;
+	uint32_t m_uiNextRequest;
+
+	boost::chrono::steady_clock::time_point m_retryAt;
+	unsigned int m_uiBackoff;
+
+	// Held while sending, so requests leave in the order their callbacks were queued
+	std::recursive_mutex m_mutex;
+};
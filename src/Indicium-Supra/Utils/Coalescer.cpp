@@ -0,0 +1,134 @@
+#include "Coalescer.h"
+#include "Serializer.h"
+
+// Emptied entries are dropped once they outnumber the live ones
+#define COMPACT_SLACK	16
+
+Coalescer::Coalescer(IListener::Callback callback) :
+m_cbCallback(callback), m_coalesced(static_cast<size_t>(PipeMessages::Count), false)
+{
+}
+
+void Coalescer::coalesce(PipeMessages eMessage)
+{
+	m_coalesced[static_cast<size_t>(eMessage)] = true;
+}
+
+void Coalescer::receive(Serializer& serializerIn, Serializer& serializerOut)
+{
+	auto length = static_cast<size_t>(serializerIn.numberOfBytesLeft());
+	auto session = currentSession();
+
+	PipeMessages eMessage;
+	int id;
+
+	Serializer serializerPeek(serializerIn.unread(), static_cast<unsigned int>(length));
+	serializerPeek >> eMessage >> id;
+
+	auto uiIndex = static_cast<unsigned short>(messageId(eMessage));
+	if (!serializerPeek.good() || uiIndex >= m_coalesced.size() || !m_coalesced[uiIndex] || wantsReply(eMessage))
+	{
+		// A staged update of an object this destroys or sets again must not come after it
+		flush(session);
+		m_cbCallback(serializerIn, serializerOut);
+		return;
+	}
+
+	auto key = (static_cast<uint64_t>(uiIndex) << 32) | static_cast<uint32_t>(id);
+	auto data = serializerIn.unread();
+
+	std::lock_guard<std::mutex> l(m_mutex);
+
+	auto& staged = m_staged[session];
+	auto it = staged.index.find(key);
+
+	if (it == staged.index.end())
+	{
+		staged.index[key] = staged.requests.size();
+	}
+	else
+	{
+		staged.requests[it->second].second.clear();
+		it->second = staged.requests.size();
+	}
+
+	staged.requests.push_back(std::make_pair(key, std::vector<char>(data, data + length)));
+
+	if (staged.requests.size() > 2 * staged.index.size() + COMPACT_SLACK)
+		compact(staged);
+}
+
+void Coalescer::closed(SessionId session)
+{
+	std::lock_guard<std::mutex> l(m_mutex);
+
+	// Its objects are gone, the updates would only fail
+	m_staged.erase(session);
+}
+
+void Coalescer::flush()
+{
+	std::unordered_map<SessionId, Staged> staged;
+
+	{
+		std::lock_guard<std::mutex> l(m_mutex);
+
+		if (m_staged.empty())
+			return;
+
+		staged.swap(m_staged);
+	}
+
+	for (auto& session : staged)
+		pass(session.first, session.second);
+}
+
+void Coalescer::flush(SessionId session)
+{
+	Staged staged;
+
+	{
+		std::lock_guard<std::mutex> l(m_mutex);
+
+		auto it = m_staged.find(session);
+		if (it == m_staged.end())
+			return;
+
+		staged.requests.swap(it->second.requests);
+		m_staged.erase(it);
+	}
+
+	pass(session, staged);
+}
+
+void Coalescer::pass(SessionId session, Staged& staged)
+{
+	SessionScope scope(session);
+
+	for (auto& request : staged.requests)
+	{
+		if (request.second.empty())
+			continue;
+
+		Serializer serializerIn(request.second.data(), static_cast<unsigned int>(request.second.size()));
+		Serializer serializerOut;
+
+		m_cbCallback(serializerIn, serializerOut);
+	}
+}
+
+void Coalescer::compact(Staged& staged)
+{
+	size_t uiLive = 0;
+
+	for (auto& request : staged.requests)
+	{
+		if (request.second.empty())
+			continue;
+
+		staged.index[request.first] = uiLive;
+		std::swap(staged.requests[uiLive++], request);
+	}
+
+	staged.requests.resize(uiLive);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Transport.h"
+
+#include <Shared/PipeMessages.h>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//
+// Holds back fire-and-forget updates until the next frame and keeps only the
+// latest one per message and object, so a client moving a text ten times between
+// two frames costs one mutation under the render lock instead of ten. Only
+// messages marked with coalesce() are staged, and their first field must be the
+// object id. Staging is per session and keeps arrival order; any other request
+// of a session (a destroy, a batch, a setter that wants a reply, ...) first
+// passes on what that session has staged, so nothing it sent earlier can land
+// after it. flush() is meant to run under the lock the handlers take, which keeps
+// a request of another thread from overtaking the entries it is passing on.
+//
+class Coalescer
+{
+public:
+	explicit Coalescer(IListener::Callback callback);
+
+	void coalesce(PipeMessages eMessage);
+
+	// Listener callbacks: stages what it can, passes everything else on
+	void receive(Serializer& serializerIn, Serializer& serializerOut);
+	void closed(SessionId session);
+
+	// Passes the staged requests of every session on, in the order they arrived
+	void flush();
+
+private:
+	Coalescer(const Coalescer&);
+	Coalescer& operator=(const Coalescer&);
+
+	// Replaced requests are emptied and the new one goes to the end, keyed by message and object
+	struct Staged
+	{
+		std::vector<std::pair<uint64_t, std::vector<char>>> requests;
+		std::unordered_map<uint64_t, size_t> index;
+	};
+
+	void flush(SessionId session);
+	void pass(SessionId session, Staged& staged);
+	static void compact(Staged& staged);
+
+	IListener::Callback m_cbCallback;
+	std::vector<bool> m_coalesced;
+
+	std::mutex m_mutex;
+	std::unordered_map<SessionId, Staged> m_staged;
+};
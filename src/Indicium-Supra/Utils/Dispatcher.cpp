@@ -0,0 +1,66 @@
+#include "Dispatcher.h"
+
+#include <boost/chrono.hpp>
+
+Dispatcher::Dispatcher() : m_uiNoReplyErrors(0)
+{
+	for (auto& handler : m_handlers)
+		handler = nullptr;
+}
+
+void Dispatcher::dispatch(Serializer& serializerIn, Serializer& serializerOut) const
+{
+	auto start = boost::chrono::steady_clock::now();
+
+	route(serializerIn, serializerOut);
+
+	auto elapsed = boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now() - start);
+	m_stats.record(static_cast<uint32_t>(elapsed.count()));
+}
+
+void Dispatcher::route(Serializer& serializerIn, Serializer& serializerOut) const
+{
+	SERIALIZATION_READ(serializerIn, PipeMessages, eMessage);
+
+	// Also rejects the high ids a negative opcode turns into
+	auto uiIndex = static_cast<unsigned short>(messageId(eMessage));
+	if (!serializerIn.good() || uiIndex >= MessageCount)
+		return;
+
+	auto handler = m_handlers[uiIndex];
+	if (handler == nullptr)
+		return;
+
+	try
+	{
+		handler(serializerIn, serializerOut, *this);
+
+		if (!wantsReply(eMessage))
+			completed(serializerOut);
+	}
+	catch (...)
+	{
+	}
+}
+
+void Dispatcher::completed(Serializer& serializerOut) const
+{
+	if (serializerOut.numberOfBytesUsed() == 0)
+		return;
+
+	int result = 1;
+	Serializer(serializerOut.data(), serializerOut.numberOfBytesUsed()) >> result;
+
+	if (result == 0)
+		m_uiNoReplyErrors++;
+}
+
+unsigned int Dispatcher::takeErrorCount() const
+{
+	return m_uiNoReplyErrors.exchange(0);
+}
+
+LatencyStats::Snapshot Dispatcher::takeStats() const
+{
+	return m_stats.take();
+}
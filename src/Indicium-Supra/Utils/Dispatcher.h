@@ -0,0 +1,60 @@
+#pragma once
+#include "Serializer.h"
+#include "MessageCodec.h"
+#include "LatencyStats.h"
+
+#include <Shared/PipeMessages.h>
+
+#include <atomic>
+
+//
+// Routes decoded requests to their handlers. Knows nothing about the transport
+// or the renderer, so the same table can be served from the game or a headless host.
+// The table is a flat array indexed by message id; handlers are bound as template
+// arguments and must match the message's MessageSchema signature exactly.
+//
+class Dispatcher
+{
+public:
+	typedef void (*Handler)(Serializer&, Serializer&, const Dispatcher&);
+
+	enum : unsigned short { MessageCount = static_cast<unsigned short>(PipeMessages::Count) };
+
+	Dispatcher();
+
+	template<PipeMessages eMessage, typename MessageSchema<eMessage>::Handler F>
+	void bind()
+	{
+		static_assert(static_cast<unsigned short>(eMessage) < MessageCount, "message id out of range");
+		m_handlers[static_cast<unsigned short>(eMessage)] = &invoke<eMessage, F>;
+	}
+
+	// For handlers that decode themselves, dispatch further or read the dispatcher's counters
+	template<PipeMessages eMessage, void (*F)(Serializer&, Serializer&, const Dispatcher&)>
+	void bindWithDispatcher()
+	{
+		static_assert(static_cast<unsigned short>(eMessage) < MessageCount, "message id out of range");
+		m_handlers[static_cast<unsigned short>(eMessage)] = F;
+	}
+
+	// Entry point for transports, timed into the server stats
+	void dispatch(Serializer& serializerIn, Serializer& serializerOut) const;
+	// Same without timing, for commands nested in an already timed request
+	void route(Serializer& serializerIn, Serializer& serializerOut) const;
+
+	// Counts a failed result of a command whose reply nobody reads
+	void completed(Serializer& serializerOut) const;
+	unsigned int takeErrorCount() const;
+	LatencyStats::Snapshot takeStats() const;
+
+private:
+	template<PipeMessages eMessage, typename MessageSchema<eMessage>::Handler F>
+	static void invoke(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher&)
+	{
+		MessageInvoker<typename MessageSchema<eMessage>::Signature>::call(F, serializerIn, serializerOut);
+	}
+
+	Handler m_handlers[MessageCount];
+	mutable std::atomic<unsigned int> m_uiNoReplyErrors;
+	mutable LatencyStats m_stats;
+};
@@ -0,0 +1,90 @@
+#include "LatencyStats.h"
+
+#include <boost/chrono.hpp>
+
+namespace
+{
+	uint64_t nowMs()
+	{
+		return boost::chrono::duration_cast<boost::chrono::milliseconds>(boost::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+LatencyStats::LatencyStats() : m_ops(0), m_windowStart(nowMs())
+{
+	for (auto& bucket : m_buckets)
+		bucket.store(0);
+}
+
+void LatencyStats::record(uint32_t micros)
+{
+	m_buckets[bucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+	m_ops.fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyStats::Snapshot LatencyStats::take()
+{
+	uint32_t counts[Buckets];
+	uint32_t total = 0;
+
+	for (int i = 0; i < Buckets; i++)
+	{
+		counts[i] = m_buckets[i].exchange(0, std::memory_order_relaxed);
+		total += counts[i];
+	}
+
+	auto now = nowMs();
+
+	Snapshot snapshot;
+	snapshot.ops = m_ops.exchange(0, std::memory_order_relaxed);
+	snapshot.elapsedMs = static_cast<uint32_t>(now - m_windowStart.exchange(now));
+	snapshot.p50 = snapshot.p99 = snapshot.p999 = 0;
+
+	// Ranks are rounded up so a single slow request still shows in p999
+	const uint64_t rank50 = (uint64_t(total) * 500 + 999) / 1000;
+	const uint64_t rank99 = (uint64_t(total) * 990 + 999) / 1000;
+	const uint64_t rank999 = (uint64_t(total) * 999 + 999) / 1000;
+
+	uint64_t seen = 0;
+	for (int i = 0; i < Buckets && seen < rank999; i++)
+	{
+		if (counts[i] == 0)
+			continue;
+
+		auto before = seen;
+		seen += counts[i];
+
+		if (before < rank50 && seen >= rank50)
+			snapshot.p50 = upperBound(i);
+		if (before < rank99 && seen >= rank99)
+			snapshot.p99 = upperBound(i);
+		if (seen >= rank999)
+			snapshot.p999 = upperBound(i);
+	}
+
+	return snapshot;
+}
+
+uint32_t LatencyStats::bucketOf(uint32_t micros)
+{
+	if (micros < SubBuckets)
+		return micros;
+
+	uint32_t exponent = 0;
+	while ((micros >> exponent) >= 2 * SubBuckets)
+		exponent++;
+
+	// Values in [SubBuckets << exponent, 2 * SubBuckets << exponent) share an exponent
+	return (exponent + 1) * SubBuckets + ((micros >> exponent) - SubBuckets);
+}
+
+uint32_t LatencyStats::upperBound(uint32_t bucket)
+{
+	if (bucket < SubBuckets)
+		return bucket;
+
+	uint32_t exponent = bucket / SubBuckets - 1;
+	uint64_t value = (uint64_t(SubBuckets + bucket % SubBuckets + 1) << exponent) - 1;
+
+	return value > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(value);
+}
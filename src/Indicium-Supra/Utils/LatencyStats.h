@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//
+// Lock-free latency histogram plus an operation counter. Buckets are split by
+// the highest set bit of the microsecond value and then into SubBuckets linear
+// steps, so percentiles come out within ~12% of the real value.
+//
+class LatencyStats
+{
+	enum
+	{
+		SubBucketBits = 3,
+		SubBuckets = 1 << SubBucketBits,
+		Buckets = 32 * SubBuckets
+	};
+
+public:
+	struct Snapshot
+	{
+		uint32_t ops;
+		uint32_t elapsedMs;
+		uint32_t p50, p99, p999;
+	};
+
+	LatencyStats();
+
+	void record(uint32_t micros);
+
+	// Returns the figures since the previous call and starts a new window
+	Snapshot take();
+
+private:
+	static uint32_t bucketOf(uint32_t micros);
+	static uint32_t upperBound(uint32_t bucket);
+
+	std::atomic<uint32_t> m_buckets[Buckets];
+	std::atomic<uint32_t> m_ops;
+	std::atomic<uint64_t> m_windowStart;
+};
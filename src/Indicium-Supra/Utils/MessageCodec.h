@@ -0,0 +1,215 @@
+#pragma once
+#include "Serializer.h"
+
+#include <Shared/PipeMessages.h>
+
+#include <tuple>
+#include <utility>
+
+//
+// Encoders and decoders derived from MessageSchema. Field types are fixed by the
+// schema, so a client passing the wrong number of arguments or a server handler
+// with a different signature fails to compile instead of drifting apart.
+//
+namespace message_detail
+{
+	template<size_t... I>
+	struct Indices {};
+
+	template<size_t N, size_t... I>
+	struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+
+	template<size_t... I>
+	struct MakeIndices<0, I...>
+	{
+		typedef Indices<I...> type;
+	};
+
+	// Exact encoded size, so a request is written into one allocation
+	template<class T> size_t wireSize(const T& t);
+	inline size_t wireSize(const std::string& str);
+	template<class T> size_t wireSize(const std::vector<T>& v);
+	template<class... T> size_t wireSize(const std::tuple<T...>& t);
+
+	template<class T> void write(Serializer& serializer, const T& t);
+	template<class... T> void write(Serializer& serializer, const std::tuple<T...>& t);
+
+	template<class T> void read(Serializer& serializer, T& t);
+	template<class... T> void read(Serializer& serializer, std::tuple<T...>& t);
+
+	template<class Tuple>
+	size_t tupleSize(const Tuple&, Indices<>)
+	{
+		return 0;
+	}
+
+	template<class Tuple, size_t I, size_t... Rest>
+	size_t tupleSize(const Tuple& t, Indices<I, Rest...>)
+	{
+		return wireSize(std::get<I>(t)) + tupleSize(t, Indices<Rest...>());
+	}
+
+	template<class Tuple>
+	void writeTuple(Serializer&, const Tuple&, Indices<>)
+	{
+	}
+
+	template<class Tuple, size_t I, size_t... Rest>
+	void writeTuple(Serializer& serializer, const Tuple& t, Indices<I, Rest...>)
+	{
+		write(serializer, std::get<I>(t));
+		writeTuple(serializer, t, Indices<Rest...>());
+	}
+
+	template<class Tuple>
+	void readTuple(Serializer&, Tuple&, Indices<>)
+	{
+	}
+
+	template<class Tuple, size_t I, size_t... Rest>
+	void readTuple(Serializer& serializer, Tuple& t, Indices<I, Rest...>)
+	{
+		read(serializer, std::get<I>(t));
+		readTuple(serializer, t, Indices<Rest...>());
+	}
+
+	template<class T>
+	size_t wireSize(const T&)
+	{
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "MessageSchema: unsupported field type");
+		return std::is_same<T, bool>::value ? 1 : sizeof(T);
+	}
+
+	inline size_t wireSize(const std::string& str)
+	{
+		return sizeof(uint32_t) + str.size();
+	}
+
+	template<class T>
+	size_t wireSize(const std::vector<T>& v)
+	{
+		size_t size = sizeof(uint32_t);
+		for (const auto& e : v)
+			size += wireSize(e);
+		return size;
+	}
+
+	template<class... T>
+	size_t wireSize(const std::tuple<T...>& t)
+	{
+		return tupleSize(t, typename MakeIndices<sizeof...(T)>::type());
+	}
+
+	template<class T>
+	void write(Serializer& serializer, const T& t)
+	{
+		serializer << t;
+	}
+
+	template<class... T>
+	void write(Serializer& serializer, const std::tuple<T...>& t)
+	{
+		writeTuple(serializer, t, typename MakeIndices<sizeof...(T)>::type());
+	}
+
+	template<class T>
+	void read(Serializer& serializer, T& t)
+	{
+		serializer >> t;
+	}
+
+	template<class... T>
+	void read(Serializer& serializer, std::tuple<T...>& t)
+	{
+		readTuple(serializer, t, typename MakeIndices<sizeof...(T)>::type());
+	}
+
+	template<PipeMessages eMessage, class... Args>
+	void writeRequest(Serializer& serializer, PipeMessages eId, const Args&... args)
+	{
+		typedef typename MessageSchema<eMessage>::Request Request;
+		static_assert(sizeof...(Args) == std::tuple_size<Request>::value, "MessageSchema: wrong number of request fields");
+
+		Request fields(args...);
+
+		serializer.reserve(sizeof(PipeMessages) + wireSize(fields));
+		serializer << eId;
+		write(serializer, fields);
+	}
+}
+
+template<PipeMessages eMessage, class... Args>
+void writeRequest(Serializer& serializer, const Args&... args)
+{
+	message_detail::writeRequest<eMessage>(serializer, eMessage, args...);
+}
+
+template<PipeMessages eMessage, class... Args>
+void writeRequestNoReply(Serializer& serializer, const Args&... args)
+{
+	message_detail::writeRequest<eMessage>(serializer, noReply(eMessage), args...);
+}
+
+template<PipeMessages eMessage>
+void writeReply(Serializer& serializer, const typename MessageSchema<eMessage>::Reply& reply)
+{
+	message_detail::write(serializer, reply);
+}
+
+template<PipeMessages eMessage>
+bool readReply(Serializer& serializer, typename MessageSchema<eMessage>::Reply& reply)
+{
+	message_detail::read(serializer, reply);
+	return serializer.good();
+}
+
+//
+// Decodes a request into the handler's parameters and encodes what it returns.
+// Nothing is called for a request that ends before all fields were read.
+//
+template<class Signature>
+struct MessageInvoker;
+
+template<class R, class... A>
+struct MessageInvoker<R(A...)>
+{
+	static void call(R (*handler)(A...), Serializer& serializerIn, Serializer& serializerOut)
+	{
+		std::tuple<A...> fields;
+		message_detail::read(serializerIn, fields);
+
+		if (!serializerIn.good())
+			return;
+
+		message_detail::write(serializerOut, invoke(handler, fields, typename message_detail::MakeIndices<sizeof...(A)>::type()));
+	}
+
+private:
+	template<size_t... I>
+	static R invoke(R (*handler)(A...), std::tuple<A...>& fields, message_detail::Indices<I...>)
+	{
+		return handler(std::move(std::get<I>(fields))...);
+	}
+};
+
+template<class... A>
+struct MessageInvoker<void(A...)>
+{
+	static void call(void (*handler)(A...), Serializer& serializerIn, Serializer& serializerOut)
+	{
+		std::tuple<A...> fields;
+		message_detail::read(serializerIn, fields);
+
+		if (!serializerIn.good())
+			return;
+
+		invoke(handler, fields, typename message_detail::MakeIndices<sizeof...(A)>::type());
+	}
+
+private:
+	template<size_t... I>
+	static void invoke(void (*handler)(A...), std::tuple<A...>& fields, message_detail::Indices<I...>)
+	{
+		handler(std::move(std::get<I>(fields))...);
+	}
+};
@@ -0,0 +1,185 @@
+#include "MessageTable.h"
+
+#include <algorithm>
+#include <vector>
+
+#define READ(X, Y) SERIALIZATION_READ(serializerIn, X, Y);
+#define COALESCE(T) coalescer.coalesce(PipeMessages::T);
+#define DEFER(T) transactions.defer<PipeMessages::T>();
+#define ACCEPT(T) textArchives.accept<PipeMessages::T>();
+
+void RouteBatch(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher)
+{
+	READ(uint32_t, count);
+
+	// Every command carries at least its length prefix, don't trust the count beyond that
+	std::vector<int> results;
+	results.reserve((std::min)(count, static_cast<uint32_t>(serializerIn.numberOfBytesLeft() / sizeof(uint32_t))));
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		READ(uint32_t, length);
+
+		auto command = serializerIn.readInPlace(length);
+		if (command == nullptr)
+			break;
+
+		PipeMessages eMessage;
+		Serializer(command, length) >> eMessage;
+
+		// A batch inside a batch would let one request recurse as deep as its size allows
+		if (messageId(eMessage) == PipeMessages::Batch)
+		{
+			results.push_back(0);
+			continue;
+		}
+
+		Serializer commandIn(command, length);
+		Serializer commandOut;
+
+		dispatcher.route(commandIn, commandOut);
+
+		// Commands without a reply (e.g. HideAllVisual) count as succeeded
+		int result = 1;
+		if (commandOut.numberOfBytesUsed() > 0)
+			Serializer(commandOut.data(), commandOut.numberOfBytesUsed()) >> result;
+
+		results.push_back(result);
+	}
+
+	serializerOut << results;
+}
+
+void GetErrorCount(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher)
+{
+	writeReply<PipeMessages::GetErrorCount>(serializerOut, int(dispatcher.takeErrorCount()));
+}
+
+void GetServerStats(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher)
+{
+	auto stats = dispatcher.takeStats();
+
+	writeReply<PipeMessages::GetServerStats>(serializerOut, std::make_tuple(
+		int(stats.elapsedMs ? uint64_t(stats.ops) * 1000 / stats.elapsedMs : 0), int(stats.p50), int(stats.p99), int(stats.p999)));
+}
+
+void RegisterCoalescing(Coalescer& coalescer)
+{
+	COALESCE(TextSetShadow);
+	COALESCE(TextSetShown);
+	COALESCE(TextSetColor);
+	COALESCE(TextSetPos);
+	COALESCE(TextSetString);
+	COALESCE(TextUpdate);
+
+	COALESCE(BoxSetShown);
+	COALESCE(BoxSetBorder);
+	COALESCE(BoxSetBorderColor);
+	COALESCE(BoxSetColor);
+	COALESCE(BoxSetHeight);
+	COALESCE(BoxSetPos);
+	COALESCE(BoxSetWidth);
+
+	COALESCE(LineSetShown);
+	COALESCE(LineSetColor);
+	COALESCE(LineSetWidth);
+	COALESCE(LineSetPos);
+
+	COALESCE(ImageSetShown);
+	COALESCE(ImageSetAlign);
+	COALESCE(ImageSetPos);
+	COALESCE(ImageSetRotation);
+	COALESCE(ImageSetScale);
+
+	COALESCE(SetOverlayPriority);
+}
+
+void RegisterTransactions(TransactionQueue& transactions)
+{
+	DEFER(TextCreateAt);
+	DEFER(TextDestroy);
+	DEFER(TextSetShadow);
+	DEFER(TextSetShown);
+	DEFER(TextSetColor);
+	DEFER(TextSetPos);
+	DEFER(TextSetString);
+	DEFER(TextUpdate);
+
+	DEFER(BoxCreateAt);
+	DEFER(BoxDestroy);
+	DEFER(BoxSetShown);
+	DEFER(BoxSetBorder);
+	DEFER(BoxSetBorderColor);
+	DEFER(BoxSetColor);
+	DEFER(BoxSetHeight);
+	DEFER(BoxSetPos);
+	DEFER(BoxSetWidth);
+
+	DEFER(LineCreateAt);
+	DEFER(LineDestroy);
+	DEFER(LineSetShown);
+	DEFER(LineSetColor);
+	DEFER(LineSetWidth);
+	DEFER(LineSetPos);
+
+	DEFER(ImageCreateAt);
+	DEFER(ImageDestroy);
+	DEFER(ImageSetShown);
+	DEFER(ImageSetAlign);
+	DEFER(ImageSetPos);
+	DEFER(ImageSetRotation);
+	DEFER(ImageSetScale);
+
+	DEFER(DestroyAllVisual);
+	DEFER(ShowAllVisual);
+	DEFER(HideAllVisual);
+
+	DEFER(SetOverlayPriority);
+}
+
+void RegisterTextArchive(TextArchiveCodec& textArchives)
+{
+	ACCEPT(TextCreate);
+	ACCEPT(TextDestroy);
+	ACCEPT(TextSetShadow);
+	ACCEPT(TextSetShown);
+	ACCEPT(TextSetColor);
+	ACCEPT(TextSetPos);
+	ACCEPT(TextSetString);
+	ACCEPT(TextUpdate);
+
+	ACCEPT(BoxCreate);
+	ACCEPT(BoxDestroy);
+	ACCEPT(BoxSetShown);
+	ACCEPT(BoxSetBorder);
+	ACCEPT(BoxSetBorderColor);
+	ACCEPT(BoxSetColor);
+	ACCEPT(BoxSetHeight);
+	ACCEPT(BoxSetPos);
+	ACCEPT(BoxSetWidth);
+
+	ACCEPT(LineCreate);
+	ACCEPT(LineDestroy);
+	ACCEPT(LineSetShown);
+	ACCEPT(LineSetColor);
+	ACCEPT(LineSetWidth);
+	ACCEPT(LineSetPos);
+
+	ACCEPT(ImageCreate);
+	ACCEPT(ImageDestroy);
+	ACCEPT(ImageSetShown);
+	ACCEPT(ImageSetAlign);
+	ACCEPT(ImageSetPos);
+	ACCEPT(ImageSetRotation);
+	ACCEPT(ImageSetScale);
+
+	ACCEPT(DestroyAllVisual);
+	ACCEPT(ShowAllVisual);
+	ACCEPT(HideAllVisual);
+
+	ACCEPT(GetFrameRate);
+	ACCEPT(GetScreenSpecs);
+
+	ACCEPT(SetCalculationRatio);
+	ACCEPT(SetOverlayPriority);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "Coalescer.h"
+#include "Dispatcher.h"
+#include "Serializer.h"
+#include "TextArchive.h"
+#include "TransactionQueue.h"
+
+//
+// The parts of the server's message table that don't touch the renderer, shared
+// by the game and the headless hosts: how each stage of the request chain treats
+// the messages, and the handlers that only need the dispatcher.
+//
+
+// Routes every command of a Batch and replies with their results; the caller holds the lock the handlers take
+void RouteBatch(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher);
+
+void GetErrorCount(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher);
+void GetServerStats(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher);
+
+// Marks the per-object setters whose fire-and-forget calls may wait for the next frame
+void RegisterCoalescing(Coalescer& coalescer);
+// Marks what a transaction holds back until its commit: every change whose reply can be told in advance
+void RegisterTransactions(TransactionQueue& transactions);
+// Marks the messages clients from before the binary wire format knew, which they still send as text archives
+void RegisterTextArchive(TextArchiveCodec& textArchives);
@@ -1,26 +1,183 @@
-#include "Windows.h"
 #include "PipeClient.h"
 #include "Serializer.h"
 
 #include <Shared/Config.h>
 
-PipeClient::PipeClient(Serializer& serializerIn, Serializer& serializerOut) :
-m_bSuccess(false)
+#ifdef _WIN32
+#include "Windows.h"
+
+// Waits for an overlapped pipe operation or for the shutdown event, GetLastError() tells why it failed
+static BOOL waitForPipe(HANDLE hPipe, HANDLE hEvent, HANDLE hShutdown, OVERLAPPED& overlapped, DWORD& dwBytes, DWORD dwTimeout)
+{
+	HANDLE hEvents[] = { hEvent, hShutdown };
+
+	auto dwWait = WaitForMultipleObjects(2, hEvents, FALSE, dwTimeout);
+	if (dwWait != WAIT_OBJECT_0)
+	{
+		// Only cancels what this thread started, an operation of another thread on the pipe goes on
+		CancelIo(hPipe);
+		GetOverlappedResult(hPipe, &overlapped, &dwBytes, TRUE);
+		SetLastError(dwWait == WAIT_TIMEOUT ? ERROR_TIMEOUT : ERROR_OPERATION_ABORTED);
+		return FALSE;
+	}
+
+	return GetOverlappedResult(hPipe, &overlapped, &dwBytes, FALSE);
+}
+
+PipeConnection::PipeConnection(void *hPipe) :
+m_hPipe(hPipe), m_hSendEvent(CreateEvent(NULL, TRUE, FALSE, NULL)), m_hReceiveEvent(CreateEvent(NULL, TRUE, FALSE, NULL)), m_hShutdownEvent(CreateEvent(NULL, TRUE, FALSE, NULL))
+{
+}
+
+PipeConnection::~PipeConnection()
+{
+	CloseHandle(m_hPipe);
+
+	for (auto hEvent : { m_hSendEvent, m_hReceiveEvent, m_hShutdownEvent })
+	if (hEvent)
+		CloseHandle(hEvent);
+}
+
+bool PipeConnection::send(const char *data, uint32_t length)
+{
+	DWORD dwWritten = 0;
+
+	OVERLAPPED overlapped = { 0 };
+	overlapped.hEvent = m_hSendEvent;
+	ResetEvent(m_hSendEvent);
+
+	if (!WriteFile(m_hPipe, data, length, &dwWritten, &overlapped))
+	{
+		if (GetLastError() != ERROR_IO_PENDING || !waitForPipe(m_hPipe, m_hSendEvent, m_hShutdownEvent, overlapped, dwWritten, TRANSACT_TIME_OUT))
+			return false;
+	}
+
+	return dwWritten == length;
+}
+
+bool PipeConnection::receive(std::vector<char>& message)
+{
+	if (WaitForSingleObject(m_hShutdownEvent, 0) == WAIT_OBJECT_0)
+		return false;
+
+	message.resize(BUFSIZE);
+
+	DWORD dwRead = 0;
+
+	OVERLAPPED overlapped = { 0 };
+	overlapped.hEvent = m_hReceiveEvent;
+	ResetEvent(m_hReceiveEvent);
+
+	if (!ReadFile(m_hPipe, message.data(), BUFSIZE, &dwRead, &overlapped))
+	{
+		auto dwError = GetLastError();
+
+		// Nothing may come for a long time, only shutdown() ends the wait
+		if (dwError == ERROR_IO_PENDING)
+			dwError = waitForPipe(m_hPipe, m_hReceiveEvent, m_hShutdownEvent, overlapped, dwRead, INFINITE) ? ERROR_SUCCESS : GetLastError();
+		else if (dwError == ERROR_MORE_DATA)
+			GetOverlappedResult(m_hPipe, &overlapped, &dwRead, FALSE);
+
+		// The message didn't fit, its first dwRead bytes are in the buffer
+		if (dwError == ERROR_MORE_DATA)
+			return readRemainder(message, dwRead);
+
+		if (dwError != ERROR_SUCCESS)
+			return false;
+	}
+
+	message.resize(dwRead);
+	return true;
+}
+
+void PipeConnection::shutdown()
 {
-	char szData[BUFSIZE] = { 0 };
-	char szPipe[MAX_PATH + 1] = { 0 };
-	DWORD dwReaded;
+	SetEvent(m_hShutdownEvent);
+}
+
+bool PipeConnection::readRemainder(std::vector<char>& message, unsigned long dwRead)
+{
+	DWORD dwLeft = 0;
+	if (!PeekNamedPipe(m_hPipe, NULL, 0, NULL, NULL, &dwLeft))
+		return false;
+
+	if (dwRead + dwLeft > MAX_MESSAGE_SIZE)
+	{
+		SetLastError(ERROR_INSUFFICIENT_BUFFER);
+		return false;
+	}
+
+	message.resize(dwRead + dwLeft);
 
-	sprintf_s(szPipe, "\\\\.\\pipe\\%s", g_strPipeName);
+	DWORD dwBytes = 0;
 
-	if (CallNamedPipe(szPipe, LPVOID(serializerIn.data()), serializerIn.numberOfBytesUsed(), szData, sizeof(szData), &dwReaded, TIME_OUT))
+	OVERLAPPED overlapped = { 0 };
+	overlapped.hEvent = m_hReceiveEvent;
+	ResetEvent(m_hReceiveEvent);
+
+	if (!ReadFile(m_hPipe, message.data() + dwRead, dwLeft, &dwBytes, &overlapped))
 	{
-		serializerOut.setData(szData, sizeof(szData));
-		m_bSuccess = true;
+		if (GetLastError() != ERROR_IO_PENDING || !waitForPipe(m_hPipe, m_hReceiveEvent, m_hShutdownEvent, overlapped, dwBytes, TRANSACT_TIME_OUT))
+			return false;
 	}
+
+	return dwBytes == dwLeft;
+}
+
+bool PipeConnection::retryable() const
+{
+	auto dwError = GetLastError();
+	return dwError == ERROR_BROKEN_PIPE || dwError == ERROR_PIPE_NOT_CONNECTED || dwError == ERROR_NO_DATA;
+}
+
+std::unique_ptr<IConnection> openConnection(const std::string& name)
+{
+	auto strPipe = "\\\\.\\pipe\\" + name;
+	auto szPipe = strPipe.c_str();
+
+	auto hPipe = CreateFileA(szPipe, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+	if (hPipe == INVALID_HANDLE_VALUE)
+	{
+		if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(szPipe, TIME_OUT))
+			return nullptr;
+
+		hPipe = CreateFileA(szPipe, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+		if (hPipe == INVALID_HANDLE_VALUE)
+			return nullptr;
+	}
+
+	DWORD dwMode = PIPE_READMODE_MESSAGE;
+	if (!SetNamedPipeHandleState(hPipe, &dwMode, NULL, NULL))
+	{
+		CloseHandle(hPipe);
+		return nullptr;
+	}
+
+	return std::unique_ptr<IConnection>(new PipeConnection(hPipe));
+}
+
+#endif
+
+std::unique_ptr<ITransport> g_clientTransport(createTransport(g_strPipeName));
+
+ITransport& clientTransport()
+{
+	return *g_clientTransport;
+}
+
+PipeClient::PipeClient(Serializer& serializerIn, Serializer& serializerOut) :
+m_bSuccess(false)
+{
+	m_bSuccess = clientTransport().transact(serializerIn, serializerOut);
+}
+
+PipeClient::PipeClient(Serializer& serializerIn) :
+m_bSuccess(false)
+{
+	m_bSuccess = clientTransport().post(serializerIn);
 }
 
 bool PipeClient::success() const
 {
 	return m_bSuccess;
-}
\ No newline at end of file
+}
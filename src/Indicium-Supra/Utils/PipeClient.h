@@ -1,16 +1,55 @@
 #pragma once
+#include "Transport.h"
+
+#include <string>
+#include <vector>
 
 #define BUFSIZE	 4096
 #define TIME_OUT 100
+#define TRANSACT_TIME_OUT 2000
+
+#define RECONNECT_BACKOFF_MIN	50
+#define RECONNECT_BACKOFF_MAX	2000
 
 class Serializer;
 
+//
+// Named-pipe connection to the overlay server, in message mode. Sends and the
+// receive run as separate overlapped operations, so the reader thread can wait
+// for replies while other threads send. Messages larger than BUFSIZE are read
+// in a second step, up to MAX_MESSAGE_SIZE.
+//
+class PipeConnection : public IConnection
+{
+public:
+	explicit PipeConnection(void *hPipe);
+	~PipeConnection();
+
+	bool send(const char *data, uint32_t length) override;
+	bool receive(std::vector<char>& message) override;
+	void shutdown() override;
+
+	bool retryable() const override;
+
+private:
+	PipeConnection(const PipeConnection&);
+	PipeConnection& operator=(const PipeConnection&);
+
+	bool readRemainder(std::vector<char>& message, unsigned long dwRead);
+
+	void *m_hPipe;
+	void *m_hSendEvent;
+	void *m_hReceiveEvent;
+	void *m_hShutdownEvent;
+};
+
 class PipeClient
 {
 public:
 	PipeClient(Serializer& serializerIn, Serializer& serializerOut);
+	PipeClient(Serializer& serializerIn);
 
 	bool success() const;
 private:
 	bool m_bSuccess;
-};
\ No newline at end of file
+};
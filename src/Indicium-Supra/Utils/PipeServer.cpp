@@ -1,176 +1,330 @@
 #include "PipeServer.h"
 #include "Serializer.h"
 
-#include <Shared/Config.h>
+#include <Shared/PipeMessages.h>
 
 #include <boost/thread.hpp>
 
-#define CONNECTING_STATE	0 
-#define READING_STATE		1 
-#define WRITING_STATE		2 
+#define CONNECTING_STATE	0
+#define READING_STATE		1
+#define WRITING_STATE		2
+#define DISPATCHING_STATE	3
 
-BOOL PipeServer::connectToNewClient(HANDLE hPipe, LPOVERLAPPED lpo)
+// Completion key of the packet that stops the I/O thread
+#define QUIT_KEY			0
+#define PIPE_DRAIN_TIMEOUT	100
+
+PipeServer::PipeServer(const std::string& name, Callback func, SessionCallback closed) :
+m_dwListening(0), m_hPort(NULL), m_pfnClientProcessId(NULL), m_thread(0), m_cbCallback(func), m_cbClosed(closed)
 {
-	BOOL fConnected, fPendingIO = FALSE;
+	// Looked up at runtime, importing it would keep the XP builds from loading
+	m_pfnClientProcessId = reinterpret_cast<GETCLIENTPROCESSID>(GetProcAddress(GetModuleHandleA("kernel32.dll"), "GetNamedPipeClientProcessId"));
+
+	memset(m_szPipe, 0, sizeof(m_szPipe));
+	sprintf_s(m_szPipe, "\\\\.\\pipe\\%s", name.c_str());
 
-	fConnected = ConnectNamedPipe(hPipe, lpo);
+	m_hPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+	if (m_hPort == NULL)
+		return;
 
-	if (fConnected)
-		return 0;
+	m_workers.reset(new WorkerPool(max(1u, min(boost::thread::hardware_concurrency(), static_cast<unsigned int>(MAX_WORKERS)))));
+
+	for (int i = 0; i < MIN_LISTENERS; i++)
+		createInstance();
+
+	m_thread = new boost::thread(boost::bind(&PipeServer::thread, this));
+}
+
+PipeServer::~PipeServer(void)
+{
+	if (m_thread)
+	{
+		PostQueuedCompletionStatus(m_hPort, 0, QUIT_KEY, NULL);
+		if (m_thread->joinable())
+			m_thread->join();
+		delete m_thread;
+		m_thread = NULL;
+	}
+
+	// Workers still in a callback post their completion to the port, so it has to outlive them
+	m_workers.reset();
+
+	// Closing a pipe aborts its pending I/O; wait for those packets before freeing the OVERLAPPEDs
+	for (auto lpPipe : m_Pipes)
+		CloseHandle(lpPipe->m_hPipe);
+
+	DWORD dwBytes;
+	ULONG_PTR ulKey;
+	LPOVERLAPPED lpOverlapped;
+	while (GetQueuedCompletionStatus(m_hPort, &dwBytes, &ulKey, &lpOverlapped, PIPE_DRAIN_TIMEOUT) || lpOverlapped != NULL)
+		;
+
+	for (auto lpPipe : m_Pipes)
+		delete lpPipe;
+	m_Pipes.clear();
+
+	if (m_hPort)
+		CloseHandle(m_hPort);
+}
+
+bool PipeServer::createInstance()
+{
+	if (m_Pipes.size() >= MAX_CLIENTS)
+		return false;
+
+	auto hPipe = CreateNamedPipeA(m_szPipe, PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED, PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
+		PIPE_UNLIMITED_INSTANCES, BUFSIZE, BUFSIZE, PIPE_TIMEOUT, NULL);
+
+	if (hPipe == INVALID_HANDLE_VALUE)
+		return false;
+
+	auto lpPipe = new PIPEINSTANCE;
+	memset(&lpPipe->m_Overlapped, 0, sizeof(OVERLAPPED));
+	lpPipe->m_hPipe = hPipe;
+	lpPipe->m_request.resize(BUFSIZE);
+	lpPipe->m_reply.resize(BUFSIZE);
+	lpPipe->m_dwRead = lpPipe->m_dwToWrite = lpPipe->m_dwState = 0;
+	lpPipe->m_fReply = FALSE;
+	lpPipe->m_session = NoSession;
+
+	if (CreateIoCompletionPort(hPipe, m_hPort, reinterpret_cast<ULONG_PTR>(lpPipe), 0) != m_hPort)
+	{
+		CloseHandle(hPipe);
+		delete lpPipe;
+		return false;
+	}
+
+	m_Pipes.insert(lpPipe);
+	return connectToNewClient(lpPipe);
+}
+
+bool PipeServer::connectToNewClient(LPPIPEINSTANCE lpPipe)
+{
+	memset(&lpPipe->m_Overlapped, 0, sizeof(OVERLAPPED));
+	lpPipe->m_dwState = CONNECTING_STATE;
+	m_dwListening++;
+
+	if (ConnectNamedPipe(lpPipe->m_hPipe, &lpPipe->m_Overlapped))
+		return true;
 
 	switch (GetLastError())
 	{
 	case ERROR_IO_PENDING:
-		fPendingIO = TRUE;
 		break;
 
 	case ERROR_PIPE_CONNECTED:
-		if (SetEvent(lpo->hEvent))
-			break;
+		// The client beat us to it and no packet gets queued for that, so queue one ourselves
+		PostQueuedCompletionStatus(m_hPort, 0, reinterpret_cast<ULONG_PTR>(lpPipe), &lpPipe->m_Overlapped);
+		break;
+
 	default:
-	{
-		return 0;
-	}
+		m_dwListening--;
+		closeInstance(lpPipe);
+		return false;
 	}
 
-	return fPendingIO;
+	return true;
 }
 
-void PipeServer::disconnectAndReconnect(DWORD dwIdx)
+void PipeServer::readRequest(LPPIPEINSTANCE lpPipe)
 {
-	DisconnectNamedPipe(m_Pipes[dwIdx].m_hPipe);
-	m_Pipes[dwIdx].m_fPendingIO = connectToNewClient(m_Pipes[dwIdx].m_hPipe, &m_Pipes[dwIdx].m_Overlapped);
-	m_Pipes[dwIdx].m_dwState = m_Pipes[dwIdx].m_fPendingIO ? CONNECTING_STATE : READING_STATE;
+	memset(&lpPipe->m_Overlapped, 0, sizeof(OVERLAPPED));
+	lpPipe->m_dwState = READING_STATE;
+	lpPipe->m_dwRead = 0;
 
+	// Also completes through the port when it succeeds right away, ERROR_MORE_DATA included
+	if (!ReadFile(lpPipe->m_hPipe, lpPipe->m_request.data(), static_cast<DWORD>(lpPipe->m_request.size()), NULL, &lpPipe->m_Overlapped) &&
+		GetLastError() != ERROR_IO_PENDING && GetLastError() != ERROR_MORE_DATA)
+		disconnectAndReconnect(lpPipe);
 }
-PipeServer::PipeServer(boost::function<void(Serializer&, Serializer&)> func) : m_cbCallback(func), m_thread(0)
+
+void PipeServer::readRemainder(LPPIPEINSTANCE lpPipe)
 {
-	memset(m_szPipe, 0, sizeof(m_szPipe));
-	memset(m_Pipes, 0, sizeof(m_Pipes));
+	// The pipe knows how much of the message is left, so the buffer grows only once
+	DWORD dwLeft = 0;
+	if (!PeekNamedPipe(lpPipe->m_hPipe, NULL, 0, NULL, NULL, &dwLeft) || dwLeft == 0 || lpPipe->m_dwRead + dwLeft > MAX_MESSAGE_SIZE)
+	{
+		disconnectAndReconnect(lpPipe);
+		return;
+	}
+
+	if (lpPipe->m_request.size() < lpPipe->m_dwRead + dwLeft)
+		lpPipe->m_request.resize(lpPipe->m_dwRead + dwLeft);
 
-	sprintf_s(m_szPipe, "\\\\.\\pipe\\%s", g_strPipeName);
+	memset(&lpPipe->m_Overlapped, 0, sizeof(OVERLAPPED));
 
-	for (int i = 0; i < MAX_CLIENTS; i++)
+	if (!ReadFile(lpPipe->m_hPipe, lpPipe->m_request.data() + lpPipe->m_dwRead, dwLeft, NULL, &lpPipe->m_Overlapped) &&
+		GetLastError() != ERROR_IO_PENDING && GetLastError() != ERROR_MORE_DATA)
+		disconnectAndReconnect(lpPipe);
+}
+
+void PipeServer::writeReply(LPPIPEINSTANCE lpPipe)
+{
+	memset(&lpPipe->m_Overlapped, 0, sizeof(OVERLAPPED));
+	lpPipe->m_dwState = WRITING_STATE;
+
+	if (!WriteFile(lpPipe->m_hPipe, lpPipe->m_reply.data(), lpPipe->m_dwToWrite, NULL, &lpPipe->m_Overlapped) && GetLastError() != ERROR_IO_PENDING)
+		disconnectAndReconnect(lpPipe);
+}
+
+void PipeServer::disconnectAndReconnect(LPPIPEINSTANCE lpPipe)
+{
+	// The client is gone, let its objects go with it
+	if (lpPipe->m_session != NoSession)
 	{
-		m_hEvents[i] = CreateEvent(NULL, TRUE, TRUE, NULL);
-		m_Pipes[i].m_Overlapped.hEvent = m_hEvents[i];
-		m_Pipes[i].m_hPipe = CreateNamedPipeA(m_szPipe, PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED, PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
-			MAX_CLIENTS, BUFSIZE, BUFSIZE, PIPE_TIMEOUT, NULL);
+		closeSession(lpPipe->m_session);
+		if (m_cbClosed)
+			m_cbClosed(lpPipe->m_session);
 
-		m_Pipes[i].m_fPendingIO = connectToNewClient(m_Pipes[i].m_hPipe, &m_Pipes[i].m_Overlapped);
-		m_Pipes[i].m_dwState = m_Pipes[i].m_fPendingIO ? CONNECTING_STATE : READING_STATE;
+		lpPipe->m_session = NoSession;
 	}
 
-	m_thread = new boost::thread(boost::bind(&PipeServer::thread, this));
-}
+	DisconnectNamedPipe(lpPipe->m_hPipe);
 
+	// Don't keep a large message's buffers around for the next client
+	if (lpPipe->m_request.size() > BUFSIZE)
+		std::vector<char>(BUFSIZE).swap(lpPipe->m_request);
+	if (lpPipe->m_reply.size() > BUFSIZE)
+		std::vector<char>(BUFSIZE).swap(lpPipe->m_reply);
 
-PipeServer::~PipeServer(void)
-{
-	if (m_thread)
+	// Enough instances are waiting for clients already, shrink back
+	if (m_dwListening >= MIN_LISTENERS)
 	{
-		m_thread->interrupt();
-		if (m_thread->joinable())
-			m_thread->join();
-		delete m_thread;
-		m_thread = NULL;
+		closeInstance(lpPipe);
+		return;
 	}
+
+	connectToNewClient(lpPipe);
 }
 
-void PipeServer::thread()
+void PipeServer::closeInstance(LPPIPEINSTANCE lpPipe)
 {
-	BOOL bSuccess;
-	DWORD dwRet;
+	m_Pipes.erase(lpPipe);
+	CloseHandle(lpPipe->m_hPipe);
+	delete lpPipe;
+}
 
+void PipeServer::thread()
+{
 	while (true)
 	{
-		boost::this_thread::interruption_point();
+		DWORD dwBytes = 0;
+		ULONG_PTR ulKey = 0;
+		LPOVERLAPPED lpOverlapped = NULL;
 
-		DWORD dwWait = WaitForMultipleObjects(MAX_CLIENTS, m_hEvents, FALSE, INFINITE);
+		BOOL bSuccess = GetQueuedCompletionStatus(m_hPort, &dwBytes, &ulKey, &lpOverlapped, INFINITE);
+		DWORD dwError = bSuccess ? ERROR_SUCCESS : GetLastError();
 
-		int idx = dwWait - WAIT_OBJECT_0;
-		if (idx < 0 || idx >(MAX_CLIENTS - 1))
+		if (ulKey == QUIT_KEY)
+			return;
+
+		auto lpPipe = reinterpret_cast<LPPIPEINSTANCE>(ulKey);
+
+		// Packets without an OVERLAPPED come from a worker that finished the request
+		if (lpOverlapped == NULL)
+		{
+			if (lpPipe->m_fReply)
+				writeReply(lpPipe);
+			else
+				readRequest(lpPipe);
 			continue;
+		}
+
+		completed(lpPipe, dwError, dwBytes);
+	}
+}
 
-		if (m_Pipes[idx].m_fPendingIO)
+DWORD PipeServer::clientProcessId(LPPIPEINSTANCE lpPipe)
+{
+	ULONG ulProcessId = 0;
+	if (m_pfnClientProcessId == NULL || !m_pfnClientProcessId(lpPipe->m_hPipe, &ulProcessId))
+		return 0;
+
+	return ulProcessId;
+}
+
+void PipeServer::completed(LPPIPEINSTANCE lpPipe, DWORD dwError, DWORD dwBytes)
+{
+	switch (lpPipe->m_dwState)
+	{
+	case CONNECTING_STATE:
+		m_dwListening--;
+
+		if (dwError != ERROR_SUCCESS)
 		{
-			bSuccess = GetOverlappedResult(m_Pipes[idx].m_hPipe, &m_Pipes[idx].m_Overlapped, &dwRet, FALSE);
-
-			switch (m_Pipes[idx].m_dwState)
-			{
-			case CONNECTING_STATE:
-				if (!bSuccess)
-					return;
-				m_Pipes[idx].m_dwState = READING_STATE;
-				break;
-			case READING_STATE:
-				if (!bSuccess || dwRet == 0)
-				{
-					disconnectAndReconnect(idx);
-					continue;
-				}
-				m_Pipes[idx].m_dwRead = dwRet;
-				m_Pipes[idx].m_dwState = WRITING_STATE;
-				break;
-			case WRITING_STATE:
-				if (!bSuccess || dwRet != m_Pipes[idx].m_dwToWrite)
-				{
-					disconnectAndReconnect(idx);
-					continue;
-				}
-				m_Pipes[idx].m_dwState = READING_STATE;
-				break;
-			default:
-				return;
-			}
+			disconnectAndReconnect(lpPipe);
+			break;
 		}
 
-		switch (m_Pipes[idx].m_dwState)
+		// Keep enough instances listening for the next clients of a burst
+		while (m_dwListening < MIN_LISTENERS && createInstance())
+			;
+
+		// Sessions are per connection either way; one of an unknown process (0) only never gets the shared ring
+		lpPipe->m_session = openSession(clientProcessId(lpPipe));
+
+		readRequest(lpPipe);
+		break;
+
+	case READING_STATE:
+		// Only part of a message larger than the buffer came in
+		if (dwError == ERROR_MORE_DATA)
 		{
+			lpPipe->m_dwRead += dwBytes;
+			readRemainder(lpPipe);
+			break;
+		}
 
-		case READING_STATE:
-			bSuccess = ReadFile(m_Pipes[idx].m_hPipe, m_Pipes[idx].m_szRequest, BUFSIZE, &m_Pipes[idx].m_dwRead, &m_Pipes[idx].m_Overlapped);
-
-			if (bSuccess && m_Pipes[idx].m_dwRead != 0)
-			{
-				m_Pipes[idx].m_fPendingIO = FALSE;
-				m_Pipes[idx].m_dwState = WRITING_STATE;
-				continue;
-			}
-			if (!bSuccess && (GetLastError() == ERROR_IO_PENDING))
-			{
-				m_Pipes[idx].m_fPendingIO = TRUE;
-				continue;
-			}
-			disconnectAndReconnect(idx);
+		if (dwError != ERROR_SUCCESS || lpPipe->m_dwRead + dwBytes == 0)
+		{
+			disconnectAndReconnect(lpPipe);
 			break;
-		case WRITING_STATE:
-			Serializer serializerIn(m_Pipes[idx].m_szRequest, m_Pipes[idx].m_dwRead);
-			Serializer serializerOut;
-
-			m_cbCallback(serializerIn, serializerOut);
-
-			memset(m_Pipes[idx].m_szReply, 0, BUFSIZE);
-			memset(m_Pipes[idx].m_szRequest, 0, BUFSIZE);
-			memcpy(m_Pipes[idx].m_szReply, serializerOut.data(), serializerOut.numberOfBytesUsed());
-
-			m_Pipes[idx].m_dwToWrite = serializerOut.numberOfBytesUsed();
-
-			bSuccess = WriteFile(m_Pipes[idx].m_hPipe, m_Pipes[idx].m_szReply, m_Pipes[idx].m_dwToWrite, &dwRet, &m_Pipes[idx].m_Overlapped);
-			if (bSuccess && dwRet == m_Pipes[idx].m_dwToWrite)
-			{
-				m_Pipes[idx].m_fPendingIO = FALSE;
-				m_Pipes[idx].m_dwState = READING_STATE;
-				continue;
-			}
-			if (!bSuccess && GetLastError() == ERROR_IO_PENDING)
-			{
-				m_Pipes[idx].m_fPendingIO = true;
-				continue;
-			}
-			disconnectAndReconnect(idx);
+		}
+
+		// No further request is read from this client before the reply went out, which keeps its order
+		lpPipe->m_dwRead += dwBytes;
+		lpPipe->m_dwState = DISPATCHING_STATE;
+		m_workers->submit(boost::bind(&PipeServer::dispatch, this, lpPipe));
+		break;
+
+	case WRITING_STATE:
+		if (dwError != ERROR_SUCCESS || dwBytes != lpPipe->m_dwToWrite)
+		{
+			disconnectAndReconnect(lpPipe);
 			break;
 		}
+
+		readRequest(lpPipe);
+		break;
 	}
 }
 
+void PipeServer::dispatch(LPPIPEINSTANCE lpPipe)
+{
+	// Decode in place from the request buffer and encode straight into the reply buffer
+	Serializer serializerIn(lpPipe->m_request.data(), lpPipe->m_dwRead);
+	Serializer serializerOut;
+	serializerOut.setOutputBuffer(lpPipe->m_reply.data(), lpPipe->m_reply.size());
+
+	{
+		SessionScope scope(lpPipe->m_session);
+		m_cbCallback(serializerIn, serializerOut);
+	}
+
+	// Fire-and-forget request: the I/O thread goes straight back to reading
+	PipeMessages eMessage;
+	Serializer(lpPipe->m_request.data(), lpPipe->m_dwRead) >> eMessage;
+
+	// A reply that outgrew the buffer was written to the serializer's own storage
+	lpPipe->m_fReply = wantsReply(eMessage);
+	lpPipe->m_dwToWrite = serializerOut.numberOfBytesUsed();
+	if (serializerOut.data() != lpPipe->m_reply.data())
+		lpPipe->m_reply.assign(serializerOut.data(), serializerOut.data() + lpPipe->m_dwToWrite);
+
+	PostQueuedCompletionStatus(m_hPort, 0, reinterpret_cast<ULONG_PTR>(lpPipe), NULL);
+}
+
+std::unique_ptr<IListener> createListener(const std::string& name, IListener::Callback callback, IListener::SessionCallback closed)
+{
+	return std::unique_ptr<IListener>(new PipeServer(name, callback, closed));
+}
@@ -1,45 +1,81 @@
 #pragma once
 #include "Windows.h"
+#include "Transport.h"
+#include "WorkerPool.h"
 
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
-#define MAX_CLIENTS		16
+#include <memory>
+#include <set>
+#include <vector>
+
+#define MIN_LISTENERS	4
+#define MAX_CLIENTS		1024
 #define BUFSIZE			4096
 #define PIPE_TIMEOUT	5000
+#define MAX_WORKERS		4
 
 namespace boost { class thread; }
 class Serializer;
 
-class PipeServer
+//
+// Pipe instances are created on demand and driven by a single I/O completion
+// port: there are always MIN_LISTENERS instances waiting for a connection, and
+// instances beyond that are closed again when their client goes away.
+// Messages larger than BUFSIZE arrive in several reads and are put back together
+// in the instance's buffers, which are reused for every request of its client.
+//
+class PipeServer : public IListener
 {
 	typedef struct
 	{
 		OVERLAPPED	m_Overlapped;
 		HANDLE		m_hPipe;
-		char		m_szRequest[BUFSIZE],
-					m_szReply[BUFSIZE];
+		std::vector<char>	m_request,
+							m_reply;
 		DWORD		m_dwRead,
 					m_dwToWrite,
 					m_dwState;
-		BOOL		m_fPendingIO;
+		BOOL		m_fReply;
+		SessionId	m_session;
 	} PIPEINSTANCE, *LPPIPEINSTANCE;
 
+	typedef BOOL (WINAPI *GETCLIENTPROCESSID)(HANDLE, PULONG);
+
 public:
-	PipeServer(boost::function<void(Serializer&, Serializer&)> func);
+	PipeServer(const std::string& name, Callback func, SessionCallback closed);
 	~PipeServer();
 
 private:
 	void thread();
-	BOOL connectToNewClient(HANDLE hPipe, LPOVERLAPPED lpo);
-	void disconnectAndReconnect(DWORD dwIdx);
 
-	PIPEINSTANCE m_Pipes[MAX_CLIENTS];
-	HANDLE m_hEvents[MAX_CLIENTS];
+	bool createInstance();
+	bool connectToNewClient(LPPIPEINSTANCE lpPipe);
+	void readRequest(LPPIPEINSTANCE lpPipe);
+	void readRemainder(LPPIPEINSTANCE lpPipe);
+	void writeReply(LPPIPEINSTANCE lpPipe);
+	void disconnectAndReconnect(LPPIPEINSTANCE lpPipe);
+	void closeInstance(LPPIPEINSTANCE lpPipe);
+
+	void completed(LPPIPEINSTANCE lpPipe, DWORD dwError, DWORD dwBytes);
+	DWORD clientProcessId(LPPIPEINSTANCE lpPipe);
+	void dispatch(LPPIPEINSTANCE lpPipe);
+
+	// Only touched by the I/O thread
+	std::set<LPPIPEINSTANCE> m_Pipes;
+	DWORD m_dwListening;
 
+	HANDLE m_hPort;
 	char m_szPipe[MAX_PATH];
 
+	// GetNamedPipeClientProcessId, null before Vista
+	GETCLIENTPROCESSID m_pfnClientProcessId;
+
 	boost::thread *m_thread;
-	boost::function<void(Serializer&, Serializer&)> m_cbCallback;
-};
+	Callback m_cbCallback;
+	SessionCallback m_cbClosed;
 
+	// Runs the callbacks, so a slow request only holds up its own client
+	std::unique_ptr<WorkerPool> m_workers;
+};
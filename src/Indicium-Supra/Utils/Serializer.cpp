@@ -1,36 +1,156 @@
 #include "Serializer.h"
 
 Serializer::Serializer()
+	: _out(nullptr), _capacity(0), _used(0), _in(nullptr), _length(0), _pos(0), _good(true)
 {
-	_oa = safeMakeShared<oarchive>(_ss);
 }
 
-Serializer::Serializer(const char * const _data, const unsigned int len) : _ss(std::string(_data, len))
+Serializer::Serializer(const char * const _data, const unsigned int len)
+	: _out(nullptr), _capacity(0), _used(0), _in(_data), _length(len), _pos(0), _good(true)
 {
-	_ia = safeMakeShared<iarchive>(_ss);
 }
 
 Serializer::~Serializer()
 {
-	safeExecute([&](){
-		_oa.reset();
-		_ia.reset();
-	});
 }
 
 const char * Serializer::data()
 {
-	_ss_str = _ss.str();
-	return _ss_str.c_str();
+	if (_out)
+		return _out;
+
+	return _buffer.empty() ? nullptr : _buffer.data();
 }
 
 void Serializer::setData(const char *szData, const size_t size)
 {
-	_ss = std::stringstream(std::string(szData, size));
-	_ia = safeMakeShared<iarchive>(_ss);
+	// The only copy on the receiving side: the caller's buffer usually doesn't outlive us
+	_buffer.assign(szData, szData + size);
+
+	_in = _buffer.empty() ? nullptr : _buffer.data();
+	_length = size;
+	_pos = 0;
+	_good = true;
+}
+
+void Serializer::setOutputBuffer(char *buffer, const size_t capacity)
+{
+	_out = buffer;
+	_capacity = capacity;
+	_used = 0;
+}
+
+void Serializer::reserve(const size_t size)
+{
+	if (!_out)
+		_buffer.reserve(size);
+}
+
+void Serializer::clear()
+{
+	_used = 0;
+
+	if (!_out)
+		_buffer.clear();
 }
 
 int Serializer::numberOfBytesUsed() const
 {
-	return static_cast<int>(_ss.str().length());
+	return static_cast<int>(_used);
+}
+
+int Serializer::numberOfBytesLeft() const
+{
+	return static_cast<int>(_length - _pos);
+}
+
+const char *Serializer::unread() const
+{
+	return _in ? _in + _pos : nullptr;
+}
+
+bool Serializer::good() const
+{
+	return _good;
+}
+
+Serializer& Serializer::operator<<(const std::string& str)
+{
+	*this << static_cast<uint32_t>(str.length());
+	writeBytes(str.data(), str.length());
+	return *this;
+}
+
+Serializer& Serializer::operator>>(std::string& str)
+{
+	SERIALIZATION_READ(*this, uint32_t, length);
+
+	if (length > static_cast<uint32_t>(numberOfBytesLeft()))
+	{
+		str.clear();
+		_good = false;
+		return *this;
+	}
+
+	str.assign(_in + _pos, length);
+	_pos += length;
+	return *this;
+}
+
+void Serializer::writeBytes(const void *src, const size_t size)
+{
+	if (size == 0)
+		return;
+
+	memcpy(grow(size), src, size);
+}
+
+bool Serializer::readBytes(void *dst, const size_t size)
+{
+	if (_pos + size > _length)
+	{
+		_good = false;
+		return false;
+	}
+
+	memcpy(dst, _in + _pos, size);
+	_pos += size;
+	return true;
+}
+
+const char *Serializer::readInPlace(const size_t size)
+{
+	if (_pos + size > _length)
+	{
+		_good = false;
+		return nullptr;
+	}
+
+	auto src = _in + _pos;
+	_pos += size;
+	return src;
+}
+
+char *Serializer::grow(const size_t size)
+{
+	if (_out)
+	{
+		if (_used + size <= _capacity)
+		{
+			char *dst = _out + _used;
+			_used += size;
+			return dst;
+		}
+
+		// Caller's buffer is exhausted, continue in owned storage
+		_buffer.assign(_out, _out + _used);
+		_out = nullptr;
+		_capacity = 0;
+	}
+
+	_buffer.resize(_used + size);
+
+	char *dst = _buffer.data() + _used;
+	_used += size;
+	return dst;
 }
@@ -1,25 +1,56 @@
 #pragma once
-#include "SafeBlock.h"
-
-#include <boost/archive/text_oarchive.hpp>
-#include <boost/archive/text_iarchive.hpp>
-
-#include <sstream>
 #include <string>
-#include <memory>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
 
 #define SERIALIZATION_READ(S, T, V) T V; S >> V;
 
+//
+// Compact binary wire format: integral and enum values are written as little-endian
+// fixed-width fields, floats by their IEEE bit pattern, strings and vectors with
+// a 32-bit element count in front.
+//
 class Serializer
 {
-	typedef boost::archive::text_iarchive iarchive;
-	typedef boost::archive::text_oarchive oarchive;
+	struct integral_tag {};
+	struct floating_tag {};
+	struct boolean_tag {};
 
-	std::shared_ptr<oarchive> _oa;
-	std::shared_ptr<iarchive> _ia;
+	template<class T>
+	struct category
+	{
+		typedef typename std::conditional<std::is_same<T, bool>::value, boolean_tag,
+			typename std::conditional<std::is_floating_point<T>::value, floating_tag, integral_tag>::type>::type type;
+	};
 
-	std::stringstream _ss;
-	std::string _ss_str;
+	template<class T, bool = std::is_enum<T>::value>
+	struct wire_type
+	{
+		typedef typename std::make_unsigned<T>::type type;
+	};
+
+	template<class T>
+	struct wire_type<T, true>
+	{
+		typedef typename std::make_unsigned<typename std::underlying_type<T>::type>::type type;
+	};
+
+	// owned storage, used when no caller buffer is attached or it overflowed
+	std::vector<char> _buffer;
+
+	// write side
+	char *_out;
+	size_t _capacity;
+	size_t _used;
+
+	// read side (never owns the bytes)
+	const char *_in;
+	size_t _length;
+	size_t _pos;
+
+	bool _good;
 
 public:
 	Serializer();
@@ -30,35 +61,130 @@ public:
 	const char *data();
 	void setData(const char *szData, const size_t size);
 
+	void setOutputBuffer(char *buffer, const size_t capacity);
+	void reserve(const size_t size);
+	void clear();
+
 	int numberOfBytesUsed() const;
+	int numberOfBytesLeft() const;
+
+	// The numberOfBytesLeft() bytes not read yet
+	const char *unread() const;
+
+	bool good() const;
 
 	template<class T>
 	Serializer& operator<<(const T& t)
 	{
-		write<T>(t);
+		write(t, typename category<T>::type());
 		return *this;
 	}
 	template<class T>
 	Serializer& operator>>(T& t)
 	{
-		read<T>(t);
+		read(t, typename category<T>::type());
+		return *this;
+	}
+
+	Serializer& operator<<(const std::string& str);
+	Serializer& operator>>(std::string& str);
+
+	template<class T>
+	Serializer& operator<<(const std::vector<T>& v)
+	{
+		*this << static_cast<uint32_t>(v.size());
+		for (const auto& e : v)
+			*this << e;
+		return *this;
+	}
+	template<class T>
+	Serializer& operator>>(std::vector<T>& v)
+	{
+		SERIALIZATION_READ(*this, uint32_t, count);
+
+		v.clear();
+		for (uint32_t i = 0; i < count && _good; i++)
+		{
+			T e = T();
+			*this >> e;
+			v.push_back(e);
+		}
 		return *this;
 	}
 
+	void writeBytes(const void *src, const size_t size);
+	bool readBytes(void *dst, const size_t size);
+	const char *readInPlace(const size_t size);
+
 private:
+	char *grow(const size_t size);
+
 	template<class T>
-	void write(const T& t)
+	void write(const T& t, integral_tag)
 	{
-		safeExecute([&](){
-			*_oa & t;
-		});
+		static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Serializer: unsupported type");
+
+		typedef typename wire_type<T>::type U;
+
+		auto value = static_cast<U>(t);
+		char *dst = grow(sizeof(T));
+		for (size_t i = 0; i < sizeof(T); i++)
+			dst[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
 	}
 
 	template<class T>
-	void read(T& t)
+	void read(T& t, integral_tag)
 	{
-		safeExecute([&](){
-			*_ia & t;
-		});
+		static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "Serializer: unsupported type");
+
+		typedef typename wire_type<T>::type U;
+
+		if (_pos + sizeof(T) > _length)
+		{
+			t = T();
+			_good = false;
+			return;
+		}
+
+		U value = 0;
+		for (size_t i = 0; i < sizeof(T); i++)
+			value |= static_cast<U>(static_cast<unsigned char>(_in[_pos + i])) << (i * 8);
+
+		_pos += sizeof(T);
+		t = static_cast<T>(value);
+	}
+
+	void write(const bool& b, boolean_tag)
+	{
+		write(static_cast<uint8_t>(b ? 1 : 0), integral_tag());
+	}
+
+	void read(bool& b, boolean_tag)
+	{
+		uint8_t value;
+		read(value, integral_tag());
+		b = value != 0;
+	}
+
+	template<class T>
+	void write(const T& t, floating_tag)
+	{
+		typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type U;
+		static_assert(sizeof(T) == sizeof(U), "Serializer: unsupported floating point type");
+
+		U bits;
+		memcpy(&bits, &t, sizeof(bits));
+		write(bits, integral_tag());
+	}
+
+	template<class T>
+	void read(T& t, floating_tag)
+	{
+		typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type U;
+		static_assert(sizeof(T) == sizeof(U), "Serializer: unsupported floating point type");
+
+		U bits;
+		read(bits, integral_tag());
+		memcpy(&t, &bits, sizeof(t));
 	}
 };
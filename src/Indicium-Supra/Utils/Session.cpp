@@ -0,0 +1,71 @@
+#include "Session.h"
+
+#include <boost/thread/tss.hpp>
+
+#include <map>
+#include <mutex>
+
+namespace
+{
+	// Not __declspec(thread): implicit TLS doesn't work in a DLL loaded at runtime on XP
+	boost::thread_specific_ptr<SessionId> t_current;
+
+	SessionId& current()
+	{
+		if (!t_current.get())
+			t_current.reset(new SessionId(NoSession));
+
+		return *t_current;
+	}
+
+	std::mutex g_sessionMutex;
+	SessionId g_nextSession = NoSession;
+	std::map<SessionId, uint32_t> g_sessions;
+}
+
+SessionId openSession(uint32_t processId)
+{
+	std::lock_guard<std::mutex> l(g_sessionMutex);
+
+	if (++g_nextSession == NoSession)
+		++g_nextSession;
+
+	g_sessions[g_nextSession] = processId;
+	return g_nextSession;
+}
+
+void closeSession(SessionId session)
+{
+	std::lock_guard<std::mutex> l(g_sessionMutex);
+
+	g_sessions.erase(session);
+}
+
+SessionId sessionOfProcess(uint32_t processId)
+{
+	std::lock_guard<std::mutex> l(g_sessionMutex);
+
+	if (processId == 0)
+		return NoSession;
+
+	for (auto it = g_sessions.rbegin(); it != g_sessions.rend(); ++it)
+	if (it->second == processId)
+		return it->first;
+
+	return NoSession;
+}
+
+SessionId currentSession()
+{
+	return current();
+}
+
+SessionScope::SessionScope(SessionId session) : m_previous(current())
+{
+	current() = session;
+}
+
+SessionScope::~SessionScope()
+{
+	current() = m_previous;
+}
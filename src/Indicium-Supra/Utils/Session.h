@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+//
+// A session is one client connection to the server. Handlers find out which one
+// a request came in on through currentSession(); requests that didn't arrive
+// over a connection of a known client run as NoSession.
+//
+typedef uint32_t SessionId;
+const SessionId NoSession = 0;
+
+// Called by the listeners when a client connects and when it goes away
+SessionId openSession(uint32_t processId);
+void closeSession(SessionId session);
+
+// Latest open session of a client process, NoSession if it has none
+SessionId sessionOfProcess(uint32_t processId);
+
+SessionId currentSession();
+
+// Makes session the current one on this thread for the lifetime of the scope
+class SessionScope
+{
+public:
+	explicit SessionScope(SessionId session);
+	~SessionScope();
+
+private:
+	SessionScope(const SessionScope&);
+	SessionScope& operator=(const SessionScope&);
+
+	SessionId m_previous;
+};
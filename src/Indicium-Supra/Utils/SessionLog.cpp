@@ -0,0 +1,125 @@
+#include "SessionLog.h"
+#include "Serializer.h"
+
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/thread.hpp>
+
+#include <set>
+#include <vector>
+
+// time + session + length
+#define RECORD_HEADER_SIZE (sizeof(uint64_t) + 2 * sizeof(uint32_t))
+#define FILE_HEADER_SIZE (2 * sizeof(uint32_t))
+
+namespace
+{
+	uint64_t nowMicros()
+	{
+		return boost::chrono::duration_cast<boost::chrono::microseconds>(boost::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+SessionRecorder::SessionRecorder(const std::string& path) :
+m_file(path.c_str(), std::ios::binary | std::ios::trunc), m_start(nowMicros())
+{
+	char szHeader[FILE_HEADER_SIZE];
+
+	Serializer serializer;
+	serializer.setOutputBuffer(szHeader, sizeof(szHeader));
+	serializer << static_cast<uint32_t>(Magic) << static_cast<uint32_t>(Version);
+
+	m_file.write(szHeader, sizeof(szHeader));
+}
+
+SessionRecorder::~SessionRecorder()
+{
+	m_file.flush();
+}
+
+bool SessionRecorder::isOpen() const
+{
+	return m_file.good();
+}
+
+void SessionRecorder::record(const char *data, uint32_t length)
+{
+	char szHeader[RECORD_HEADER_SIZE];
+
+	Serializer serializer;
+	serializer.setOutputBuffer(szHeader, sizeof(szHeader));
+	serializer << (nowMicros() - m_start) << static_cast<uint32_t>(currentSession()) << length;
+
+	std::lock_guard<std::mutex> l(m_mutex);
+
+	m_file.write(szHeader, sizeof(szHeader));
+	m_file.write(data, length);
+}
+
+IListener::Callback SessionRecorder::wrap(IListener::Callback callback)
+{
+	return boost::bind(&SessionRecorder::recordAndCall, this, callback, _1, _2);
+}
+
+void SessionRecorder::recordAndCall(IListener::Callback& callback, Serializer& serializerIn, Serializer& serializerOut)
+{
+	record(serializerIn.unread(), static_cast<uint32_t>(serializerIn.numberOfBytesLeft()));
+	callback(serializerIn, serializerOut);
+}
+
+int replaySession(const std::string& path, IListener::Callback callback, ReplaySpeed speed, IListener::SessionCallback closed)
+{
+	std::ifstream file(path.c_str(), std::ios::binary);
+
+	char szHeader[RECORD_HEADER_SIZE];
+	if (!file.read(szHeader, FILE_HEADER_SIZE))
+		return -1;
+
+	uint32_t magic, version;
+	Serializer(szHeader, FILE_HEADER_SIZE) >> magic >> version;
+
+	if (magic != SessionRecorder::Magic || version != SessionRecorder::Version)
+		return -1;
+
+	auto start = boost::chrono::steady_clock::now();
+	std::set<SessionId> sessions;
+	std::vector<char> request;
+	int count = 0;
+
+	while (file.read(szHeader, RECORD_HEADER_SIZE))
+	{
+		uint64_t micros;
+		uint32_t session, length;
+		Serializer(szHeader, RECORD_HEADER_SIZE) >> micros >> session >> length;
+
+		if (length > MAX_MESSAGE_SIZE)
+			break;
+
+		request.resize(length);
+		if (length > 0 && !file.read(request.data(), length))
+			break;
+
+		if (speed == ReplaySpeed::Original)
+			boost::this_thread::sleep_until(start + boost::chrono::microseconds(micros));
+
+		Serializer serializerIn(request.data(), length);
+		Serializer serializerOut;
+
+		{
+			SessionScope scope(session);
+			callback(serializerIn, serializerOut);
+		}
+
+		sessions.insert(session);
+		count++;
+	}
+
+	if (closed)
+	{
+		for (auto session : sessions)
+		if (session != NoSession)
+			closed(session);
+	}
+
+	return count;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Transport.h"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+//
+// Capture of the requests a server receives, for replaying the exact load of a
+// real session against another build. The log starts with Magic and Version,
+// followed by one record per request: microseconds since the capture started
+// (uint64), session (uint32), length (uint32) and the request bytes, all in the
+// Serializer's byte order.
+//
+class SessionRecorder
+{
+public:
+	enum : uint32_t
+	{
+		Magic = 0x474C5349,		// 'ISLG'
+		Version = 1
+	};
+
+	explicit SessionRecorder(const std::string& path);
+	~SessionRecorder();
+
+	bool isOpen() const;
+
+	// Logs a request under currentSession()
+	void record(const char *data, uint32_t length);
+
+	// Callback that records every request before handing it on
+	IListener::Callback wrap(IListener::Callback callback);
+
+private:
+	SessionRecorder(const SessionRecorder&);
+	SessionRecorder& operator=(const SessionRecorder&);
+
+	void recordAndCall(IListener::Callback& callback, Serializer& serializerIn, Serializer& serializerOut);
+
+	std::ofstream m_file;
+	uint64_t m_start;
+	std::mutex m_mutex;
+};
+
+enum class ReplaySpeed
+{
+	Original,		// keeps the recorded gaps between requests
+	Fast			// sends the next request as soon as the previous one returned
+};
+
+// Feeds every request of a log to callback, each under its recorded session. The
+// sessions are reported to closed at the end, as if their clients had gone away.
+// Returns the number of requests replayed, -1 if the file isn't a session log.
+int replaySession(const std::string& path, IListener::Callback callback, ReplaySpeed speed,
+	IListener::SessionCallback closed = IListener::SessionCallback());
@@ -0,0 +1,169 @@
+#include "SharedMemory.h"
+
+#ifdef _WIN32
+#include "Windows.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+SharedMemory::SharedMemory()
+	: _handle(nullptr), _data(nullptr), _size(0), _owner(false)
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool SharedMemory::create(const std::string& name, size_t size)
+{
+	close();
+
+	auto hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), name.c_str());
+	if (hMapping == nullptr)
+		return false;
+
+	auto pView = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (pView == nullptr)
+	{
+		CloseHandle(hMapping);
+		return false;
+	}
+
+	_handle = hMapping;
+	_data = pView;
+	_size = size;
+	_owner = true;
+	_name = name;
+	return true;
+}
+
+bool SharedMemory::open(const std::string& name, size_t size)
+{
+	close();
+
+	auto hMapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+	if (hMapping == nullptr)
+		return false;
+
+	auto pView = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (pView == nullptr)
+	{
+		CloseHandle(hMapping);
+		return false;
+	}
+
+	_handle = hMapping;
+	_data = pView;
+	_size = size;
+	_owner = false;
+	_name = name;
+	return true;
+}
+
+void SharedMemory::close()
+{
+	if (_data)
+		UnmapViewOfFile(_data);
+
+	if (_handle)
+		CloseHandle(_handle);
+
+	_handle = nullptr;
+	_data = nullptr;
+	_size = 0;
+	_owner = false;
+}
+
+#else
+
+bool SharedMemory::create(const std::string& name, size_t size)
+{
+	close();
+
+	auto path = "/" + name;
+	int fd = shm_open(path.c_str(), O_CREAT | O_RDWR, 0600);
+	if (fd < 0)
+		return false;
+
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+	{
+		::close(fd);
+		shm_unlink(path.c_str());
+		return false;
+	}
+
+	auto pView = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (pView == MAP_FAILED)
+	{
+		shm_unlink(path.c_str());
+		return false;
+	}
+
+	_data = pView;
+	_size = size;
+	_owner = true;
+	_name = name;
+	return true;
+}
+
+bool SharedMemory::open(const std::string& name, size_t size)
+{
+	close();
+
+	auto path = "/" + name;
+	int fd = shm_open(path.c_str(), O_RDWR, 0600);
+	if (fd < 0)
+		return false;
+
+	auto pView = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (pView == MAP_FAILED)
+		return false;
+
+	_data = pView;
+	_size = size;
+	_owner = false;
+	_name = name;
+	return true;
+}
+
+void SharedMemory::close()
+{
+	if (_data)
+		munmap(_data, _size);
+
+	if (_owner)
+		shm_unlink(("/" + _name).c_str());
+
+	_handle = nullptr;
+	_data = nullptr;
+	_size = 0;
+	_owner = false;
+}
+
+#endif
+
+void *SharedMemory::data() const
+{
+	return _data;
+}
+
+size_t SharedMemory::size() const
+{
+	return _size;
+}
+
+bool SharedMemory::isOpen() const
+{
+	return _data != nullptr;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+
+//
+// Named shared memory section. Backed by a pagefile mapping on Windows and by
+// POSIX shm elsewhere, so code built on top of it can be exercised outside a game.
+//
+class SharedMemory
+{
+public:
+	SharedMemory();
+	~SharedMemory();
+
+	bool create(const std::string& name, size_t size);
+	bool open(const std::string& name, size_t size);
+	void close();
+
+	void *data() const;
+	size_t size() const;
+
+	bool isOpen() const;
+
+private:
+	SharedMemory(const SharedMemory&);
+	SharedMemory& operator=(const SharedMemory&);
+
+	void *_handle;
+	void *_data;
+	size_t _size;
+	bool _owner;
+	std::string _name;
+};
@@ -0,0 +1,195 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+//
+// Lock-free single-producer/single-consumer ring of length-prefixed records,
+// laid out in a caller-provided memory block (usually a SharedMemory section).
+// Positions are free-running 32-bit counters, the data capacity is a power of two.
+//
+class SharedRing
+{
+	enum : uint32_t
+	{
+		Magic = 0x474E4952,		// 'RING'
+		WrapMarker = 0xFFFFFFFF,
+		CacheLine = 64
+	};
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t capacity;
+		std::atomic<uint32_t> producer;
+		char pad0[CacheLine - 3 * sizeof(uint32_t)];
+		std::atomic<uint32_t> head;
+		char pad1[CacheLine - sizeof(uint32_t)];
+		std::atomic<uint32_t> tail;
+		char pad2[CacheLine - sizeof(uint32_t)];
+	};
+
+	Header *_header;
+	char *_data;
+	// Copied on attach, the other side can't change it under us
+	uint32_t _capacity;
+
+	static uint32_t recordSize(uint32_t length)
+	{
+		return (sizeof(uint32_t) + length + 3) & ~3u;
+	}
+
+public:
+	static size_t requiredSize(uint32_t capacity)
+	{
+		return sizeof(Header) + capacity;
+	}
+
+	SharedRing() : _header(nullptr), _data(nullptr), _capacity(0)
+	{
+	}
+
+	// The consumer initializes the block, producers attach to an initialized one
+	bool attach(void *memory, size_t size, bool initialize)
+	{
+		_header = nullptr;
+		_data = nullptr;
+
+		if (memory == nullptr || size <= sizeof(Header))
+			return false;
+
+		auto header = static_cast<Header *>(memory);
+
+		if (initialize)
+		{
+			uint32_t capacity = 1;
+			while (capacity <= (size - sizeof(Header)) / 2)
+				capacity <<= 1;
+
+			header->capacity = capacity;
+			header->producer.store(0);
+			header->head.store(0);
+			header->tail.store(0);
+			header->magic = Magic;
+		}
+		else if (header->magic != Magic || header->capacity < CacheLine || (header->capacity & (header->capacity - 1)) ||
+			requiredSize(header->capacity) > size)
+		{
+			return false;
+		}
+
+		_header = header;
+		_data = reinterpret_cast<char *>(header + 1);
+		_capacity = header->capacity;
+		return true;
+	}
+
+	bool isAttached() const
+	{
+		return _header != nullptr;
+	}
+
+	// Only one producer may write at a time; ids are process ids on the client side
+	bool claimProducer(uint32_t id, uint32_t expected = 0)
+	{
+		return _header->producer.compare_exchange_strong(expected, id);
+	}
+
+	void releaseProducer(uint32_t id)
+	{
+		_header->producer.compare_exchange_strong(id, 0);
+	}
+
+	uint32_t producer() const
+	{
+		return _header->producer.load();
+	}
+
+	// Whether every record pushed so far was drained
+	bool empty() const
+	{
+		return _header->head.load(std::memory_order_acquire) == _header->tail.load(std::memory_order_acquire);
+	}
+
+	bool push(const char *src, uint32_t length)
+	{
+		const uint32_t capacity = _capacity;
+
+		if (length > capacity / 2 || recordSize(length) > capacity / 2)
+			return false;
+
+		const uint32_t need = recordSize(length);
+
+		uint32_t head = _header->head.load(std::memory_order_relaxed);
+		const uint32_t tail = _header->tail.load(std::memory_order_acquire);
+
+		uint32_t offset = head & (capacity - 1);
+		const uint32_t contiguous = capacity - offset;
+		const uint32_t total = (contiguous < need) ? contiguous + need : need;
+
+		if (capacity - (head - tail) < total)
+			return false;
+
+		if (contiguous < need)
+		{
+			const uint32_t marker = WrapMarker;
+			memcpy(_data + offset, &marker, sizeof(marker));
+			head += contiguous;
+			offset = 0;
+		}
+
+		memcpy(_data + offset, &length, sizeof(length));
+		memcpy(_data + offset + sizeof(length), src, length);
+
+		_header->head.store(head + need, std::memory_order_release);
+		return true;
+	}
+
+	// Calls consumer(const char *data, uint32_t length) for every pending record
+	template<class Consumer>
+	uint32_t drain(Consumer consumer)
+	{
+		const uint32_t capacity = _capacity;
+
+		uint32_t tail = _header->tail.load(std::memory_order_relaxed);
+		const uint32_t head = _header->head.load(std::memory_order_acquire);
+
+		// The producer is another process: positions and lengths are checked before anything is read
+		if (head - tail > capacity || (tail & 3))
+		{
+			_header->tail.store(head, std::memory_order_release);
+			return 0;
+		}
+
+		uint32_t count = 0;
+		while (tail != head)
+		{
+			const uint32_t offset = tail & (capacity - 1);
+			const uint32_t contiguous = capacity - offset;
+			const uint32_t pending = head - tail;
+
+			uint32_t length;
+			memcpy(&length, _data + offset, sizeof(length));
+
+			if (length == WrapMarker && contiguous <= pending)
+			{
+				tail += contiguous;
+				continue;
+			}
+
+			// A record never wraps; one that would, or that runs past head, can only be garbage; what is left is dropped
+			if (length > contiguous - sizeof(length) || recordSize(length) > contiguous || recordSize(length) > pending)
+			{
+				tail = head;
+				break;
+			}
+
+			consumer(_data + offset + sizeof(length), length);
+			tail += recordSize(length);
+			count++;
+		}
+
+		_header->tail.store(tail, std::memory_order_release);
+		return count;
+	}
+};
@@ -0,0 +1,306 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+//
+// Values stored contiguously and addressed through generational handles. A
+// handle is a non-negative int holding a slot index in its low bits and the
+// slot's generation above; the generation moves on whenever the slot is freed,
+// so a handle outliving its value is rejected instead of reaching the value
+// that reused the slot. Insert, lookup and erase are O(1); erasing moves the
+// last value into the gap, so iteration order is not insertion order.
+//
+template<class T>
+class SlotMap
+{
+	enum class State : uint8_t
+	{
+		Free,
+		Reserved,
+		Used,
+		Retired		// generation ran out, never handed out again
+	};
+
+	struct Slot
+	{
+		uint32_t generation;
+		uint32_t position;	// of the value when Used, the reserve() tag when Reserved
+		State state;
+	};
+
+public:
+	enum : uint32_t
+	{
+		IndexBits = 20,
+		MaxSlots = 1u << IndexBits,
+		MaxGeneration = (1u << (31 - IndexBits)) - 1
+	};
+
+	typedef typename std::vector<T>::iterator iterator;
+
+	SlotMap() : _cursor(0)
+	{
+	}
+
+	// Returns the handle, -1 when all slots are taken
+	int insert(T value)
+	{
+		uint32_t index;
+		if (!popFree(index))
+		{
+			if (_slots.size() >= MaxSlots)
+				return -1;
+
+			index = static_cast<uint32_t>(_slots.size());
+			_slots.push_back(Slot());
+		}
+
+		return place(index, std::move(value));
+	}
+
+	// Sets aside count slots whose handles are consecutive, for insertAt; returns the first or -1
+	int reserve(int count, uint32_t tag)
+	{
+		if (count <= 0 || static_cast<uint32_t>(count) > MaxSlots)
+			return -1;
+
+		uint32_t first;
+		if (!findRun(static_cast<uint32_t>(count), first))
+		{
+			if (_slots.size() + count > MaxSlots)
+				return -1;
+
+			// New slots start free at generation 0
+			first = static_cast<uint32_t>(_slots.size());
+			_slots.resize(_slots.size() + count);
+		}
+
+		// One generation for the whole run: raising a free slot's skips values nobody holds
+		uint32_t generation = 0;
+		for (uint32_t i = first; i < first + count; i++)
+		if (_slots[i].generation > generation)
+			generation = _slots[i].generation;
+
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			_slots[i].generation = generation;
+			_slots[i].position = tag;
+			_slots[i].state = State::Reserved;
+		}
+
+		_reserved[tag] += count;
+		_cursor = first + count;
+		return handle(first, generation);
+	}
+
+	bool insertAt(int id, T value)
+	{
+		auto index = slotOf(id, State::Reserved);
+		if (index == MaxSlots)
+			return false;
+
+		auto tag = _reserved.find(_slots[index].position);
+		if (--tag->second == 0)
+			_reserved.erase(tag);
+
+		place(index, std::move(value));
+		return true;
+	}
+
+	// Frees what reserve() set aside under tag and wasn't used
+	void releaseReserved(uint32_t tag)
+	{
+		if (_reserved.erase(tag) == 0)
+			return;
+
+		for (uint32_t i = 0; i < _slots.size(); i++)
+		if (_slots[i].state == State::Reserved && _slots[i].position == tag)
+			release(i);
+	}
+
+	// Slots reserve() set aside under tag that insertAt hasn't filled yet
+	uint32_t reserved(uint32_t tag) const
+	{
+		auto it = _reserved.find(tag);
+		return it != _reserved.end() ? it->second : 0;
+	}
+
+	T *find(int id)
+	{
+		auto index = slotOf(id, State::Used);
+		if (index == MaxSlots)
+			return nullptr;
+
+		return &_values[_slots[index].position];
+	}
+
+	bool erase(int id)
+	{
+		auto index = slotOf(id, State::Used);
+		if (index == MaxSlots)
+			return false;
+
+		removeAt(_slots[index].position);
+		return true;
+	}
+
+	// Each value is looked at once, removal doesn't skip the one moved into its place
+	template<class Predicate>
+	void eraseIf(Predicate predicate)
+	{
+		for (size_t i = _values.size(); i-- > 0;)
+		if (predicate(_values[i]))
+			removeAt(i);
+	}
+
+	iterator begin()
+	{
+		return _values.begin();
+	}
+
+	iterator end()
+	{
+		return _values.end();
+	}
+
+	bool empty() const
+	{
+		return _values.empty();
+	}
+
+	size_t size() const
+	{
+		return _values.size();
+	}
+
+private:
+	static int handle(uint32_t index, uint32_t generation)
+	{
+		return static_cast<int>((generation << IndexBits) | index);
+	}
+
+	// Index of the slot id refers to if it is in state, MaxSlots otherwise
+	uint32_t slotOf(int id, State state) const
+	{
+		if (id < 0)
+			return MaxSlots;
+
+		auto index = static_cast<uint32_t>(id) & (MaxSlots - 1);
+		auto generation = static_cast<uint32_t>(id) >> IndexBits;
+
+		if (index >= _slots.size() || _slots[index].generation != generation || _slots[index].state != state)
+			return MaxSlots;
+
+		return index;
+	}
+
+	int place(uint32_t index, T value)
+	{
+		auto& slot = _slots[index];
+		slot.state = State::Used;
+		slot.position = static_cast<uint32_t>(_values.size());
+
+		_values.push_back(std::move(value));
+		_indices.push_back(index);
+
+		return handle(index, slot.generation);
+	}
+
+	void removeAt(size_t position)
+	{
+		auto index = _indices[position];
+
+		if (position + 1 != _values.size())
+		{
+			_values[position] = std::move(_values.back());
+			_indices[position] = _indices.back();
+			_slots[_indices[position]].position = static_cast<uint32_t>(position);
+		}
+
+		_values.pop_back();
+		_indices.pop_back();
+
+		release(index);
+	}
+
+	void release(uint32_t index)
+	{
+		auto& slot = _slots[index];
+
+		if (++slot.generation > MaxGeneration)
+		{
+			slot.state = State::Retired;
+			return;
+		}
+
+		slot.state = State::Free;
+
+		// Slots reserve() took stay listed until popped, start over before the list outgrows the table
+		if (_free.size() >= _slots.size())
+		{
+			_free.clear();
+
+			for (uint32_t i = 0; i < _slots.size(); i++)
+			if (_slots[i].state == State::Free && i != index)
+				_free.push_back(i);
+		}
+
+		_free.push_back(index);
+	}
+
+	// The free list may still name slots reserve() took since, those are skipped here
+	bool popFree(uint32_t& index)
+	{
+		while (!_free.empty())
+		{
+			index = _free.back();
+			_free.pop_back();
+
+			if (_slots[index].state == State::Free)
+				return true;
+		}
+
+		return false;
+	}
+
+	// Next fit from where the last reservation ended, so freed runs get used again
+	bool findRun(uint32_t count, uint32_t& first) const
+	{
+		auto size = static_cast<uint32_t>(_slots.size());
+		if (count > size)
+			return false;
+
+		uint32_t run = 0;
+		for (uint32_t n = 0; n < size; n++)
+		{
+			auto index = (_cursor + n) % size;
+
+			// Handles of a run are consecutive, so it can't wrap around
+			if (index == 0)
+				run = 0;
+
+			if (_slots[index].state != State::Free)
+			{
+				run = 0;
+				continue;
+			}
+
+			if (++run == count)
+			{
+				first = index + 1 - count;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::vector<Slot> _slots;
+	std::vector<T> _values;
+	std::vector<uint32_t> _indices;		// slot of each value
+	std::vector<uint32_t> _free;
+	std::map<uint32_t, uint32_t> _reserved;		// outstanding count per reserve() tag
+	uint32_t _cursor;
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//
+// Single-writer mailbox holding the latest overlay status, laid out in a
+// caller-provided memory block (usually a SharedMemory section). Readers never
+// block the writer: they retry when the sequence number shows a write in between.
+//
+class StatusMailbox
+{
+	enum : uint32_t
+	{
+		Magic = 0x54415453,		// 'STAT'
+		ReadRetries = 100
+	};
+
+	struct Header
+	{
+		uint32_t magic;
+		std::atomic<uint32_t> sequence;
+		std::atomic<int32_t> frameRate;
+		std::atomic<int32_t> width;
+		std::atomic<int32_t> height;
+		std::atomic<uint32_t> resets;
+		std::atomic<uint32_t> updates;
+	};
+
+	Header *_header;
+
+public:
+	struct Status
+	{
+		int32_t frameRate;
+		int32_t width;
+		int32_t height;
+		uint32_t resets;		// device resets seen so far
+		uint32_t updates;		// bumped on every publish, stops moving while the game doesn't draw
+	};
+
+	static size_t requiredSize()
+	{
+		return sizeof(Header);
+	}
+
+	StatusMailbox() : _header(nullptr)
+	{
+	}
+
+	// The writer initializes the block, readers attach to an initialized one
+	bool attach(void *memory, size_t size, bool initialize)
+	{
+		_header = nullptr;
+
+		if (memory == nullptr || size < sizeof(Header))
+			return false;
+
+		auto header = static_cast<Header *>(memory);
+
+		if (initialize)
+		{
+			header->sequence.store(0);
+			header->frameRate.store(0);
+			header->width.store(0);
+			header->height.store(0);
+			header->resets.store(0);
+			header->updates.store(0);
+			header->magic = Magic;
+		}
+		else if (header->magic != Magic)
+		{
+			return false;
+		}
+
+		_header = header;
+		return true;
+	}
+
+	bool isAttached() const
+	{
+		return _header != nullptr;
+	}
+
+	void publish(const Status& status)
+	{
+		// An odd sequence marks a write in progress
+		const uint32_t sequence = _header->sequence.load(std::memory_order_relaxed);
+		_header->sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		_header->frameRate.store(status.frameRate, std::memory_order_relaxed);
+		_header->width.store(status.width, std::memory_order_relaxed);
+		_header->height.store(status.height, std::memory_order_relaxed);
+		_header->resets.store(status.resets, std::memory_order_relaxed);
+		_header->updates.store(status.updates, std::memory_order_relaxed);
+
+		_header->sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	bool read(Status& status) const
+	{
+		for (uint32_t i = 0; i < ReadRetries; i++)
+		{
+			const uint32_t before = _header->sequence.load(std::memory_order_acquire);
+			if (before & 1)
+				continue;
+
+			status.frameRate = _header->frameRate.load(std::memory_order_relaxed);
+			status.width = _header->width.load(std::memory_order_relaxed);
+			status.height = _header->height.load(std::memory_order_relaxed);
+			status.resets = _header->resets.load(std::memory_order_relaxed);
+			status.updates = _header->updates.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (_header->sequence.load(std::memory_order_relaxed) == before)
+				return true;
+		}
+
+		return false;
+	}
+};
@@ -0,0 +1,186 @@
+#include "TextArchive.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+// What boost writes first: the length of the signature, the signature, then the archive version
+#define ARCHIVE_SIGNATURE	"serialization::archive"
+#define ARCHIVE_PREFIX		"22 " ARCHIVE_SIGNATURE " "
+
+// Longest number the archives hold, floats included
+#define MAX_TOKEN			64
+
+TextArchiveIn::TextArchiveIn(const char *data, size_t length) :
+_pos(data), _end(data + length), _good(true)
+{
+}
+
+bool TextArchiveIn::readHeader(unsigned int& version)
+{
+	std::string signature;
+	*this >> signature >> version;
+
+	_good = _good && signature == ARCHIVE_SIGNATURE;
+	return _good;
+}
+
+bool TextArchiveIn::good() const
+{
+	return _good;
+}
+
+bool TextArchiveIn::token(char *szToken, size_t size)
+{
+	while (_pos < _end && isspace(static_cast<unsigned char>(*_pos)))
+		_pos++;
+
+	size_t length = 0;
+	while (_pos < _end && !isspace(static_cast<unsigned char>(*_pos)))
+	{
+		if (length + 1 >= size)
+		{
+			_good = false;
+			return false;
+		}
+
+		szToken[length++] = *_pos++;
+	}
+
+	szToken[length] = '\0';
+
+	if (length == 0)
+		_good = false;
+
+	return _good;
+}
+
+TextArchiveIn& TextArchiveIn::operator>>(int& value)
+{
+	char szToken[MAX_TOKEN];
+	char *pEnd = nullptr;
+
+	if (token(szToken, sizeof(szToken)))
+	{
+		value = static_cast<int>(strtol(szToken, &pEnd, 10));
+		_good = *pEnd == '\0';
+	}
+
+	return *this;
+}
+
+TextArchiveIn& TextArchiveIn::operator>>(unsigned int& value)
+{
+	char szToken[MAX_TOKEN];
+	char *pEnd = nullptr;
+
+	if (token(szToken, sizeof(szToken)))
+	{
+		value = static_cast<unsigned int>(strtoul(szToken, &pEnd, 10));
+		_good = *pEnd == '\0';
+	}
+
+	return *this;
+}
+
+TextArchiveIn& TextArchiveIn::operator>>(bool& value)
+{
+	int i = 0;
+	*this >> i;
+
+	value = i != 0;
+	return *this;
+}
+
+TextArchiveIn& TextArchiveIn::operator>>(float& value)
+{
+	char szToken[MAX_TOKEN];
+	char *pEnd = nullptr;
+
+	if (token(szToken, sizeof(szToken)))
+	{
+		value = static_cast<float>(strtod(szToken, &pEnd));
+		_good = *pEnd == '\0';
+	}
+
+	return *this;
+}
+
+TextArchiveIn& TextArchiveIn::operator>>(std::string& value)
+{
+	unsigned int length = 0;
+	*this >> length;
+
+	// The bytes follow the one space after the length
+	if (!_good || _pos >= _end || *_pos != ' ' || length > static_cast<size_t>(_end - _pos - 1))
+	{
+		_good = false;
+		return *this;
+	}
+
+	value.assign(_pos + 1, length);
+	_pos += 1 + length;
+	return *this;
+}
+
+TextArchiveOut::TextArchiveOut(unsigned int version) :
+_str(ARCHIVE_PREFIX + std::to_string(version))
+{
+}
+
+const std::string& TextArchiveOut::str() const
+{
+	return _str;
+}
+
+TextArchiveOut& TextArchiveOut::operator<<(int value)
+{
+	_str += ' ';
+	_str += std::to_string(value);
+	return *this;
+}
+
+TextArchiveOut& TextArchiveOut::operator<<(unsigned int value)
+{
+	_str += ' ';
+	_str += std::to_string(value);
+	return *this;
+}
+
+TextArchiveCodec::TextArchiveCodec(IListener::Callback callback) :
+m_cbCallback(callback), m_translators(static_cast<size_t>(PipeMessages::Count), nullptr)
+{
+}
+
+bool TextArchiveCodec::isTextArchive(const char *data, size_t length)
+{
+	return length >= sizeof(ARCHIVE_PREFIX) - 1 && memcmp(data, ARCHIVE_PREFIX, sizeof(ARCHIVE_PREFIX) - 1) == 0;
+}
+
+void TextArchiveCodec::receive(Serializer& serializerIn, Serializer& serializerOut)
+{
+	auto length = static_cast<size_t>(serializerIn.numberOfBytesLeft());
+
+	if (!isTextArchive(serializerIn.unread(), length))
+	{
+		m_cbCallback(serializerIn, serializerOut);
+		return;
+	}
+
+	TextArchiveIn archiveIn(serializerIn.unread(), length);
+
+	unsigned int version = 0;
+	int id = 0;
+	archiveIn.readHeader(version);
+	archiveIn >> id;
+
+	TextArchiveOut archiveOut(version);
+
+	if (archiveIn.good() && id >= 0 && static_cast<size_t>(id) < m_translators.size() && m_translators[id] != nullptr)
+	{
+		SessionScope scope(NoSession);
+		m_translators[id](m_cbCallback, archiveIn, archiveOut);
+	}
+
+	serializerOut.writeBytes(archiveOut.str().data(), archiveOut.str().size());
+}
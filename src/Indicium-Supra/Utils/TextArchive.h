@@ -0,0 +1,169 @@
+#pragma once
+#include "Transport.h"
+#include "MessageCodec.h"
+
+#include <Shared/PipeMessages.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+//
+// Reads and writes the boost text archives clients from before the binary wire
+// format send: a signature, the archive version, then every field as a space
+// separated token, strings as their length followed by the bytes.
+//
+class TextArchiveIn
+{
+public:
+	TextArchiveIn(const char *data, size_t length);
+
+	// Reads the signature and version every archive starts with
+	bool readHeader(unsigned int& version);
+	bool good() const;
+
+	TextArchiveIn& operator>>(int& value);
+	TextArchiveIn& operator>>(unsigned int& value);
+	TextArchiveIn& operator>>(bool& value);
+	TextArchiveIn& operator>>(float& value);
+	TextArchiveIn& operator>>(std::string& value);
+
+	template<class... T>
+	TextArchiveIn& operator>>(std::tuple<T...>& t)
+	{
+		readTuple(t, typename message_detail::MakeIndices<sizeof...(T)>::type());
+		return *this;
+	}
+
+private:
+	bool token(char *szToken, size_t size);
+
+	template<class Tuple>
+	void readTuple(Tuple&, message_detail::Indices<>)
+	{
+	}
+
+	template<class Tuple, size_t I, size_t... Rest>
+	void readTuple(Tuple& t, message_detail::Indices<I, Rest...>)
+	{
+		*this >> std::get<I>(t);
+		readTuple(t, message_detail::Indices<Rest...>());
+	}
+
+	const char *_pos;
+	const char *_end;
+	bool _good;
+};
+
+class TextArchiveOut
+{
+public:
+	explicit TextArchiveOut(unsigned int version);
+
+	const std::string& str() const;
+
+	TextArchiveOut& operator<<(int value);
+	TextArchiveOut& operator<<(unsigned int value);
+
+	template<class... T>
+	TextArchiveOut& operator<<(const std::tuple<T...>& t)
+	{
+		writeTuple(t, typename message_detail::MakeIndices<sizeof...(T)>::type());
+		return *this;
+	}
+
+private:
+	template<class Tuple>
+	void writeTuple(const Tuple&, message_detail::Indices<>)
+	{
+	}
+
+	template<class Tuple, size_t I, size_t... Rest>
+	void writeTuple(const Tuple& t, message_detail::Indices<I, Rest...>)
+	{
+		*this << std::get<I>(t);
+		writeTuple(t, message_detail::Indices<Rest...>());
+	}
+
+	std::string _str;
+};
+
+//
+// Lets clients from before the binary wire format keep working. They never send
+// a Handshake, so their requests are told apart by the archive signature, which
+// no message id starts with. Such a request is decoded by the MessageSchema of
+// its message, passed on in the binary layout, and the reply encoded back into
+// the archive the client reads. Those clients connect once per call, so their
+// requests run as NoSession: objects tied to the connection would go away with
+// the reply. Only messages marked with accept() are translated, the others get
+// an empty archive, as the old server answered what it didn't know.
+//
+class TextArchiveCodec
+{
+public:
+	explicit TextArchiveCodec(IListener::Callback callback);
+
+	template<PipeMessages eMessage>
+	void accept()
+	{
+		static_assert(static_cast<size_t>(eMessage) < static_cast<size_t>(PipeMessages::Count), "message id out of range");
+		m_translators[static_cast<size_t>(eMessage)] = &translate<eMessage>;
+	}
+
+	static bool isTextArchive(const char *data, size_t length);
+
+	// Listener callback: translates text archives, passes binary requests on as they are
+	void receive(Serializer& serializerIn, Serializer& serializerOut);
+
+private:
+	TextArchiveCodec(const TextArchiveCodec&);
+	TextArchiveCodec& operator=(const TextArchiveCodec&);
+
+	typedef void (*Translator)(const IListener::Callback&, TextArchiveIn&, TextArchiveOut&);
+
+	template<class R>
+	struct ReplyText
+	{
+		static void write(Serializer& serializerReply, TextArchiveOut& archiveOut)
+		{
+			R reply;
+			message_detail::read(serializerReply, reply);
+
+			if (serializerReply.good())
+				archiveOut << reply;
+		}
+	};
+
+	template<PipeMessages eMessage>
+	static void translate(const IListener::Callback& callback, TextArchiveIn& archiveIn, TextArchiveOut& archiveOut)
+	{
+		typename MessageSchema<eMessage>::Request fields;
+		archiveIn >> fields;
+
+		if (!archiveIn.good())
+			return;
+
+		Serializer serializerRequest;
+		serializerRequest << eMessage;
+		message_detail::write(serializerRequest, fields);
+
+		Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed());
+		Serializer serializerOut;
+
+		callback(serializerIn, serializerOut);
+
+		Serializer serializerReply(serializerOut.data(), serializerOut.numberOfBytesUsed());
+		ReplyText<typename MessageSchema<eMessage>::Reply>::write(serializerReply, archiveOut);
+	}
+
+	IListener::Callback m_cbCallback;
+	std::vector<Translator> m_translators;
+};
+
+template<>
+struct TextArchiveCodec::ReplyText<void>
+{
+	static void write(Serializer&, TextArchiveOut&)
+	{
+	}
+};
@@ -0,0 +1,128 @@
+#include "TransactionQueue.h"
+#include "MessageCodec.h"
+
+TransactionQueue::TransactionQueue(IListener::Callback next) :
+m_cbNext(next), m_deferred(static_cast<size_t>(PipeMessages::Count), Deferred::No)
+{
+}
+
+void TransactionQueue::receive(Serializer& serializerIn, Serializer& serializerOut)
+{
+	auto length = static_cast<size_t>(serializerIn.numberOfBytesLeft());
+
+	PipeMessages eMessage;
+	Serializer serializerPeek(serializerIn.unread(), static_cast<unsigned int>(length));
+	serializerPeek >> eMessage;
+
+	auto session = currentSession();
+	auto uiIndex = static_cast<unsigned short>(messageId(eMessage));
+
+	if (!serializerPeek.good() || uiIndex >= m_deferred.size() || session == NoSession)
+	{
+		m_cbNext(serializerIn, serializerOut);
+		return;
+	}
+
+	std::unique_lock<std::mutex> l(m_mutex);
+
+	switch (messageId(eMessage))
+	{
+	case PipeMessages::BeginTransaction:
+	{
+		// Nested ones are folded into the outermost, whose commit publishes everything
+		auto it = m_open.find(session);
+		if (it == m_open.end())
+		{
+			Transaction& transaction = m_open[session];
+			transaction.count = 0;
+			transaction.depth = 1;
+		}
+		else
+		{
+			it->second.depth++;
+		}
+
+		if (wantsReply(eMessage))
+			writeReply<PipeMessages::BeginTransaction>(serializerOut, 1);
+		return;
+	}
+
+	case PipeMessages::CommitTransaction:
+	{
+		auto it = m_open.find(session);
+		auto bOpen = it != m_open.end();
+
+		Serializer serializerBatch;
+		uint32_t count = 0;
+
+		if (bOpen && --it->second.depth == 0)
+		{
+			count = it->second.count;
+			if (count > 0)
+			{
+				serializerBatch << PipeMessages::Batch << count;
+				serializerBatch.writeBytes(it->second.commands.data(), it->second.commands.numberOfBytesUsed());
+			}
+
+			m_open.erase(it);
+		}
+
+		l.unlock();
+
+		// Asked with a reply, which is thrown away: the commands' own failures are counted as they run
+		if (count > 0)
+		{
+			Serializer serializerCommands(serializerBatch.data(), serializerBatch.numberOfBytesUsed());
+			Serializer serializerResults;
+			m_cbNext(serializerCommands, serializerResults);
+		}
+
+		if (wantsReply(eMessage))
+			writeReply<PipeMessages::CommitTransaction>(serializerOut, int(bOpen));
+		return;
+	}
+
+	default:
+		break;
+	}
+
+	auto it = m_open.find(session);
+	if (it == m_open.end() || m_deferred[uiIndex] == Deferred::No)
+	{
+		l.unlock();
+		m_cbNext(serializerIn, serializerOut);
+		return;
+	}
+
+	// Held in memory until committed, don't let one grow without bound
+	auto& transaction = it->second;
+	if (static_cast<size_t>(transaction.commands.numberOfBytesUsed()) + sizeof(uint32_t) + length > MAX_MESSAGE_SIZE)
+	{
+		if (wantsReply(eMessage) && m_deferred[uiIndex] == Deferred::Succeeded)
+			serializerOut << int(0);
+		return;
+	}
+
+	// Nobody waits for the result when it is applied, so it goes in flagged as fire-and-forget
+	auto data = serializerIn.unread();
+
+	Serializer serializerId;
+	serializerId << noReply(eMessage);
+
+	auto uiIdSize = serializerId.numberOfBytesUsed();
+	transaction.commands << static_cast<uint32_t>(length);
+	transaction.commands.writeBytes(serializerId.data(), uiIdSize);
+	transaction.commands.writeBytes(data + uiIdSize, static_cast<unsigned int>(length - uiIdSize));
+	transaction.count++;
+
+	if (wantsReply(eMessage) && m_deferred[uiIndex] == Deferred::Succeeded)
+		serializerOut << int(1);
+}
+
+void TransactionQueue::closed(SessionId session)
+{
+	std::lock_guard<std::mutex> l(m_mutex);
+
+	// Its objects are gone, so an open transaction may not bring them back
+	m_open.erase(session);
+}
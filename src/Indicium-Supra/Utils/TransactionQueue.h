@@ -0,0 +1,63 @@
+#pragma once
+#include "Transport.h"
+#include "Serializer.h"
+
+#include <Shared/PipeMessages.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+//
+// Server side of BeginTransaction/CommitTransaction. In between, the messages
+// marked with defer() that a session sends are answered right away (as succeeded)
+// and kept back; the commit passes the whole set on as one Batch, which is applied
+// as a whole, so a frame shows either none or all of them, and in its place among
+// the session's other requests. Deferred requests are applied as fire-and-forget,
+// their failures show up in GetErrorCount. Everything else passes straight on.
+//
+class TransactionQueue
+{
+public:
+	explicit TransactionQueue(IListener::Callback next);
+
+	// The reply a deferred request gets has to be made up, so only int (1) or nothing
+	template<PipeMessages eMessage>
+	void defer()
+	{
+		typedef typename MessageSchema<eMessage>::Reply Reply;
+		static_assert(std::is_same<Reply, int>::value || std::is_void<Reply>::value, "only messages replying int or nothing can be deferred");
+
+		m_deferred[static_cast<size_t>(eMessage)] = std::is_void<Reply>::value ? Deferred::Silent : Deferred::Succeeded;
+	}
+
+	// Listener callbacks
+	void receive(Serializer& serializerIn, Serializer& serializerOut);
+	void closed(SessionId session);
+
+private:
+	TransactionQueue(const TransactionQueue&);
+	TransactionQueue& operator=(const TransactionQueue&);
+
+	enum class Deferred : uint8_t
+	{
+		No,
+		Silent,
+		Succeeded
+	};
+
+	struct Transaction
+	{
+		Serializer commands;
+		uint32_t count;
+		int depth;
+	};
+
+	IListener::Callback m_cbNext;
+	std::vector<Deferred> m_deferred;
+
+	std::mutex m_mutex;
+	std::map<SessionId, Transaction> m_open;
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include "Session.h"
+
+#include <boost/function.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Largest request or reply a transport accepts, anything above is treated as a broken connection
+#define MAX_MESSAGE_SIZE	(1024 * 1024)
+
+class Serializer;
+
+//
+// Client side of a connection to the overlay server. The server answers the
+// requests of a connection in the order they came in, so several can be in
+// flight at once and each reply belongs to the oldest request still waiting.
+//
+class ITransport
+{
+public:
+	// Runs on the transport's reader thread, possibly before submit returned; success is false if the connection broke first
+	typedef boost::function<void(uint32_t request, bool success, Serializer& reply)> ReplyCallback;
+
+	virtual ~ITransport() {}
+
+	virtual bool connect() = 0;
+	// Closes the connection and waits for the reader thread
+	virtual void disconnect() = 0;
+	// Closes the connection only, for DLL_PROCESS_DETACH: threads can't be joined under the loader lock
+	virtual void release() = 0;
+	// Changes whenever a new connection is opened, 0 while there is none
+	virtual uint32_t connectionId() = 0;
+
+	// Sends a request and waits for its reply
+	virtual bool transact(Serializer& serializerIn, Serializer& serializerOut) = 0;
+	// Sends a request flagged with PipeMessageNoReply, nothing comes back
+	virtual bool post(Serializer& serializerIn) = 0;
+	// Sends a request without waiting for its reply; returns the request id, 0 if it couldn't be sent or no reply comes
+	virtual uint32_t submit(Serializer& serializerIn, ReplyCallback callback) = 0;
+};
+
+//
+// One open connection of a client, whole messages in and out. ClientSession
+// builds the transport on top of it: one thread receives while others send.
+//
+class IConnection
+{
+public:
+	virtual ~IConnection() {}
+
+	virtual bool send(const char *data, uint32_t length) = 0;
+	// Blocks for the next message, false once the connection broke or shutdown() was called
+	virtual bool receive(std::vector<char>& message) = 0;
+	// Releases a receive blocked on another thread, nothing goes through afterwards
+	virtual void shutdown() = 0;
+
+	// Whether the send that just failed can't have reached the server, so it may go out again on a new connection
+	virtual bool retryable() const = 0;
+};
+
+//
+// Server side: accepts clients and hands every request to the callback, which
+// fills the reply. Every connection is a session: the callback runs with it as
+// currentSession(), and SessionCallback is told when the connection is gone.
+// Listening starts on construction and stops on destruction.
+//
+class IListener
+{
+public:
+	typedef boost::function<void(Serializer&, Serializer&)> Callback;
+	typedef boost::function<void(SessionId)> SessionCallback;
+
+	virtual ~IListener() {}
+};
+
+// Named pipe on Windows, Unix domain socket elsewhere
+std::unique_ptr<IListener> createListener(const std::string& name, IListener::Callback callback,
+	IListener::SessionCallback closed = IListener::SessionCallback());
+std::unique_ptr<ITransport> createTransport(const std::string& name);
+// Null if the server isn't there
+std::unique_ptr<IConnection> openConnection(const std::string& name);
+
+// Process-wide client connection to g_strPipeName, used by PipeClient
+ITransport& clientTransport();
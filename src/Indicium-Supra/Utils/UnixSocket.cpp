@@ -0,0 +1,307 @@
+#include "UnixSocket.h"
+
+#ifndef _WIN32
+#include "PipeClient.h"
+#include "Serializer.h"
+
+#include <Shared/PipeMessages.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace
+{
+	std::string socketPath(const std::string& name)
+	{
+		if (!name.empty() && name[0] == '/')
+			return name;
+
+		return "/tmp/" + name + ".sock";
+	}
+
+	uint32_t peerProcessId(int fd)
+	{
+#ifdef SO_PEERCRED
+		ucred credentials;
+		socklen_t size = sizeof(credentials);
+		if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == 0)
+			return static_cast<uint32_t>(credentials.pid);
+#endif
+		return 0;
+	}
+
+	bool fillAddress(const std::string& path, sockaddr_un& addr)
+	{
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+
+		if (path.size() >= sizeof(addr.sun_path))
+			return false;
+
+		memcpy(addr.sun_path, path.c_str(), path.size());
+		return true;
+	}
+
+	bool sendAll(int fd, const char *data, size_t length)
+	{
+		while (length > 0)
+		{
+			auto sent = ::send(fd, data, length, MSG_NOSIGNAL);
+			if (sent < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+
+			data += sent;
+			length -= sent;
+		}
+
+		return true;
+	}
+
+	bool recvAll(int fd, char *data, size_t length)
+	{
+		while (length > 0)
+		{
+			auto received = ::recv(fd, data, length, 0);
+			if (received < 0 && errno == EINTR)
+				continue;
+			if (received <= 0)
+				return false;
+
+			data += received;
+			length -= received;
+		}
+
+		return true;
+	}
+
+	bool sendFrame(int fd, const char *data, uint32_t length)
+	{
+		char szLength[sizeof(uint32_t)];
+		Serializer serializerLength;
+		serializerLength.setOutputBuffer(szLength, sizeof(szLength));
+		serializerLength << length;
+
+		return sendAll(fd, szLength, sizeof(szLength)) && sendAll(fd, data, length);
+	}
+}
+
+UnixSocketListener::UnixSocketListener(const std::string& name, Callback func, SessionCallback closed) :
+m_strPath(socketPath(name)), m_iListen(-1), m_thread(0), m_cbCallback(func), m_cbClosed(closed)
+{
+	sockaddr_un addr;
+	if (!fillAddress(m_strPath, addr))
+		return;
+
+	m_iListen = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (m_iListen < 0)
+		return;
+
+	// A stale socket file from a crashed server would make bind fail
+	unlink(m_strPath.c_str());
+
+	if (bind(m_iListen, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(m_iListen, SOMAXCONN) != 0)
+	{
+		::close(m_iListen);
+		m_iListen = -1;
+		return;
+	}
+
+	m_thread = new boost::thread(boost::bind(&UnixSocketListener::thread, this));
+}
+
+UnixSocketListener::~UnixSocketListener()
+{
+	if (m_thread)
+	{
+		m_thread->interrupt();
+		if (m_thread->joinable())
+			m_thread->join();
+		delete m_thread;
+		m_thread = NULL;
+	}
+
+	for (auto& connection : m_connections)
+		::close(connection.fd);
+
+	if (m_iListen >= 0)
+	{
+		::close(m_iListen);
+		unlink(m_strPath.c_str());
+	}
+}
+
+void UnixSocketListener::thread()
+{
+	std::vector<pollfd> fds;
+
+	while (true)
+	{
+		boost::this_thread::interruption_point();
+
+		fds.clear();
+		fds.push_back({ m_iListen, POLLIN, 0 });
+		for (auto& connection : m_connections)
+			fds.push_back({ connection.fd, POLLIN, 0 });
+
+		if (poll(fds.data(), fds.size(), POLL_TIME_OUT) <= 0)
+			continue;
+
+		// Walk backwards so erasing a closed connection keeps the remaining indices valid
+		for (size_t i = fds.size() - 1; i > 0; i--)
+		{
+			if (fds[i].revents == 0)
+				continue;
+
+			if (!receive(m_connections[i - 1]))
+			{
+				close(m_connections[i - 1]);
+				m_connections.erase(m_connections.begin() + (i - 1));
+			}
+		}
+
+		if (fds[0].revents & POLLIN)
+		{
+			int fd = accept(m_iListen, nullptr, nullptr);
+			if (fd >= 0)
+				m_connections.push_back({ fd, std::vector<char>(), openSession(peerProcessId(fd)) });
+		}
+	}
+}
+
+void UnixSocketListener::close(Connection& connection)
+{
+	::close(connection.fd);
+
+	closeSession(connection.session);
+	if (m_cbClosed)
+		m_cbClosed(connection.session);
+}
+
+bool UnixSocketListener::receive(Connection& connection)
+{
+	char szData[BUFSIZE];
+
+	auto received = ::recv(connection.fd, szData, sizeof(szData), 0);
+	if (received < 0 && errno == EINTR)
+		return true;
+	if (received <= 0)
+		return false;
+
+	connection.pending.insert(connection.pending.end(), szData, szData + received);
+
+	size_t offset = 0;
+	while (connection.pending.size() - offset >= sizeof(uint32_t))
+	{
+		uint32_t length;
+		Serializer(connection.pending.data() + offset, sizeof(uint32_t)) >> length;
+
+		if (length > MAX_MESSAGE_SIZE)
+			return false;
+
+		if (connection.pending.size() - offset - sizeof(uint32_t) < length)
+			break;
+
+		auto request = connection.pending.data() + offset + sizeof(uint32_t);
+		offset += sizeof(uint32_t) + length;
+
+		Serializer serializerIn(request, length);
+		Serializer serializerOut;
+
+		{
+			SessionScope scope(connection.session);
+			m_cbCallback(serializerIn, serializerOut);
+		}
+
+		PipeMessages eMessage;
+		Serializer(request, length) >> eMessage;
+
+		if (wantsReply(eMessage) && !sendFrame(connection.fd, serializerOut.data(), serializerOut.numberOfBytesUsed()))
+			return false;
+	}
+
+	connection.pending.erase(connection.pending.begin(), connection.pending.begin() + offset);
+	return true;
+}
+
+UnixSocketConnection::UnixSocketConnection(int fd) :
+m_iSocket(fd)
+{
+}
+
+UnixSocketConnection::~UnixSocketConnection()
+{
+	::close(m_iSocket);
+}
+
+bool UnixSocketConnection::send(const char *data, uint32_t length)
+{
+	return sendFrame(m_iSocket, data, length);
+}
+
+bool UnixSocketConnection::receive(std::vector<char>& message)
+{
+	char szLength[sizeof(uint32_t)];
+	if (!recvAll(m_iSocket, szLength, sizeof(szLength)))
+		return false;
+
+	uint32_t length;
+	Serializer(szLength, sizeof(szLength)) >> length;
+
+	if (length > MAX_MESSAGE_SIZE)
+		return false;
+
+	message.resize(length);
+	return length == 0 || recvAll(m_iSocket, message.data(), length);
+}
+
+void UnixSocketConnection::shutdown()
+{
+	// A blocked recv returns 0, the descriptor itself is closed with the connection
+	::shutdown(m_iSocket, SHUT_RDWR);
+}
+
+bool UnixSocketConnection::retryable() const
+{
+	return errno == EPIPE || errno == ECONNRESET || errno == ENOTCONN;
+}
+
+std::unique_ptr<IListener> createListener(const std::string& name, IListener::Callback callback, IListener::SessionCallback closed)
+{
+	return std::unique_ptr<IListener>(new UnixSocketListener(name, callback, closed));
+}
+
+std::unique_ptr<IConnection> openConnection(const std::string& name)
+{
+	sockaddr_un addr;
+	if (!fillAddress(socketPath(name), addr))
+		return nullptr;
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return nullptr;
+
+	// Only sends time out, the reader waits for replies until shutdown()
+	timeval timeout = { TRANSACT_TIME_OUT / 1000, (TRANSACT_TIME_OUT % 1000) * 1000 };
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+	{
+		::close(fd);
+		return nullptr;
+	}
+
+	return std::unique_ptr<IConnection>(new UnixSocketConnection(fd));
+}
+
+#endif
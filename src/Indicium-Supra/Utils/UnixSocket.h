@@ -0,0 +1,61 @@
+#pragma once
+#include "Transport.h"
+
+#include <string>
+#include <vector>
+
+// Requests and replies travel as a 32-bit length followed by the payload (up to MAX_MESSAGE_SIZE)
+#define POLL_TIME_OUT	100
+
+namespace boost { class thread; }
+
+//
+// Stream socket stand-ins for the named pipes, so the protocol can be served
+// and driven outside Windows. Names map to a socket file in /tmp unless they
+// already are an absolute path.
+//
+class UnixSocketListener : public IListener
+{
+	struct Connection
+	{
+		int fd;
+		std::vector<char> pending;
+		SessionId session;
+	};
+
+public:
+	UnixSocketListener(const std::string& name, Callback func, SessionCallback closed);
+	~UnixSocketListener();
+
+private:
+	void thread();
+	bool receive(Connection& connection);
+	void close(Connection& connection);
+
+	std::string m_strPath;
+	int m_iListen;
+	std::vector<Connection> m_connections;
+
+	boost::thread *m_thread;
+	Callback m_cbCallback;
+	SessionCallback m_cbClosed;
+};
+
+class UnixSocketConnection : public IConnection
+{
+public:
+	explicit UnixSocketConnection(int fd);
+	~UnixSocketConnection();
+
+	bool send(const char *data, uint32_t length) override;
+	bool receive(std::vector<char>& message) override;
+	void shutdown() override;
+
+	bool retryable() const override;
+
+private:
+	UnixSocketConnection(const UnixSocketConnection&);
+	UnixSocketConnection& operator=(const UnixSocketConnection&);
+
+	int m_iSocket;
+};
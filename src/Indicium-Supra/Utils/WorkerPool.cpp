@@ -0,0 +1,58 @@
+#include "WorkerPool.h"
+
+#include <boost/bind.hpp>
+
+WorkerPool::WorkerPool(unsigned int threads) : m_bStopping(false)
+{
+	for (unsigned int i = 0; i < threads; i++)
+		m_threads.create_thread(boost::bind(&WorkerPool::thread, this));
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> l(m_mutex);
+		m_bStopping = true;
+	}
+
+	m_cvJobs.notify_all();
+	m_threads.join_all();
+}
+
+void WorkerPool::submit(Job job)
+{
+	{
+		std::lock_guard<std::mutex> l(m_mutex);
+		m_jobs.push_back(job);
+	}
+
+	m_cvJobs.notify_one();
+}
+
+void WorkerPool::thread()
+{
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> l(m_mutex);
+			m_cvJobs.wait(l, [this]() { return m_bStopping || !m_jobs.empty(); });
+
+			// Pending jobs are dropped on shutdown, their clients are being disconnected anyway
+			if (m_bStopping)
+				return;
+
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		try
+		{
+			job();
+		}
+		catch (...)
+		{
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+//
+// Fixed set of threads running queued jobs in submission order. Jobs from
+// different submitters may run concurrently; callers that need ordering keep
+// at most one job of theirs in flight.
+//
+class WorkerPool
+{
+public:
+	typedef boost::function<void()> Job;
+
+	explicit WorkerPool(unsigned int threads);
+	~WorkerPool();
+
+	void submit(Job job);
+
+private:
+	void thread();
+
+	std::deque<Job> m_jobs;
+	std::mutex m_mutex;
+	std::condition_variable m_cvJobs;
+	bool m_bStopping;
+
+	boost::thread_group m_threads;
+};
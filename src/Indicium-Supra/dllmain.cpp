@@ -1,12 +1,13 @@
 #include "dllmain.h"
 
 #include <Utils/Windows.h>
+#include <Utils/Transport.h>
 #include <Game/Game.h>
 #include <boost/log/support/date_time.hpp>
 
 HANDLE g_hDllHandle = nullptr;
 
-BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD dwReason, LPVOID)
+BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD dwReason, LPVOID lpReserved)
 {
 	g_hDllHandle = hInstance;
 
@@ -69,6 +70,11 @@ BOOL WINAPI DllMain(HINSTANCE hInstance, DWORD dwReason, LPVOID)
 			{
 				BOOST_LOG_TRIVIAL(info) << "Hook engine disabled";
 			}
+
+			// On process exit the other threads are gone already, possibly holding the transport's locks.
+			// On FreeLibrary the readers can't be joined under the loader lock, clients call Disconnect first
+			if (lpReserved == nullptr)
+				clientTransport().release();
 		}
 		break;
 	};
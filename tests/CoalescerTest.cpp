@@ -0,0 +1,93 @@
+#include "Test.h"
+#include "RequestChain.h"
+
+TEST_CASE(Coalescer, KeepsLatestPerObject)
+{
+	RequestChain server;
+	SessionScope scope(openSession(1));
+
+	server.setPos(1, 1);
+	server.setPos(2, 1);
+	server.setPos(1, 2);
+	server.setPos(1, 3);
+
+	CHECK(server.frame() == "p2=1 p1=3 ");
+	CHECK(server.frame() == "");
+}
+
+TEST_CASE(Coalescer, ArrivalOrder)
+{
+	RequestChain server;
+	SessionScope scope(openSession(1));
+
+	// The replaced position goes behind the color that arrived after it
+	server.setPos(1, 1);
+	server.setColor(1, 5);
+	server.setPos(1, 2);
+
+	CHECK(server.frame() == "c1=5 p1=2 ");
+}
+
+TEST_CASE(Coalescer, OtherRequestsPassStagedOnFirst)
+{
+	RequestChain server;
+	SessionScope scope(openSession(1));
+
+	server.setPos(1, 1);
+	server.destroy(1);
+	server.setPos(1, 2);
+
+	CHECK(server.frame() == "p1=1 d1 p1=2 ");
+}
+
+TEST_CASE(Coalescer, Compaction)
+{
+	RequestChain server;
+	SessionScope scope(openSession(1));
+
+	for (int i = 0; i < 1000; i++)
+		server.setPos(i % 3, i);
+
+	CHECK(server.frame() == "p1=997 p2=998 p0=999 ");
+}
+
+TEST_CASE(Coalescer, ClosedSessionIsDropped)
+{
+	RequestChain server;
+	SessionId session = openSession(1);
+	SessionId other = openSession(2);
+
+	{
+		SessionScope scope(other);
+		server.setPos(7, 1);
+	}
+
+	SessionScope scope(session);
+	server.setPos(8, 1);
+
+	server.coalescer.closed(other);
+	closeSession(other);
+
+	CHECK(server.frame() == "p8=1 ");
+}
+
+TEST_CASE(Coalescer, SessionsDontFlushEachOther)
+{
+	RequestChain server;
+	SessionId session = openSession(1);
+	SessionId other = openSession(2);
+
+	{
+		SessionScope scope(other);
+		server.setPos(7, 1);
+	}
+
+	// A destroy of one session leaves what another has staged for the frame
+	{
+		SessionScope scope(session);
+		server.destroy(3);
+	}
+
+	CHECK(chain::applied() == "d3 ");
+	CHECK(server.frame() == "d3 p7=1 ");
+}
@@ -0,0 +1,135 @@
+#include "Test.h"
+
+#include <Utils/Dispatcher.h>
+#include <Utils/MessageTable.h>
+
+#include <vector>
+
+static int g_iLastId = 0;
+
+static int TextDestroy(int id)
+{
+	g_iLastId = id;
+	return id > 0 ? 1 : 0;
+}
+
+static int GetFrameRate()
+{
+	throw 1;
+}
+
+static int Send(const Dispatcher& dispatcher, Serializer& serializerRequest)
+{
+	Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed());
+	Serializer serializerOut;
+	dispatcher.dispatch(serializerIn, serializerOut);
+
+	int reply = -1;
+	if (serializerOut.numberOfBytesUsed() != 0)
+		Serializer(serializerOut.data(), serializerOut.numberOfBytesUsed()) >> reply;
+	return reply;
+}
+
+TEST_CASE(Dispatcher, RoutesToBoundHandler)
+{
+	Dispatcher dispatcher;
+	dispatcher.bind<PipeMessages::TextDestroy, TextDestroy>();
+
+	Serializer serializerRequest;
+	writeRequest<PipeMessages::TextDestroy>(serializerRequest, 17);
+
+	CHECK(Send(dispatcher, serializerRequest) == 1);
+	CHECK(g_iLastId == 17);
+	CHECK(dispatcher.takeStats().ops == 1);
+}
+
+TEST_CASE(Dispatcher, UnboundAndInvalidIds)
+{
+	Dispatcher dispatcher;
+	dispatcher.bind<PipeMessages::TextDestroy, TextDestroy>();
+
+	Serializer serializerUnbound;
+	writeRequest<PipeMessages::BoxDestroy>(serializerUnbound, 1);
+	CHECK(Send(dispatcher, serializerUnbound) == -1);
+
+	Serializer serializerNegative;
+	serializerNegative << static_cast<short>(-3) << 1;
+	CHECK(Send(dispatcher, serializerNegative) == -1);
+
+	Serializer serializerOutOfRange;
+	serializerOutOfRange << static_cast<short>(PipeMessages::Count) << 1;
+	CHECK(Send(dispatcher, serializerOutOfRange) == -1);
+
+	Serializer serializerEmpty;
+	CHECK(Send(dispatcher, serializerEmpty) == -1);
+}
+
+TEST_CASE(Dispatcher, CountsNoReplyFailures)
+{
+	Dispatcher dispatcher;
+	dispatcher.bind<PipeMessages::TextDestroy, TextDestroy>();
+
+	Serializer serializerFailed;
+	writeRequestNoReply<PipeMessages::TextDestroy>(serializerFailed, 0);
+	Send(dispatcher, serializerFailed);
+	Send(dispatcher, serializerFailed);
+
+	Serializer serializerSucceeded;
+	writeRequestNoReply<PipeMessages::TextDestroy>(serializerSucceeded, 3);
+	Send(dispatcher, serializerSucceeded);
+
+	// Failures of requests that want a reply are the client's to see
+	Serializer serializerReplied;
+	writeRequest<PipeMessages::TextDestroy>(serializerReplied, 0);
+	CHECK(Send(dispatcher, serializerReplied) == 0);
+
+	CHECK(dispatcher.takeErrorCount() == 2);
+	CHECK(dispatcher.takeErrorCount() == 0);
+}
+
+TEST_CASE(Dispatcher, HandlerExceptionIsContained)
+{
+	Dispatcher dispatcher;
+	dispatcher.bind<PipeMessages::GetFrameRate, GetFrameRate>();
+
+	Serializer serializerRequest;
+	writeRequest<PipeMessages::GetFrameRate>(serializerRequest);
+	CHECK(Send(dispatcher, serializerRequest) == -1);
+}
+
+static void AddCommand(Serializer& serializerBatch, Serializer& serializerCommand)
+{
+	serializerBatch << static_cast<uint32_t>(serializerCommand.numberOfBytesUsed());
+	serializerBatch.writeBytes(serializerCommand.data(), serializerCommand.numberOfBytesUsed());
+}
+
+TEST_CASE(Dispatcher, BatchInsideBatchIsRefused)
+{
+	Dispatcher dispatcher;
+	dispatcher.bind<PipeMessages::TextDestroy, TextDestroy>();
+	dispatcher.bindWithDispatcher<PipeMessages::Batch, RouteBatch>();
+
+	Serializer serializerFirst, serializerLast;
+	writeRequest<PipeMessages::TextDestroy>(serializerFirst, 5);
+	writeRequest<PipeMessages::TextDestroy>(serializerLast, 7);
+
+	Serializer serializerInner;
+	serializerInner << PipeMessages::Batch << static_cast<uint32_t>(1);
+	AddCommand(serializerInner, serializerFirst);
+
+	Serializer serializerRequest;
+	serializerRequest << PipeMessages::Batch << static_cast<uint32_t>(3);
+	AddCommand(serializerRequest, serializerFirst);
+	AddCommand(serializerRequest, serializerInner);
+	AddCommand(serializerRequest, serializerLast);
+
+	Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed());
+	Serializer serializerOut;
+	dispatcher.dispatch(serializerIn, serializerOut);
+
+	std::vector<int> results;
+	Serializer(serializerOut.data(), serializerOut.numberOfBytesUsed()) >> results;
+
+	CHECK(results == (std::vector<int>{ 1, 0, 1 }));
+	CHECK(g_iLastId == 7);
+}
@@ -0,0 +1,111 @@
+#include "Test.h"
+
+#include <Utils/MessageCodec.h>
+
+#include <string>
+#include <tuple>
+
+static std::string g_strText;
+static int g_iCalls = 0;
+
+static int TextCreate(std::string font, int fontSize, bool bold, bool italic, int x, int y, unsigned int color, std::string text, bool shadow, bool show)
+{
+	g_iCalls++;
+	g_strText = font + "/" + text;
+	return (bold && !italic && shadow && show && color == 0xFF00FF00) ? fontSize + x + y : -1;
+}
+
+static std::tuple<int, int> GetScreenSpecs()
+{
+	return std::make_tuple(1920, 1080);
+}
+
+static void SetCalculationRatio(int width, int height)
+{
+	g_iCalls += width * height;
+}
+
+TEST_CASE(MessageCodec, RequestToHandler)
+{
+	g_iCalls = 0;
+
+	Serializer serializerRequest;
+	writeRequest<PipeMessages::TextCreate>(serializerRequest, std::string("Arial"), 12, true, false, 100, 200, 0xFF00FF00u, std::string("hello"), true, true);
+
+	Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed());
+
+	PipeMessages eMessage;
+	serializerIn >> eMessage;
+	CHECK(eMessage == PipeMessages::TextCreate);
+
+	Serializer serializerOut;
+	MessageInvoker<MessageSchema<PipeMessages::TextCreate>::Signature>::call(&TextCreate, serializerIn, serializerOut);
+
+	CHECK(g_iCalls == 1);
+	CHECK(g_strText == "Arial/hello");
+
+	Serializer serializerReply(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+	int reply = 0;
+	CHECK(readReply<PipeMessages::TextCreate>(serializerReply, reply));
+	CHECK(reply == 312);
+}
+
+TEST_CASE(MessageCodec, RequestIsSizedExactly)
+{
+	Serializer serializerRequest;
+	writeRequest<PipeMessages::TextSetPos>(serializerRequest, 1, 2, 3);
+
+	CHECK(serializerRequest.numberOfBytesUsed() == static_cast<int>(sizeof(PipeMessages) + 3 * sizeof(int)));
+}
+
+TEST_CASE(MessageCodec, NoReplyFlag)
+{
+	Serializer serializerRequest;
+	writeRequestNoReply<PipeMessages::TextSetPos>(serializerRequest, 1, 2, 3);
+
+	Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed());
+
+	PipeMessages eMessage;
+	serializerIn >> eMessage;
+	CHECK(!wantsReply(eMessage));
+	CHECK(messageId(eMessage) == PipeMessages::TextSetPos);
+}
+
+TEST_CASE(MessageCodec, TruncatedRequestIsNotCalled)
+{
+	g_iCalls = 0;
+
+	Serializer serializerRequest;
+	writeRequest<PipeMessages::SetCalculationRatio>(serializerRequest, 4, 5);
+
+	// Drop the last byte of height
+	Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed() - 1);
+
+	PipeMessages eMessage;
+	serializerIn >> eMessage;
+
+	Serializer serializerOut;
+	MessageInvoker<MessageSchema<PipeMessages::SetCalculationRatio>::Signature>::call(&SetCalculationRatio, serializerIn, serializerOut);
+
+	CHECK(g_iCalls == 0);
+	CHECK(serializerOut.numberOfBytesUsed() == 0);
+}
+
+TEST_CASE(MessageCodec, TupleReply)
+{
+	Serializer serializerIn;
+	Serializer serializerOut;
+	MessageInvoker<MessageSchema<PipeMessages::GetScreenSpecs>::Signature>::call(&GetScreenSpecs, serializerIn, serializerOut);
+
+	Serializer serializerReply(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+	std::tuple<int, int> reply;
+	CHECK(readReply<PipeMessages::GetScreenSpecs>(serializerReply, reply));
+	CHECK(std::get<0>(reply) == 1920);
+	CHECK(std::get<1>(reply) == 1080);
+
+	// A reply cut short reads as failed
+	Serializer serializerShort(serializerOut.data(), serializerOut.numberOfBytesUsed() - 1);
+	CHECK(!readReply<PipeMessages::GetScreenSpecs>(serializerShort, reply));
+}
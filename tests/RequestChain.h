@@ -0,0 +1,119 @@
+#pragma once
+#include <Utils/Coalescer.h>
+#include <Utils/Dispatcher.h>
+#include <Utils/MessageCodec.h>
+#include <Utils/MessageTable.h>
+#include <Utils/TransactionQueue.h>
+
+#include <boost/bind.hpp>
+
+#include <string>
+
+//
+// The request chain the game builds (transactions, then coalescing, then the
+// handlers) with handlers that only write down what reached them, in order.
+//
+namespace chain
+{
+	inline std::string& applied()
+	{
+		static std::string strApplied;
+		return strApplied;
+	}
+
+	inline int TextSetPos(int id, int x, int)
+	{
+		applied() += "p" + std::to_string(id) + "=" + std::to_string(x) + " ";
+		return 1;
+	}
+
+	inline int TextSetColor(int id, unsigned int color)
+	{
+		applied() += "c" + std::to_string(id) + "=" + std::to_string(color) + " ";
+		return 1;
+	}
+
+	inline int TextDestroy(int id)
+	{
+		applied() += "d" + std::to_string(id) + " ";
+		return 1;
+	}
+
+	inline void Batch(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher)
+	{
+		applied() += "[ ";
+		RouteBatch(serializerIn, serializerOut, dispatcher);
+		applied() += "] ";
+	}
+}
+
+struct RequestChain
+{
+	Dispatcher dispatcher;
+	Coalescer coalescer;
+	TransactionQueue transactions;
+
+	RequestChain() :
+		coalescer(boost::bind(&Dispatcher::dispatch, &dispatcher, _1, _2)),
+		transactions(boost::bind(&Coalescer::receive, &coalescer, _1, _2))
+	{
+		dispatcher.bind<PipeMessages::TextSetPos, chain::TextSetPos>();
+		dispatcher.bind<PipeMessages::TextSetColor, chain::TextSetColor>();
+		dispatcher.bind<PipeMessages::TextDestroy, chain::TextDestroy>();
+		dispatcher.bindWithDispatcher<PipeMessages::Batch, chain::Batch>();
+
+		coalescer.coalesce(PipeMessages::TextSetPos);
+		coalescer.coalesce(PipeMessages::TextSetColor);
+
+		transactions.defer<PipeMessages::TextSetPos>();
+		transactions.defer<PipeMessages::TextDestroy>();
+
+		chain::applied().clear();
+	}
+
+	void send(Serializer& serializerRequest)
+	{
+		Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed());
+		Serializer serializerOut;
+		transactions.receive(serializerIn, serializerOut);
+	}
+
+	void setPos(int id, int x)
+	{
+		Serializer serializerRequest;
+		writeRequestNoReply<PipeMessages::TextSetPos>(serializerRequest, id, x, 0);
+		send(serializerRequest);
+	}
+
+	void setColor(int id, unsigned int color)
+	{
+		Serializer serializerRequest;
+		writeRequestNoReply<PipeMessages::TextSetColor>(serializerRequest, id, color);
+		send(serializerRequest);
+	}
+
+	void destroy(int id)
+	{
+		Serializer serializerRequest;
+		writeRequestNoReply<PipeMessages::TextDestroy>(serializerRequest, id);
+		send(serializerRequest);
+	}
+
+	template<PipeMessages eMessage>
+	void call()
+	{
+		Serializer serializerRequest;
+		writeRequest<eMessage>(serializerRequest);
+		send(serializerRequest);
+	}
+
+	// What the handlers saw since the last call, staged updates included
+	std::string frame()
+	{
+		coalescer.flush();
+
+		std::string strApplied;
+		strApplied.swap(chain::applied());
+		return strApplied;
+	}
+};
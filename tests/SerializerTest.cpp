@@ -0,0 +1,131 @@
+#include "Test.h"
+
+#include <Utils/Serializer.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+TEST_CASE(Serializer, RoundTrip)
+{
+	Serializer serializerOut;
+	serializerOut << -5 << 0xDEADBEEFu << true << 1.5f << -0.25 << std::string("text with spaces") << std::vector<int>{ 1, -2, 3 };
+
+	Serializer serializerIn(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+	int i;
+	unsigned int u;
+	bool b;
+	float f;
+	double d;
+	std::string str;
+	std::vector<int> v;
+	serializerIn >> i >> u >> b >> f >> d >> str >> v;
+
+	CHECK(serializerIn.good());
+	CHECK(serializerIn.numberOfBytesLeft() == 0);
+	CHECK(i == -5);
+	CHECK(u == 0xDEADBEEFu);
+	CHECK(b);
+	CHECK(f == 1.5f);
+	CHECK(d == -0.25);
+	CHECK(str == "text with spaces");
+	CHECK(v == (std::vector<int>{ 1, -2, 3 }));
+}
+
+TEST_CASE(Serializer, LittleEndianFixedWidth)
+{
+	Serializer serializerOut;
+	serializerOut << static_cast<short>(0x0102) << 0x03040506 << false;
+
+	const unsigned char expected[] = { 0x02, 0x01, 0x06, 0x05, 0x04, 0x03, 0x00 };
+	CHECK(serializerOut.numberOfBytesUsed() == sizeof(expected));
+	CHECK(memcmp(serializerOut.data(), expected, sizeof(expected)) == 0);
+}
+
+TEST_CASE(Serializer, ReadPastEnd)
+{
+	const char data[] = { 1, 0 };
+	Serializer serializerIn(data, sizeof(data));
+
+	int value = 7;
+	serializerIn >> value;
+
+	CHECK(!serializerIn.good());
+	CHECK(value == 0);
+}
+
+TEST_CASE(Serializer, StringLongerThanMessage)
+{
+	Serializer serializerOut;
+	serializerOut << static_cast<uint32_t>(100);
+	serializerOut.writeBytes("abc", 3);
+
+	Serializer serializerIn(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+	std::string str = "unchanged";
+	serializerIn >> str;
+
+	CHECK(!serializerIn.good());
+	CHECK(str.empty());
+}
+
+TEST_CASE(Serializer, CallerBuffer)
+{
+	char buffer[8];
+
+	Serializer serializerOut;
+	serializerOut.setOutputBuffer(buffer, sizeof(buffer));
+	serializerOut << 1 << 2;
+
+	CHECK(serializerOut.data() == buffer);
+	CHECK(serializerOut.numberOfBytesUsed() == 8);
+
+	// Overflowing continues in owned storage with what was written so far
+	serializerOut << 3;
+	CHECK(serializerOut.data() != buffer);
+	CHECK(serializerOut.numberOfBytesUsed() == 12);
+
+	Serializer serializerIn(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+	int a, b, c;
+	serializerIn >> a >> b >> c;
+	CHECK(serializerIn.good());
+	CHECK(a == 1 && b == 2 && c == 3);
+}
+
+TEST_CASE(Serializer, SetDataCopies)
+{
+	std::vector<char> bytes;
+	{
+		Serializer serializerOut;
+		serializerOut << 42;
+		bytes.assign(serializerOut.data(), serializerOut.data() + serializerOut.numberOfBytesUsed());
+	}
+
+	Serializer serializerIn;
+	serializerIn.setData(bytes.data(), bytes.size());
+	bytes.assign(bytes.size(), 0);
+
+	int value;
+	serializerIn >> value;
+	CHECK(serializerIn.good());
+	CHECK(value == 42);
+}
+
+TEST_CASE(Serializer, ReadInPlace)
+{
+	Serializer serializerOut;
+	serializerOut << static_cast<uint32_t>(4);
+	serializerOut.writeBytes("abcd", 4);
+
+	Serializer serializerIn(serializerOut.data(), serializerOut.numberOfBytesUsed());
+
+	uint32_t length;
+	serializerIn >> length;
+
+	auto bytes = serializerIn.readInPlace(length);
+	CHECK(bytes == serializerOut.data() + sizeof(uint32_t));
+	CHECK(serializerIn.readInPlace(1) == nullptr);
+	CHECK(!serializerIn.good());
+}
@@ -0,0 +1,107 @@
+#include "Test.h"
+
+#include <Utils/Dispatcher.h>
+#include <Utils/SessionLog.h>
+
+#include <boost/bind.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static std::string g_strSeen;
+
+static int TextSetPos(int id, int x, int)
+{
+	g_strSeen += std::to_string(currentSession()) + ":p" + std::to_string(id) + "=" + std::to_string(x) + " ";
+	return 1;
+}
+
+static int TextDestroy(int id)
+{
+	g_strSeen += std::to_string(currentSession()) + ":d" + std::to_string(id) + " ";
+	return 1;
+}
+
+static void Ignore(Serializer&, Serializer&)
+{
+}
+
+static void Closed(std::string *pstrClosed, SessionId session)
+{
+	*pstrClosed += std::to_string(session) + " ";
+}
+
+static void Send(IListener::Callback& callback, Serializer& serializerRequest)
+{
+	Serializer serializerIn(serializerRequest.data(), serializerRequest.numberOfBytesUsed());
+	Serializer serializerOut;
+	callback(serializerIn, serializerOut);
+}
+
+TEST_CASE(SessionLog, RecordAndReplay)
+{
+	const char *szPath = "SessionLogTest.log";
+
+	SessionId session = openSession(1);
+	SessionId other = openSession(2);
+	{
+		SessionRecorder recorder(szPath);
+		CHECK(recorder.isOpen());
+
+		auto callback = recorder.wrap(&Ignore);
+
+		Serializer serializerFirst, serializerSecond, serializerThird;
+		writeRequest<PipeMessages::TextSetPos>(serializerFirst, 1, 10, 0);
+		writeRequestNoReply<PipeMessages::TextSetPos>(serializerSecond, 2, 20, 0);
+		writeRequest<PipeMessages::TextDestroy>(serializerThird, 1);
+
+		{
+			SessionScope scope(session);
+			Send(callback, serializerFirst);
+		}
+		{
+			SessionScope scope(other);
+			Send(callback, serializerSecond);
+		}
+		{
+			SessionScope scope(session);
+			Send(callback, serializerThird);
+		}
+	}
+
+	closeSession(session);
+	closeSession(other);
+
+	Dispatcher dispatcher;
+	dispatcher.bind<PipeMessages::TextSetPos, TextSetPos>();
+	dispatcher.bind<PipeMessages::TextDestroy, TextDestroy>();
+
+	g_strSeen.clear();
+	std::string strClosed;
+
+	int count = replaySession(szPath, boost::bind(&Dispatcher::dispatch, &dispatcher, _1, _2), ReplaySpeed::Fast,
+		boost::bind(&Closed, &strClosed, _1));
+
+	// Same requests, same order, each under the session it came in on
+	auto s = std::to_string(session) + ":", o = std::to_string(other) + ":";
+	CHECK(count == 3);
+	CHECK(g_strSeen == s + "p1=10 " + o + "p2=20 " + s + "d1 ");
+	CHECK(strClosed == std::to_string(session) + " " + std::to_string(other) + " ");
+
+	std::remove(szPath);
+}
+
+TEST_CASE(SessionLog, NotALog)
+{
+	const char *szPath = "SessionLogTest.bin";
+	{
+		std::ofstream file(szPath, std::ios::binary);
+		file << "not a session log";
+	}
+
+	CHECK(replaySession(szPath, &Ignore, ReplaySpeed::Fast) == -1);
+	CHECK(replaySession("SessionLogTest.missing", &Ignore, ReplaySpeed::Fast) == -1);
+
+	std::remove(szPath);
+}
@@ -0,0 +1,167 @@
+#include "Test.h"
+
+#include <Utils/SharedRing.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Mirrors SharedRing's header, so a test can play a producer that writes garbage
+	struct RingHeader
+	{
+		uint32_t magic;
+		uint32_t capacity;
+		std::atomic<uint32_t> producer;
+		char pad0[64 - 3 * sizeof(uint32_t)];
+		std::atomic<uint32_t> head;
+		char pad1[64 - sizeof(uint32_t)];
+		std::atomic<uint32_t> tail;
+		char pad2[64 - sizeof(uint32_t)];
+	};
+
+	const uint32_t Capacity = 1024;
+
+	struct Ring
+	{
+		std::vector<char> memory;
+		SharedRing consumer;
+		SharedRing producer;
+
+		Ring() : memory(SharedRing::requiredSize(Capacity))
+		{
+			consumer.attach(memory.data(), memory.size(), true);
+			producer.attach(memory.data(), memory.size(), false);
+		}
+
+		RingHeader *header()
+		{
+			return reinterpret_cast<RingHeader *>(memory.data());
+		}
+
+		char *data()
+		{
+			return memory.data() + sizeof(RingHeader);
+		}
+	};
+}
+
+TEST_CASE(SharedRing, Attach)
+{
+	Ring ring;
+	CHECK(ring.consumer.isAttached());
+	CHECK(ring.producer.isAttached());
+	CHECK(sizeof(RingHeader) + Capacity == SharedRing::requiredSize(Capacity));
+
+	// Producers only attach to an initialized block that is big enough for its capacity
+	std::vector<char> memory(SharedRing::requiredSize(Capacity));
+	SharedRing producer;
+	CHECK(!producer.attach(memory.data(), memory.size(), false));
+
+	SharedRing consumer;
+	CHECK(consumer.attach(memory.data(), memory.size(), true));
+	CHECK(!producer.attach(memory.data(), memory.size() - 1, false));
+	CHECK(producer.attach(memory.data(), memory.size(), false));
+}
+
+TEST_CASE(SharedRing, WrapAround)
+{
+	Ring ring;
+
+	// Sizes not dividing the capacity put records and wrap markers at every offset
+	std::vector<std::string> sent;
+	size_t received = 0;
+	bool bInOrder = true;
+
+	auto consumer = [&](const char *data, uint32_t length)
+	{
+		if (received >= sent.size() || sent[received] != std::string(data, length))
+			bInOrder = false;
+		received++;
+	};
+
+	for (int i = 0; i < 10000; i++)
+	{
+		sent.push_back(std::string(1 + i % 200, static_cast<char>('a' + i % 26)));
+
+		while (!ring.producer.push(sent.back().data(), static_cast<uint32_t>(sent.back().size())))
+			ring.consumer.drain(consumer);
+	}
+
+	ring.consumer.drain(consumer);
+
+	CHECK(bInOrder);
+	CHECK(received == sent.size());
+	CHECK(ring.header()->head.load() == ring.header()->tail.load());
+	CHECK(ring.header()->head.load() > Capacity);
+}
+
+TEST_CASE(SharedRing, Full)
+{
+	Ring ring;
+
+	uint32_t count = 0;
+	while (ring.producer.push("0123456789ab", 12))
+		count++;
+
+	// 16 bytes a record
+	CHECK(count == Capacity / 16);
+	CHECK(!ring.producer.push("x", 1));
+
+	CHECK(!ring.consumer.empty());
+	CHECK(ring.consumer.drain([](const char *, uint32_t) {}) == count);
+	CHECK(ring.consumer.empty());
+	CHECK(ring.producer.push("0123456789ab", 12));
+}
+
+TEST_CASE(SharedRing, OversizedRecord)
+{
+	Ring ring;
+
+	std::vector<char> record(Capacity / 2);
+	CHECK(!ring.producer.push(record.data(), static_cast<uint32_t>(record.size())));
+	CHECK(ring.producer.push(record.data(), static_cast<uint32_t>(record.size() - sizeof(uint32_t))));
+}
+
+TEST_CASE(SharedRing, GarbageIsDropped)
+{
+	Ring ring;
+	auto header = ring.header();
+	int calls = 0;
+	auto consumer = [&](const char *, uint32_t) { calls++; };
+
+	// A length running past head
+	CHECK(ring.producer.push("abcd", 4));
+	const uint32_t bogus = 100000;
+	memcpy(ring.data() + (header->tail.load() & (Capacity - 1)), &bogus, sizeof(bogus));
+
+	CHECK(ring.consumer.drain(consumer) == 0);
+	CHECK(calls == 0);
+	CHECK(header->tail.load() == header->head.load());
+
+	// A head further ahead than the ring is long
+	header->head.store(header->tail.load() + 5000);
+	CHECK(ring.consumer.drain(consumer) == 0);
+	CHECK(header->tail.load() == header->head.load());
+
+	// A capacity changed after attaching is not believed
+	header->capacity = 1u << 30;
+	CHECK(ring.producer.push("ok", 2));
+	CHECK(ring.consumer.drain(consumer) == 1);
+}
+
+TEST_CASE(SharedRing, Producer)
+{
+	Ring ring;
+
+	CHECK(ring.producer.claimProducer(10));
+	CHECK(!ring.producer.claimProducer(11));
+	CHECK(ring.producer.claimProducer(11, 10));
+	CHECK(ring.consumer.producer() == 11);
+
+	ring.producer.releaseProducer(10);
+	CHECK(ring.consumer.producer() == 11);
+
+	ring.producer.releaseProducer(11);
+	CHECK(ring.consumer.producer() == 0);
+}
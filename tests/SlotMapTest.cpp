@@ -0,0 +1,149 @@
+#include "Test.h"
+
+#include <Utils/SlotMap.h>
+
+#include <algorithm>
+#include <vector>
+
+static uint32_t IndexOf(int id)
+{
+	return static_cast<uint32_t>(id) & (SlotMap<int>::MaxSlots - 1);
+}
+
+TEST_CASE(SlotMap, InsertFindErase)
+{
+	SlotMap<int> slots;
+
+	int a = slots.insert(1);
+	int b = slots.insert(2);
+	CHECK(a >= 0 && b >= 0 && a != b);
+	CHECK(*slots.find(a) == 1);
+	CHECK(*slots.find(b) == 2);
+
+	CHECK(slots.erase(a));
+	CHECK(slots.find(a) == nullptr);
+	CHECK(!slots.erase(a));
+	CHECK(*slots.find(b) == 2);
+	CHECK(slots.size() == 1);
+
+	CHECK(slots.find(-1) == nullptr);
+	CHECK(slots.find(0x7FFFFFFF) == nullptr);
+}
+
+TEST_CASE(SlotMap, GenerationReuse)
+{
+	SlotMap<int> slots;
+
+	int first = slots.insert(1);
+	CHECK(slots.erase(first));
+
+	// The slot is handed out again under a new generation, the old handle stays dead
+	int second = slots.insert(2);
+	CHECK(IndexOf(second) == IndexOf(first));
+	CHECK(second != first);
+	CHECK(slots.find(first) == nullptr);
+	CHECK(!slots.erase(first));
+	CHECK(*slots.find(second) == 2);
+}
+
+TEST_CASE(SlotMap, GenerationRunsOut)
+{
+	SlotMap<int> slots;
+
+	std::vector<int> handles;
+	for (uint32_t i = 0; i <= SlotMap<int>::MaxGeneration; i++)
+	{
+		int id = slots.insert(static_cast<int>(i));
+		handles.push_back(id);
+		slots.erase(id);
+	}
+
+	// One slot went through every generation, then it is retired rather than wrapping to an old handle
+	CHECK(std::all_of(handles.begin(), handles.end(), [](int id) { return IndexOf(id) == 0; }));
+
+	int next = slots.insert(0);
+	CHECK(IndexOf(next) == 1);
+	CHECK(std::find(handles.begin(), handles.end(), next) == handles.end());
+}
+
+TEST_CASE(SlotMap, EraseMovesLastValue)
+{
+	SlotMap<int> slots;
+
+	int a = slots.insert(1);
+	int b = slots.insert(2);
+	int c = slots.insert(3);
+
+	CHECK(slots.erase(a));
+	CHECK(*slots.find(b) == 2);
+	CHECK(*slots.find(c) == 3);
+
+	int sum = 0;
+	for (auto value : slots)
+		sum += value;
+	CHECK(sum == 5);
+}
+
+TEST_CASE(SlotMap, EraseIf)
+{
+	SlotMap<int> slots;
+
+	std::vector<int> handles;
+	for (int i = 0; i < 10; i++)
+		handles.push_back(slots.insert(i));
+
+	slots.eraseIf([](int value) { return value % 2 == 0; });
+
+	CHECK(slots.size() == 5);
+	for (int i = 0; i < 10; i++)
+		CHECK((slots.find(handles[i]) != nullptr) == (i % 2 == 1));
+}
+
+TEST_CASE(SlotMap, Reserve)
+{
+	SlotMap<int> slots;
+	slots.insert(0);
+
+	int first = slots.reserve(5, 7);
+	CHECK(first >= 0);
+
+	// Reserved handles find nothing until filled, and are filled once
+	CHECK(slots.find(first) == nullptr);
+	CHECK(slots.reserved(7) == 5);
+	CHECK(slots.insertAt(first + 2, 9));
+	CHECK(slots.reserved(7) == 4);
+	CHECK(!slots.insertAt(first + 2, 9));
+	CHECK(*slots.find(first + 2) == 9);
+
+	// Releasing frees what wasn't used and leaves what was
+	slots.releaseReserved(7);
+	CHECK(slots.reserved(7) == 0);
+	CHECK(!slots.insertAt(first, 1));
+	CHECK(*slots.find(first + 2) == 9);
+
+	CHECK(slots.reserve(0, 8) == -1);
+	CHECK(!slots.insertAt(-1, 1));
+}
+
+TEST_CASE(SlotMap, ReservedRunsAreReused)
+{
+	SlotMap<int> slots;
+
+	int first = slots.reserve(4, 1);
+	for (int i = 0; i < 4; i++)
+		CHECK(slots.insertAt(first + i, i));
+
+	for (int round = 0; round < 1000; round++)
+	{
+		slots.eraseIf([](int) { return true; });
+
+		int id = slots.reserve(4, 1);
+		CHECK(id >= 0);
+		CHECK(IndexOf(id) == IndexOf(first));
+
+		for (int i = 0; i < 4; i++)
+			slots.insertAt(id + i, i);
+	}
+
+	CHECK(slots.size() == 4);
+}
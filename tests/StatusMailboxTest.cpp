@@ -0,0 +1,89 @@
+#include "Test.h"
+
+#include <Utils/StatusMailbox.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE(StatusMailbox, PublishRead)
+{
+	std::vector<char> memory(StatusMailbox::requiredSize());
+
+	StatusMailbox reader;
+	CHECK(!reader.attach(memory.data(), memory.size(), false));
+
+	StatusMailbox writer;
+	CHECK(writer.attach(memory.data(), memory.size(), true));
+	CHECK(reader.attach(memory.data(), memory.size(), false));
+	CHECK(!reader.attach(memory.data(), memory.size() - 1, false));
+	CHECK(reader.attach(memory.data(), memory.size(), false));
+
+	StatusMailbox::Status status;
+	CHECK(reader.read(status));
+	CHECK(status.frameRate == 0 && status.updates == 0);
+
+	StatusMailbox::Status published = { 60, 1920, 1080, 2, 1 };
+	writer.publish(published);
+
+	CHECK(reader.read(status));
+	CHECK(status.frameRate == 60);
+	CHECK(status.width == 1920);
+	CHECK(status.height == 1080);
+	CHECK(status.resets == 2);
+	CHECK(status.updates == 1);
+}
+
+TEST_CASE(StatusMailbox, WriteInProgress)
+{
+	std::vector<char> memory(StatusMailbox::requiredSize());
+
+	StatusMailbox writer;
+	writer.attach(memory.data(), memory.size(), true);
+
+	// The sequence follows the magic; an odd one means the writer is mid-publish
+	reinterpret_cast<std::atomic<uint32_t> *>(memory.data() + sizeof(uint32_t))->store(1);
+
+	StatusMailbox::Status status;
+	CHECK(!writer.read(status));
+}
+
+TEST_CASE(StatusMailbox, ReadsAreNeverTorn)
+{
+	std::vector<char> memory(StatusMailbox::requiredSize());
+
+	StatusMailbox writer;
+	writer.attach(memory.data(), memory.size(), true);
+
+	std::atomic<bool> bDone(false);
+	std::thread publisher([&]
+	{
+		for (int32_t i = 1; !bDone; i++)
+		{
+			StatusMailbox::Status status = { i, i, i, static_cast<uint32_t>(i), static_cast<uint32_t>(i) };
+			writer.publish(status);
+		}
+	});
+
+	StatusMailbox reader;
+	reader.attach(memory.data(), memory.size(), false);
+
+	int reads = 0;
+	bool bConsistent = true;
+	for (int i = 0; i < 100000; i++)
+	{
+		StatusMailbox::Status status;
+		if (!reader.read(status))
+			continue;
+
+		reads++;
+		if (status.width != status.frameRate || status.height != status.frameRate || status.updates != static_cast<uint32_t>(status.frameRate))
+			bConsistent = false;
+	}
+
+	bDone = true;
+	publisher.join();
+
+	CHECK(reads > 0);
+	CHECK(bConsistent);
+}
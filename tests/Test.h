@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+
+//
+// Just enough of a test framework for the headless parts of the server: cases
+// register themselves under a suite, main runs the suites named on the command
+// line (all of them without arguments). A failed CHECK is reported and counted,
+// the case carries on.
+//
+struct TestCase
+{
+	const char *suite;
+	const char *name;
+	void (*run)();
+};
+
+std::vector<TestCase>& testCases();
+void checkFailed(const char *file, int line, const char *expression);
+
+struct TestRegistrar
+{
+	TestRegistrar(const char *suite, const char *name, void (*run)())
+	{
+		TestCase test = { suite, name, run };
+		testCases().push_back(test);
+	}
+};
+
+#define TEST_CASE(suite, name) \
+	static void suite##_##name(); \
+	static TestRegistrar suite##_##name##_registrar(#suite, #name, &suite##_##name); \
+	static void suite##_##name()
+
+#define CHECK(expression) \
+	do { if (!(expression)) checkFailed(__FILE__, __LINE__, #expression); } while (0)
@@ -0,0 +1,132 @@
+#include "Test.h"
+
+#include <Utils/Dispatcher.h>
+#include <Utils/TextArchive.h>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/bind.hpp>
+
+#include <sstream>
+#include <string>
+
+static std::string g_strSeen;
+static SessionId g_session = NoSession;
+
+static int TextCreate(std::string font, int fontSize, bool bold, bool italic, int x, int y, unsigned int color, std::string text, bool shadow, bool show)
+{
+	g_session = currentSession();
+	g_strSeen = font + "|" + std::to_string(fontSize) + "|" + std::to_string(bold) + std::to_string(italic) + "|" + std::to_string(x) + "," +
+		std::to_string(y) + "|" + std::to_string(color) + "|" + text + "|" + std::to_string(shadow) + std::to_string(show);
+	return 42;
+}
+
+static int TextSetPos(int id, int x, int y)
+{
+	g_session = currentSession();
+	g_strSeen = "p" + std::to_string(id) + "=" + std::to_string(x) + "," + std::to_string(y);
+	return 1;
+}
+
+// The chain the game builds, minus transactions and coalescing
+struct TextArchiveServer
+{
+	Dispatcher dispatcher;
+	TextArchiveCodec codec;
+
+	TextArchiveServer() :
+		codec(boost::bind(&Dispatcher::dispatch, &dispatcher, _1, _2))
+	{
+		dispatcher.bind<PipeMessages::TextCreate, TextCreate>();
+		dispatcher.bind<PipeMessages::TextSetPos, TextSetPos>();
+
+		codec.accept<PipeMessages::TextCreate>();
+		codec.accept<PipeMessages::TextSetPos>();
+	}
+
+	std::string send(const std::string& strRequest)
+	{
+		Serializer serializerIn(strRequest.data(), static_cast<unsigned int>(strRequest.size()));
+		Serializer serializerOut;
+		codec.receive(serializerIn, serializerOut);
+
+		return std::string(serializerOut.data(), serializerOut.numberOfBytesUsed());
+	}
+};
+
+TEST_CASE(TextArchive, PrefixDetection)
+{
+	auto isTextArchive = [](const std::string& str) { return TextArchiveCodec::isTextArchive(str.data(), str.size()); };
+
+	CHECK(isTextArchive("22 serialization::archive 12 7 1 20 30"));
+	CHECK(isTextArchive("22 serialization::archive "));
+	CHECK(!isTextArchive("22 serialization::archive"));
+	CHECK(!isTextArchive("21 serialization::archive 12 7"));
+	CHECK(!isTextArchive(""));
+
+	// No binary request starts like one: its first bytes are a little-endian message id
+	Serializer serializerRequest;
+	writeRequest<PipeMessages::TextSetPos>(serializerRequest, 1, 20, 30);
+	CHECK(!TextArchiveCodec::isTextArchive(serializerRequest.data(), serializerRequest.numberOfBytesUsed()));
+}
+
+TEST_CASE(TextArchive, TranslatedRequestsRunAsNoSession)
+{
+	TextArchiveServer server;
+	SessionId session = openSession(1);
+	SessionScope scope(session);
+
+	g_session = session;
+	CHECK(server.send("22 serialization::archive 12 7 1 20 30") == "22 serialization::archive 12 1");
+	CHECK(g_session == NoSession);
+
+	// Binary requests keep the connection's session
+	Serializer serializerRequest;
+	writeRequest<PipeMessages::TextSetPos>(serializerRequest, 1, 20, 30);
+	server.send(std::string(serializerRequest.data(), serializerRequest.numberOfBytesUsed()));
+	CHECK(g_session == session);
+
+	closeSession(session);
+}
+
+TEST_CASE(TextArchive, CapturedLegacyRequest)
+{
+	TextArchiveServer server;
+
+	// TextCreate as a client built against the VS2013 era boost sent it
+	auto strReply = server.send("22 serialization::archive 12 2 5 Arial 12 1 0 100 200 4294967295 11 Health: 100 1 1\n");
+
+	CHECK(g_strSeen == "Arial|12|10|100,200|4294967295|Health: 100|11");
+	CHECK(strReply == "22 serialization::archive 12 42");
+}
+
+TEST_CASE(TextArchive, BoostRoundTrip)
+{
+	TextArchiveServer server;
+
+	std::stringstream ssRequest;
+	{
+		boost::archive::text_oarchive archive(ssRequest);
+		short eMessage = static_cast<short>(PipeMessages::TextSetPos);
+		int id = 3, x = -5, y = 600;
+		archive << eMessage << id << x << y;
+	}
+
+	std::stringstream ssReply(server.send(ssRequest.str()));
+	CHECK(g_strSeen == "p3=-5,600");
+
+	int reply = 0;
+	boost::archive::text_iarchive archive(ssReply);
+	archive >> reply;
+	CHECK(reply == 1);
+}
+
+TEST_CASE(TextArchive, UnknownMessageGetsEmptyArchive)
+{
+	TextArchiveServer server;
+
+	g_strSeen.clear();
+	CHECK(server.send("22 serialization::archive 12 3 1") == "22 serialization::archive 12");
+	CHECK(server.send("22 serialization::archive 12 7 1 x 30") == "22 serialization::archive 12");
+	CHECK(g_strSeen.empty());
+}
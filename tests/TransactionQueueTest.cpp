@@ -0,0 +1,52 @@
+#include "Test.h"
+#include "RequestChain.h"
+
+TEST_CASE(TransactionQueue, TransactionKeepsItsPlace)
+{
+	RequestChain server;
+	SessionScope scope(openSession(1));
+
+	server.setPos(1, 1);
+	server.call<PipeMessages::BeginTransaction>();
+	server.setPos(1, 2);
+	server.destroy(2);
+	server.call<PipeMessages::CommitTransaction>();
+	server.setPos(1, 3);
+
+	CHECK(server.frame() == "p1=1 [ p1=2 d2 ] p1=3 ");
+}
+
+TEST_CASE(TransactionQueue, NestedTransactionCommitsOnce)
+{
+	RequestChain server;
+	SessionScope scope(openSession(1));
+
+	server.call<PipeMessages::BeginTransaction>();
+	server.setPos(1, 1);
+	server.call<PipeMessages::BeginTransaction>();
+	server.setPos(2, 1);
+	server.call<PipeMessages::CommitTransaction>();
+
+	CHECK(server.frame() == "");
+
+	server.call<PipeMessages::CommitTransaction>();
+	CHECK(server.frame() == "[ p1=1 p2=1 ] ");
+}
+
+TEST_CASE(TransactionQueue, ClosedTransactionIsDropped)
+{
+	RequestChain server;
+	SessionId session = openSession(1);
+
+	{
+		SessionScope scope(session);
+		server.call<PipeMessages::BeginTransaction>();
+		server.setPos(1, 1);
+	}
+
+	server.transactions.closed(session);
+	server.coalescer.closed(session);
+	closeSession(session);
+
+	CHECK(server.frame() == "");
+}
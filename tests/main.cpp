@@ -0,0 +1,56 @@
+#include "Test.h"
+
+#include <cstdio>
+#include <cstring>
+
+static unsigned int g_uiFailures = 0;
+
+std::vector<TestCase>& testCases()
+{
+	static std::vector<TestCase> cases;
+	return cases;
+}
+
+void checkFailed(const char *file, int line, const char *expression)
+{
+	printf("  %s:%d: CHECK(%s) failed\n", file, line, expression);
+	g_uiFailures++;
+}
+
+static bool selected(const char *suite, int argc, char *argv[])
+{
+	if (argc < 2)
+		return true;
+
+	for (int i = 1; i < argc; i++)
+	if (strcmp(argv[i], suite) == 0)
+		return true;
+
+	return false;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int uiRun = 0, uiFailed = 0;
+
+	for (const auto& test : testCases())
+	{
+		if (!selected(test.suite, argc, argv))
+			continue;
+
+		auto uiBefore = g_uiFailures;
+		test.run();
+		uiRun++;
+
+		bool bPassed = g_uiFailures == uiBefore;
+		if (!bPassed)
+			uiFailed++;
+
+		printf("%s.%s: %s\n", test.suite, test.name, bPassed ? "ok" : "FAILED");
+	}
+
+	printf("%u of %u passed\n", uiRun - uiFailed, uiRun);
+
+	// A suite name nobody registered is a typo in the test list, not a pass
+	return (uiRun == 0 || uiFailed != 0) ? 1 : 0;
+}
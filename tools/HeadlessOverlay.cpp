@@ -0,0 +1,408 @@
+#include "HeadlessOverlay.h"
+
+#include <Shared/Config.h>
+#include <Utils/MessageTable.h>
+#include <Utils/SlotMap.h>
+
+#include <boost/bind.hpp>
+
+#include <chrono>
+#include <string>
+
+#define BIND(T) m_dispatcher.bind<PipeMessages::T, T>();
+
+namespace
+{
+	enum class Kind : uint8_t
+	{
+		Text,
+		Box,
+		Line,
+		Image
+	};
+
+	// What the handlers would set on a RenderBase, kept only to be touched like the real thing
+	struct NullObject
+	{
+		Kind kind;
+		SessionId owner;
+		bool shown;
+		unsigned int color;
+		int x, y, x2, y2;
+		int width, height;
+		int priority;
+		std::string text;
+	};
+
+	std::recursive_mutex g_renderMutex;
+	SlotMap<NullObject> g_objects;
+	std::atomic<int> g_iFrameRate(0);
+
+	NullObject makeObject(Kind kind, bool shown, unsigned int color, int x, int y)
+	{
+		NullObject object;
+		object.kind = kind;
+		object.owner = currentSession();
+		object.shown = shown;
+		object.color = color;
+		object.x = x;
+		object.y = y;
+		object.x2 = object.y2 = 0;
+		object.width = object.height = 0;
+		object.priority = 0;
+		return object;
+	}
+
+	int create(NullObject object)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+		return g_objects.insert(std::move(object));
+	}
+
+	int createAt(int id, NullObject object)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+		return int(g_objects.insertAt(id, std::move(object)));
+	}
+
+	int destroy(int id, Kind kind)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+		auto object = g_objects.find(id);
+		if (object == nullptr || object->kind != kind)
+			return 0;
+
+		return int(g_objects.erase(id));
+	}
+
+	// Like safeExecuteWithValidation around a getAs<T>: 0 when id isn't an object of that kind
+	template<class F>
+	int modify(int id, Kind kind, F f)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+		auto object = g_objects.find(id);
+		if (object == nullptr || object->kind != kind)
+			return 0;
+
+		f(*object);
+		return 1;
+	}
+
+	int TextCreate(std::string, int, bool, bool, int x, int y, unsigned int color, std::string text, bool, bool show)
+	{
+		auto object = makeObject(Kind::Text, show, color, x, y);
+		object.text = text;
+		return create(std::move(object));
+	}
+
+	int TextCreateAt(int id, std::string, int, bool, bool, int x, int y, unsigned int color, std::string text, bool, bool show)
+	{
+		auto object = makeObject(Kind::Text, show, color, x, y);
+		object.text = text;
+		return createAt(id, std::move(object));
+	}
+
+	int TextDestroy(int id) { return destroy(id, Kind::Text); }
+	int TextSetShadow(int id, bool) { return modify(id, Kind::Text, [](NullObject&) {}); }
+	int TextSetShown(int id, bool shown) { return modify(id, Kind::Text, [&](NullObject& o) { o.shown = shown; }); }
+	int TextSetColor(int id, unsigned int color) { return modify(id, Kind::Text, [&](NullObject& o) { o.color = color; }); }
+	int TextSetPos(int id, int x, int y) { return modify(id, Kind::Text, [&](NullObject& o) { o.x = x; o.y = y; }); }
+	int TextSetString(int id, std::string text) { return modify(id, Kind::Text, [&](NullObject& o) { o.text = text; }); }
+	int TextUpdate(int id, std::string, int, bool, bool) { return modify(id, Kind::Text, [](NullObject&) {}); }
+
+	int BoxCreate(int x, int y, int w, int h, unsigned int color, bool show)
+	{
+		auto object = makeObject(Kind::Box, show, color, x, y);
+		object.width = w;
+		object.height = h;
+		return create(std::move(object));
+	}
+
+	int BoxCreateAt(int id, int x, int y, int w, int h, unsigned int color, bool show)
+	{
+		auto object = makeObject(Kind::Box, show, color, x, y);
+		object.width = w;
+		object.height = h;
+		return createAt(id, std::move(object));
+	}
+
+	int BoxDestroy(int id) { return destroy(id, Kind::Box); }
+	int BoxSetShown(int id, bool shown) { return modify(id, Kind::Box, [&](NullObject& o) { o.shown = shown; }); }
+	int BoxSetBorder(int id, int, bool) { return modify(id, Kind::Box, [](NullObject&) {}); }
+	int BoxSetBorderColor(int id, unsigned int) { return modify(id, Kind::Box, [](NullObject&) {}); }
+	int BoxSetColor(int id, unsigned int color) { return modify(id, Kind::Box, [&](NullObject& o) { o.color = color; }); }
+	int BoxSetHeight(int id, int height) { return modify(id, Kind::Box, [&](NullObject& o) { o.height = height; }); }
+	int BoxSetPos(int id, int x, int y) { return modify(id, Kind::Box, [&](NullObject& o) { o.x = x; o.y = y; }); }
+	int BoxSetWidth(int id, int width) { return modify(id, Kind::Box, [&](NullObject& o) { o.width = width; }); }
+
+	int LineCreate(int x1, int y1, int x2, int y2, int width, unsigned int color, bool show)
+	{
+		auto object = makeObject(Kind::Line, show, color, x1, y1);
+		object.x2 = x2;
+		object.y2 = y2;
+		object.width = width;
+		return create(std::move(object));
+	}
+
+	int LineCreateAt(int id, int x1, int y1, int x2, int y2, int width, unsigned int color, bool show)
+	{
+		auto object = makeObject(Kind::Line, show, color, x1, y1);
+		object.x2 = x2;
+		object.y2 = y2;
+		object.width = width;
+		return createAt(id, std::move(object));
+	}
+
+	int LineDestroy(int id) { return destroy(id, Kind::Line); }
+	int LineSetShown(int id, bool shown) { return modify(id, Kind::Line, [&](NullObject& o) { o.shown = shown; }); }
+	int LineSetColor(int id, unsigned int color) { return modify(id, Kind::Line, [&](NullObject& o) { o.color = color; }); }
+	int LineSetWidth(int id, int width) { return modify(id, Kind::Line, [&](NullObject& o) { o.width = width; }); }
+	int LineSetPos(int id, int x1, int y1, int x2, int y2) { return modify(id, Kind::Line, [&](NullObject& o) { o.x = x1; o.y = y1; o.x2 = x2; o.y2 = y2; }); }
+
+	int ImageCreate(std::string path, int x, int y, float, float, int, int, bool show)
+	{
+		auto object = makeObject(Kind::Image, show, 0, x, y);
+		object.text = path;
+		return create(std::move(object));
+	}
+
+	int ImageCreateAt(int id, std::string path, int x, int y, float, float, int, int, bool show)
+	{
+		auto object = makeObject(Kind::Image, show, 0, x, y);
+		object.text = path;
+		return createAt(id, std::move(object));
+	}
+
+	int ImageDestroy(int id) { return destroy(id, Kind::Image); }
+	int ImageSetShown(int id, bool shown) { return modify(id, Kind::Image, [&](NullObject& o) { o.shown = shown; }); }
+	int ImageSetAlign(int id, int) { return modify(id, Kind::Image, [](NullObject&) {}); }
+	int ImageSetPos(int id, int x, int y) { return modify(id, Kind::Image, [&](NullObject& o) { o.x = x; o.y = y; }); }
+	int ImageSetRotation(int id, int) { return modify(id, Kind::Image, [](NullObject&) {}); }
+	int ImageSetScale(int id, float, float) { return modify(id, Kind::Image, [](NullObject&) {}); }
+
+	void destroyAll(SessionId owner)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+		g_objects.eraseIf([&](const NullObject& object) { return object.owner == owner; });
+		g_objects.releaseReserved(owner);
+	}
+
+	void setAllShown(SessionId owner, bool shown)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+		for (auto& object : g_objects)
+		if (object.owner == owner)
+			object.shown = shown;
+	}
+
+	void DestroyAllVisual() { destroyAll(currentSession()); }
+	void ShowAllVisual() { setAllShown(currentSession(), true); }
+	void HideAllVisual() { setAllShown(currentSession(), false); }
+
+	int GetFrameRate()
+	{
+		return g_iFrameRate.load();
+	}
+
+	std::tuple<int, int> GetScreenSpecs()
+	{
+		return std::make_tuple(1920, 1080);
+	}
+
+	void SetCalculationRatio(int, int)
+	{
+	}
+
+	int SetOverlayPriority(int id, int priority)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+		auto object = g_objects.find(id);
+		if (object == nullptr)
+			return 0;
+
+		object->priority = priority;
+		return 1;
+	}
+
+	// Same limits as Renderer::reserve
+	int ReserveHandles(int count)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+		auto session = currentSession();
+		if (session == NoSession || count <= 0 || count > g_iMaxReservedHandles - static_cast<int>(g_objects.reserved(session)))
+			return -1;
+
+		return g_objects.reserve(count, session);
+	}
+
+	// There is no status mailbox without a game
+	int Subscribe(int)
+	{
+		return 0;
+	}
+
+	std::tuple<int, int, unsigned int, unsigned int> Handshake(int, unsigned int features)
+	{
+		unsigned int available = PipeFeatures::Batch | PipeFeatures::Transactions | PipeFeatures::Pipelining | PipeFeatures::ReservedHandles;
+		return std::make_tuple(PipeProtocolVersion, MAX_MESSAGE_SIZE, static_cast<unsigned int>(PipeEncodings::Binary | PipeEncodings::TextArchive), available & features);
+	}
+
+	void Batch(Serializer& serializerIn, Serializer& serializerOut, const Dispatcher& dispatcher)
+	{
+		std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+		RouteBatch(serializerIn, serializerOut, dispatcher);
+	}
+}
+
+HeadlessOverlay::HeadlessOverlay(int frameRate) :
+m_coalescer(boost::bind(&Dispatcher::dispatch, &m_dispatcher, _1, _2)),
+m_transactions(boost::bind(&Coalescer::receive, &m_coalescer, _1, _2)),
+m_textArchives(boost::bind(&TransactionQueue::receive, &m_transactions, _1, _2)),
+m_bStop(false), m_uiFrames(0)
+{
+	g_iFrameRate = frameRate;
+
+	BIND(TextCreate);
+	BIND(TextCreateAt);
+	BIND(TextDestroy);
+	BIND(TextSetShadow);
+	BIND(TextSetShown);
+	BIND(TextSetColor);
+	BIND(TextSetPos);
+	BIND(TextSetString);
+	BIND(TextUpdate);
+
+	BIND(BoxCreate);
+	BIND(BoxCreateAt);
+	BIND(BoxDestroy);
+	BIND(BoxSetShown);
+	BIND(BoxSetBorder);
+	BIND(BoxSetBorderColor);
+	BIND(BoxSetColor);
+	BIND(BoxSetHeight);
+	BIND(BoxSetPos);
+	BIND(BoxSetWidth);
+
+	BIND(LineCreate);
+	BIND(LineCreateAt);
+	BIND(LineDestroy);
+	BIND(LineSetShown);
+	BIND(LineSetColor);
+	BIND(LineSetWidth);
+	BIND(LineSetPos);
+
+	BIND(ImageCreate);
+	BIND(ImageCreateAt);
+	BIND(ImageDestroy);
+	BIND(ImageSetShown);
+	BIND(ImageSetAlign);
+	BIND(ImageSetPos);
+	BIND(ImageSetRotation);
+	BIND(ImageSetScale);
+
+	BIND(DestroyAllVisual);
+	BIND(ShowAllVisual);
+	BIND(HideAllVisual);
+
+	BIND(GetFrameRate);
+	BIND(GetScreenSpecs);
+
+	BIND(SetCalculationRatio);
+	BIND(SetOverlayPriority);
+
+	BIND(ReserveHandles);
+	BIND(Subscribe);
+	BIND(Handshake);
+
+	m_dispatcher.bindWithDispatcher<PipeMessages::Batch, Batch>();
+	m_dispatcher.bindWithDispatcher<PipeMessages::GetErrorCount, GetErrorCount>();
+	m_dispatcher.bindWithDispatcher<PipeMessages::GetServerStats, GetServerStats>();
+
+	RegisterCoalescing(m_coalescer);
+	RegisterTransactions(m_transactions);
+	RegisterTextArchive(m_textArchives);
+
+	m_thread = std::thread(&HeadlessOverlay::frameLoop, this);
+}
+
+HeadlessOverlay::~HeadlessOverlay()
+{
+	{
+		std::lock_guard<std::mutex> l(m_stopMutex);
+		m_bStop = true;
+	}
+
+	m_cvStop.notify_all();
+	m_thread.join();
+
+	frame();
+}
+
+void HeadlessOverlay::receive(Serializer& serializerIn, Serializer& serializerOut)
+{
+	m_textArchives.receive(serializerIn, serializerOut);
+}
+
+void HeadlessOverlay::closed(SessionId session)
+{
+	std::lock_guard<std::mutex> l(m_closedMutex);
+	m_closed.push_back(session);
+}
+
+const Dispatcher& HeadlessOverlay::dispatcher() const
+{
+	return m_dispatcher;
+}
+
+size_t HeadlessOverlay::objects() const
+{
+	std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+	return g_objects.size();
+}
+
+uint32_t HeadlessOverlay::frames() const
+{
+	return m_uiFrames.load();
+}
+
+void HeadlessOverlay::frameLoop()
+{
+	auto interval = std::chrono::microseconds(1000000 / g_iFrameRate.load());
+	auto next = std::chrono::steady_clock::now() + interval;
+
+	std::unique_lock<std::mutex> l(m_stopMutex);
+	while (!m_cvStop.wait_until(l, next, [this]() { return m_bStop; }))
+	{
+		frame();
+		next += interval;
+	}
+}
+
+// What the game's update loop does on every frame event
+void HeadlessOverlay::frame()
+{
+	std::vector<SessionId> closed;
+	{
+		std::lock_guard<std::mutex> l(m_closedMutex);
+		closed.swap(m_closed);
+	}
+
+	std::lock_guard<std::recursive_mutex> l(g_renderMutex);
+
+	for (auto session : closed)
+	{
+		m_transactions.closed(session);
+		m_coalescer.closed(session);
+		destroyAll(session);
+	}
+
+	m_coalescer.flush();
+	m_uiFrames++;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <Utils/Coalescer.h>
+#include <Utils/Dispatcher.h>
+#include <Utils/TextArchive.h>
+#include <Utils/TransactionQueue.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// The game's request chain (text archives, transactions, coalescing, dispatch)
+// in front of handlers that keep the overlay objects in a table instead of
+// drawing them, so the server side can be served and measured without a game.
+// A frame thread stands in for the game's update loop: at the given frame rate
+// it destroys what closed sessions left behind and applies staged updates, both
+// under the render mutex. The object table is global, one instance per process.
+//
+class HeadlessOverlay
+{
+public:
+	explicit HeadlessOverlay(int frameRate);
+	// Runs a last frame, so nothing staged is lost
+	~HeadlessOverlay();
+
+	// Entry of the chain, for a listener or replaySession
+	void receive(Serializer& serializerIn, Serializer& serializerOut);
+	// The session's objects and staged updates are dropped with the next frame
+	void closed(SessionId session);
+
+	const Dispatcher& dispatcher() const;
+	size_t objects() const;
+	uint32_t frames() const;
+
+private:
+	HeadlessOverlay(const HeadlessOverlay&);
+	HeadlessOverlay& operator=(const HeadlessOverlay&);
+
+	void frameLoop();
+	void frame();
+
+	Dispatcher m_dispatcher;
+	Coalescer m_coalescer;
+	TransactionQueue m_transactions;
+	TextArchiveCodec m_textArchives;
+
+	std::mutex m_closedMutex;
+	std::vector<SessionId> m_closed;
+
+	std::mutex m_stopMutex;
+	std::condition_variable m_cvStop;
+	bool m_bStop;
+	std::atomic<uint32_t> m_uiFrames;
+	std::thread m_thread;
+};
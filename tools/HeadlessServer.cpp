@@ -0,0 +1,90 @@
+//
+// Serves the overlay over the local transport without a game: the listener
+// hands every request to the same request chain the game builds, with
+// HeadlessOverlay's object table behind the handlers. Clients such as ipc-bench
+// connect to it by name; it runs until stdin is closed or a line is entered.
+//
+#include "HeadlessOverlay.h"
+
+#include <Shared/Config.h>
+#include <Utils/SessionLog.h>
+#include <Utils/Transport.h>
+
+#include <boost/bind.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace
+{
+	void usage(const char *szProgram)
+	{
+		fprintf(stderr,
+			"usage: %s [-n name] [-f fps] [-r capture]\n"
+			"  -n  name clients connect to (%s)\n"
+			"  -f  frames per second applying staged updates (60)\n"
+			"  -r  record every request to this file, for replay-session\n", szProgram, g_strPipeName);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	std::string name = g_strPipeName;
+	std::string capture;
+	int fps = 60;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool bValid = i + 1 < argc;
+		if (bValid && strcmp(argv[i], "-n") == 0)
+			name = argv[++i];
+		else if (bValid && strcmp(argv[i], "-f") == 0)
+			bValid = (fps = atoi(argv[++i])) > 0;
+		else if (bValid && strcmp(argv[i], "-r") == 0)
+			capture = argv[++i];
+		else
+			bValid = false;
+
+		if (!bValid)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	HeadlessOverlay overlay(fps);
+
+	IListener::Callback callback = boost::bind(&HeadlessOverlay::receive, &overlay, _1, _2);
+
+	std::unique_ptr<SessionRecorder> recorder;
+	if (!capture.empty())
+	{
+		recorder.reset(new SessionRecorder(capture));
+		if (!recorder->isOpen())
+		{
+			fprintf(stderr, "couldn't open %s\n", capture.c_str());
+			return 1;
+		}
+
+		callback = recorder->wrap(callback);
+	}
+
+	auto listener = createListener(name, callback, boost::bind(&HeadlessOverlay::closed, &overlay, _1));
+
+	printf("serving %s at %d fps%s%s, enter to stop\n", name.c_str(), fps, recorder ? ", recording to " : "", capture.c_str());
+
+	std::string line;
+	std::getline(std::cin, line);
+
+	listener.reset();
+
+	auto stats = overlay.dispatcher().takeStats();
+	printf("%u frames, %zu objects left, %u requests, p50 %u us p99 %u us p999 %u us (dispatch only)\n",
+		overlay.frames(), overlay.objects(), stats.ops, stats.p50, stats.p99, stats.p999);
+
+	return 0;
+}
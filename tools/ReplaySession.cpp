@@ -0,0 +1,80 @@
+//
+// Feeds a log recorded with OVERLAY_CAPTURE (or headless-server -r) into the
+// game's request chain with HeadlessOverlay's object table behind it, so two
+// builds can be compared on the same workload without a game.
+//
+#include "HeadlessOverlay.h"
+
+#include <Utils/SessionLog.h>
+
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+	void usage(const char *szProgram)
+	{
+		fprintf(stderr,
+			"usage: %s [-x] [-f fps] log\n"
+			"  -x  as fast as possible instead of at the recorded pace\n"
+			"  -f  frames per second applying staged updates (60)\n", szProgram);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	ReplaySpeed speed = ReplaySpeed::Original;
+	int fps = 60;
+	const char *szLog = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool bValid = true;
+		if (strcmp(argv[i], "-x") == 0)
+			speed = ReplaySpeed::Fast;
+		else if (i + 1 < argc && strcmp(argv[i], "-f") == 0)
+			bValid = (fps = atoi(argv[++i])) > 0;
+		else if (argv[i][0] != '-' && !szLog)
+			szLog = argv[i];
+		else
+			bValid = false;
+
+		if (!bValid)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!szLog)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	HeadlessOverlay overlay(fps);
+
+	auto start = boost::chrono::steady_clock::now();
+	int count = replaySession(szLog, boost::bind(&HeadlessOverlay::receive, &overlay, _1, _2), speed,
+		boost::bind(&HeadlessOverlay::closed, &overlay, _1));
+	auto seconds = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+
+	if (count < 0)
+	{
+		fprintf(stderr, "%s isn't a session log\n", szLog);
+		return 1;
+	}
+
+	auto stats = overlay.dispatcher().takeStats();
+	printf("%d requests in %.3f s (%.0f/s), %u frames\n", count, seconds, seconds > 0 ? count / seconds : 0.0, overlay.frames());
+	// A GetServerStats in the log starts a new window, as it did for the recorded server
+	printf("dispatch p50 %u us p99 %u us p999 %u us over the last %u requests, %u fire-and-forget failures\n",
+		stats.p50, stats.p99, stats.p999, stats.ops, overlay.dispatcher().takeErrorCount());
+
+	return 0;
+}